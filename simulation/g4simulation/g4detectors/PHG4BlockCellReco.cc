@@ -3,6 +3,7 @@
 #include "PHG4BlockGeom.h"
 #include "PHG4BlockCellGeomContainer.h"
 #include "PHG4BlockCellGeom.h"
+#include "PHG4CellSplitter.h"
 #include "PHG4CylinderCellv1.h"
 #include "PHG4CylinderCellContainer.h"
 #include "PHG4CylinderCellDefs.h"
@@ -25,11 +26,6 @@
 
 using namespace std;
 
-#define ARRAYDIM1 100000
-#define ARRAYDIM2 2000
-
-static vector<PHG4CylinderCell*> cellptarray;
-
 PHG4BlockCellReco::PHG4BlockCellReco(const string &name) :
   SubsysReco(name),
   _timer(PHTimeServer::get()->insert_new("PHG4BlockCellReco")),
@@ -246,34 +242,17 @@ PHG4BlockCellReco::process_event(PHCompositeNode *topNode)
     PHG4BlockCellGeom *geo = seggeo->GetLayerCellGeom(*layer);
     int nxbins = n_x_z_bins[*layer].first;
     int nzbins = n_x_z_bins[*layer].second;
-    unsigned int nbins = nxbins*nzbins;
-
-    if(cellptarray.size() < nbins)
-      cellptarray.resize(nbins, 0);
-
-    if ( nxbins > ARRAYDIM1)
-    {
-      cout << "too many bins in x: " << nxbins
-           << " change and recompile" << endl;
-      exit(1);
-    }
-
-    if (nzbins > ARRAYDIM2)
-    {
-      cout << "too many bins in z: " << nzbins
-           << " change and recompile" << endl;
-      exit(1);
-    }
-
+    cellindex.clear(nxbins * nzbins);
 
     // ------- eta/x binning ------------------------------------------------------------------------
     if (binning[*layer] == PHG4CylinderCellDefs::etaphibinning)
     {
+      PHG4CellSplitter splitter(geo, PHG4CellSplitterEtaX());
       for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; hiter++)
       {
         pair<double, double> etax[2];
-        double xbin[2];
-        double etabin[2];
+        int xbin[2];
+        int etabin[2];
         for (int i = 0; i < 2; i++)
         {
           etax[i] = get_etaphi(hiter->second->get_x(i), hiter->second->get_y(i), hiter->second->get_z(i));
@@ -281,158 +260,49 @@ PHG4BlockCellReco::process_event(PHCompositeNode *topNode)
           xbin[i] = geo->get_xbin( etax[i].second );
         }
 
-        // check bin range
-        if (xbin[0] < 0 || xbin[0] >= nxbins || xbin[1] < 0 || xbin[1] >= nxbins)
-        {
-          continue;
-        }
-        if (etabin[0] < 0 || etabin[0] >= nzbins   || etabin[1] < 0 || etabin[1] >= nzbins)
-        {
-          continue;
-        }
-
-        if (etabin[0] < 0)
-        {
-          if (verbosity > 0)
-          {
-            hiter->second->identify();
-          }
-          continue;
-        }
-
-        int intxbin = xbin[0];
-        int intetabin = etabin[0];
-        int intxbinout = xbin[1];
-        int intetabinout = etabin[1];
-
-        // Determine all fired cells
-
-        double ax = (etax[0]).second; // x
-        double ay = (etax[0]).first;  // eta
-        double bx = (etax[1]).second;
-        double by = (etax[1]).first;
-        if (intxbin > intxbinout)
-        {
-          int tmp = intxbin;
-          intxbin = intxbinout;
-          intxbinout = tmp;
-        }
-
-        if (intetabin > intetabinout)
-        {
-          int tmp = intetabin;
-          intetabin = intetabinout;
-          intetabinout = tmp;
-        }
-
-        double trklen = sqrt((ax - bx) * (ax - bx) + (ay - by) * (ay - by));
-	      // if entry and exit hit are the same (seems to happen rarely), trklen = 0
-	      // which leads to a 0/0 and an NaN in edep later on
-	      // this code does for particles in the same cell a trklen/trklen (vdedx[ii]/trklen)
-	      // so setting this to any non zero number will do just fine
-	      // I just pick -1 here to flag those strange hits in case I want t oanalyze them
-	      // later on
-	      if (trklen == 0)
-        {
-          trklen = -1.;
-        }
-        vector<int> vx;
-        vector<int> veta;
-        vector<double> vdedx;
-
-        if (intxbin == intxbinout && intetabin == intetabinout)   // single cell fired
-        {
-          if (verbosity > 0) cout << "SINGLE CELL FIRED: " << intxbin << " " << intetabin << endl;
-          vx.push_back(intxbin);
-          veta.push_back(intetabin);
-          vdedx.push_back(trklen);
-        }
-        else
-        {
-          for (int ibp = intxbin; ibp <= intxbinout; ibp++)
-          {
-            for (int ibz = intetabin; ibz <= intetabinout; ibz++)
-            {
-              double cx = geo->get_xcenter(ibp) - geo->get_xstep() / 2.;
-              double dx = geo->get_xcenter(ibp) + geo->get_xstep() / 2.;
-              double cy = geo->get_etacenter(ibz) - geo->get_etastep() / 2.;
-              double dy = geo->get_etacenter(ibz) + geo->get_etastep() / 2.;
-              double rr = 0.;
-              //cout << "##### line: " << ax << " " << ay << " " << bx << " " << by << endl;
-              //cout << "####### cell: " << cx << " " << cy << " " << dx << " " << dy << endl;
-              bool yesno = line_and_rectangle_intersect(ax, ay, bx, by, cx, cy, dx, dy, &rr);
-              if (yesno)
-              {
-                if (verbosity > 0) cout << "CELL FIRED: " << ibp << " " << ibz << " " << rr << endl;
-                vx.push_back(ibp);
-                veta.push_back(ibz);
-                vdedx.push_back(rr);
-              }
-            }
-          }
-        }
-        if (verbosity > 0) cout << "NUMBER OF FIRED CELLS = " << vx.size() << endl;
-
-        double tmpsum = 0.;
-        for (unsigned int ii = 0; ii < vx.size(); ii++)
-        {
-          tmpsum += vdedx[ii];
-          vdedx[ii] = vdedx[ii] / trklen;
-          if (verbosity > 0) cout << "  CELL " << ii << "  dE/dX = " <<  vdedx[ii] << endl;
-        }
-        if (verbosity > 0) cout << "    TOTAL TRACK LENGTH = " << tmpsum << " " << trklen << endl;
-
+        // Determine all fired cells, nothing if a bin is out of range
+        unsigned int ncells = splitter.Split(etax[0].second, etax[0].first, xbin[0], etabin[0],
+                                             etax[1].second, etax[1].first, xbin[1], etabin[1]);
+        if (verbosity > 0) cout << "NUMBER OF FIRED CELLS = " << ncells << endl;
 
-        for (unsigned int i1 = 0; i1 < vx.size(); i1++)   // loop over all fired cells
+        for (unsigned int i1 = 0; i1 < ncells; i1++)   // loop over all fired cells
         {
+          int ixbin = splitter.get_xbin(i1);
+          int ietabin = splitter.get_ybin(i1);
+          double fraction = splitter.get_fraction(i1);
+          if (verbosity > 0) cout << "  CELL " << ixbin << " " << ietabin << "  dE/dX = " << fraction << endl;
+          PHG4CylinderCell *&cell = cellindex[ixbin*nzbins+ietabin];
 
-          int ixbin = vx[i1];
-          int ietabin = veta[i1];
-          int ibin = ixbin*nzbins+ietabin;
-
-          if (!cellptarray[ibin])
+          if (!cell)
           {
-            cellptarray[ibin] = new PHG4CylinderCellv1();
-            cellptarray[ibin]->set_layer(*layer);
-            cellptarray[ibin]->set_phibin(ixbin);
-            cellptarray[ibin]->set_etabin(ietabin);
+            cell = new PHG4CylinderCellv1();
+            cell->set_layer(*layer);
+            cell->set_phibin(ixbin);
+            cell->set_etabin(ietabin);
           }
-          cellptarray[ibin]->add_edep(hiter->first, hiter->second->get_edep()*vdedx[i1], hiter->second->get_light_yield()*vdedx[i1]);
+          cell->add_edep(hiter->first, hiter->second->get_edep()*fraction, hiter->second->get_light_yield()*fraction);
           // just a sanity check - we don't want to mess up by having Nan's or Infs in our energy deposition
-          if (! isfinite(hiter->second->get_edep()*vdedx[i1]))
+          if (! isfinite(hiter->second->get_edep()*fraction))
           {
             cout << PHWHERE << " invalid energy dep " << hiter->second->get_edep()
-                 << " or path length: " << vdedx[i1] << endl;
+                 << " or path length: " << fraction << endl;
           }
         }
-
-        vx.clear();
-        veta.clear();
       } // end loop over g4hits
 
       int numcells = 0;
-      for (int ix = 0; ix < nxbins; ix++)
+      for (PHG4CylinderCellIndex::ConstIterator iter = cellindex.begin(); iter != cellindex.end(); ++iter)
       {
-        for (int iz = 0; iz < nzbins; iz++)
+        cells->AddCylinderCell(*layer, iter->second);
+        numcells++;
+        if (verbosity > 1)
         {
-          int ibin = ix*nzbins + iz;
-
-          if (cellptarray[ibin])
-          {
-            cells->AddCylinderCell(*layer, cellptarray[ibin]);
-            numcells++;
-            if (verbosity > 1)
-            {
-              cout << "Adding cell in bin x: " << ix
-                   << " x: " << geo->get_xcenter(ix) * 180./M_PI
-                   << ", eta bin: " << iz
-                   << ", eta: " <<  geo->get_etacenter(iz)
-                   << ", energy dep: " << cellptarray[ibin]->get_edep()
-                   << endl;
-            }
-
-            cellptarray[ibin] = 0;
-          }
+          cout << "Adding cell in bin x: " << iter->second->get_binphi()
+               << " x: " << geo->get_xcenter(iter->second->get_binphi()) * 180./M_PI
+               << ", eta bin: " << iter->second->get_bineta()
+               << ", eta: " <<  geo->get_etacenter(iter->second->get_bineta())
+               << ", energy dep: " << iter->second->get_edep()
+               << endl;
         }
       }
 
@@ -511,163 +381,6 @@ PHG4BlockCellReco::get_eta(const double radius, const double z)
   return eta;
 }
 
-//---------------------------------------------------------------
-
-bool PHG4BlockCellReco::lines_intersect( double ax,
-                                         double ay,
-                                         double bx,
-                                         double by,
-                                         double cx,
-                                         double cy,
-                                         double dx,
-                                         double dy,
-                                         double* rx, // intersection point (output)
-                                         double* ry
-                                         )
-{
-
-  // Find if a line segment limited by points A and B
-  // intersects line segment limited by points C and D.
-  // First check if an infinite line defined by A and B intersects
-  // segment (C,D). If h is from 0 to 1 line and line segment intersect
-  // Then check in intersection point is between C and D
-
-  double ex = bx - ax; // E=B-A
-  double ey = by - ay;
-  double fx = dx - cx; // F=D-C
-  double fy = dy - cy;
-  double px = -ey;     // P
-  double py = ex;
-
-  double bottom = fx * px + fy * py; // F*P
-  double gx = ax - cx; // A-C
-  double gy = ay - cy;
-  double top = gx * px + gy * py; // G*P
-
-  double h = 99999.;
-  if (bottom != 0.)
-  {
-    h = top / bottom;
-  }
-
-  //intersection point R = C + F*h
-  if (h > 0. && h < 1.)
-  {
-    *rx = cx + fx * h;
-    *ry = cy + fy * h;
-    //cout << "      line/segment intersection coordinates: " << *rx << " " << *ry << endl;
-    if ((*rx > ax && *rx > bx) || (*rx < ax && *rx < bx) || (*ry < ay && *ry < by) || (*ry > ay && *ry > by))
-    {
-      //cout << "       NO segment/segment intersection!" << endl;
-      return false;
-    }
-    else
-    {
-      //cout << "       segment/segment intersection!" << endl;
-      return true;
-    }
-  }
-
-  return false;
-}
-
-//---------------------------------------------------------------
-
-bool  PHG4BlockCellReco::line_and_rectangle_intersect( double ax,
-                                                       double ay,
-                                                       double bx,
-                                                       double by,
-                                                       double cx,
-                                                       double cy,
-                                                       double dx,
-                                                       double dy,
-                                                       double* rr // length of the line segment inside the rectangle (output)
-                                                       )
-{
-
-  // find if a line isegment limited by points (A,B)
-  // intersects with a rectangle defined by two
-  // corner points (C,D) two other points are E and F
-  //   E--------D
-  //   |        |
-  //   |        |
-  //   C--------F
-
-  if (cx > dx || cy > dy)
-  {
-    cerr << "ERROR: Bad rectangle definition!" << endl;
-    return false;
-  }
-
-  double ex = cx;
-  double ey = dy;
-  double fx = dx;
-  double fy = cy;
-  double rx = 99999.;
-  double ry = 99999.;
-
-  vector<double> vx;
-  vector<double> vy;
-
-  bool i1 = lines_intersect(ax, ay, bx, by, cx, cy, fx, fy, &rx, &ry);
-  if (i1)
-  {
-    vx.push_back(rx);
-    vy.push_back(ry);
-  }
-  bool i2 = lines_intersect(ax, ay, bx, by, fx, fy, dx, dy, &rx, &ry);
-  if (i2)
-  {
-    vx.push_back(rx);
-    vy.push_back(ry);
-  }
-  bool i3 = lines_intersect(ax, ay, bx, by, ex, ey, dx, dy, &rx, &ry);
-  if (i3)
-  {
-    vx.push_back(rx);
-    vy.push_back(ry);
-  }
-  bool i4 = lines_intersect(ax, ay, bx, by, cx, cy, ex, ey, &rx, &ry);
-  if (i4)
-  {
-    vx.push_back(rx);
-    vy.push_back(ry);
-  }
-
-  //cout << "Rectangle intersections: " << i1 << " " << i2 << " " << i3 << " " << i4 << endl;
-  //cout << "Number of intersections = " << vx.size() << endl;
-
-  *rr = 0.;
-  if (vx.size() == 2)
-  {
-    *rr = sqrt( (vx[0] - vx[1]) * (vx[0] - vx[1]) + (vy[0] - vy[1]) * (vy[0] - vy[1]) );
-    //  cout << "Length of intersection = " << *rr << endl;
-  }
-
-  if (vx.size() == 1)
-  {
-    // find which point (A or B) is within the rectangle
-    if (ax > cx && ay > cy && ax < dx && ay < dy)   // point A is inside the rectangle
-    {
-      //cout << "Point A is inside the rectangle." << endl;
-      *rr = sqrt((vx[0] - ax) * (vx[0] - ax) + (vy[0] - ay) * (vy[0] - ay));
-    }
-    if (bx > cx && by > cy && bx < dx && by < dy)   // point B is inside the rectangle
-    {
-      //cout << "Point B is inside the rectangle." << endl;
-      *rr = sqrt((vx[0] - bx) * (vx[0] - bx) + (vy[0] - by) * (vy[0] - by));
-    }
-  }
-
-  if (i1 || i2 || i3 || i4)
-  {
-    return true;
-  }
-
-  return false;
-}
-
-
 int
 PHG4BlockCellReco::CheckEnergy(PHCompositeNode *topNode)
 {
@@ -1,6 +1,8 @@
 #ifndef PHG4BLOCKCELLRECO_H
 #define PHG4BLOCKCELLRECO_H
 
+#include "PHG4CylinderCellIndex.h"
+
 #include <fun4all/SubsysReco.h>
 #include <phool/PHTimeServer.h>
 #include <string>
@@ -39,8 +41,6 @@ class PHG4BlockCellReco : public SubsysReco
   int CheckEnergy(PHCompositeNode *topNode);
   static std::pair<double, double> get_etaphi(const double x, const double y, const double z);
   static double get_eta(const double radius, const double z);
-  bool lines_intersect( double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy, double* rx, double* ry);
-  bool line_and_rectangle_intersect( double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy, double* rr);
 
   std::map<int, int>  binning;
   std::map<int, std::pair <double,double> > cell_size; // cell size in x/z
@@ -53,6 +53,7 @@ class PHG4BlockCellReco : public SubsysReco
   std::string geonodename;
   std::string seggeonodename;
   std::map<int, std::pair<int, int> > n_x_z_bins;
+  PHG4CylinderCellIndex cellindex; // the hit cells of the current layer by xbin * nzbins + etabin
   PHTimeServer::timer _timer;
   int nbins[2];
   int chkenergyconservation;
@@ -3,7 +3,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 
 #include <g4main/PHG4TrackUserInfoV1.h>
 
@@ -71,11 +71,11 @@ bool PHG4BlockSteppingAction::UserSteppingAction( const G4Step* aStep, bool )
 	{
 	  if (use_ionisation_energy)
 	    {
-	      hit = new PHG4Hitv1();
+	      hit = new PHG4Hitv2();
 	    }
 	  else
 	    {
-	      hit = new PHG4Hitv1();
+	      hit = new PHG4Hitv2();
 	    }
 	  //here we set the entrance values in cm
 	  hit->set_x( 0, prePoint->GetPosition().x() / cm);
@@ -109,7 +109,7 @@ bool PHG4BlockSteppingAction::UserSteppingAction( const G4Step* aStep, bool )
             {
             case fGeomBoundary:
             case fUndefined:
-		  hit = new PHG4Hitv1();
+		  hit = new PHG4Hitv2();
 	      //here we set the entrance values in cm
 	      hit->set_x( 0, prePoint->GetPosition().x() / cm);
 	      hit->set_y( 0, prePoint->GetPosition().y() / cm );
@@ -204,3 +204,9 @@ void PHG4BlockSteppingAction::SetInterfacePointers( PHCompositeNode* topNode )
     { std::cout << "PHG4BlockSteppingAction::SetTopNode - unable to find " << hitnodename << std::endl; }
 
 }
+
+//____________________________________________________________________________..
+int PHG4BlockSteppingAction::HandlesVolume( G4VPhysicalVolume *volume )
+{
+  return (detector_->IsInBlock(volume)) ? 1 : 0;
+}
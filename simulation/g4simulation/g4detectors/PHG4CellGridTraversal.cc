@@ -0,0 +1,77 @@
+#include "PHG4CellGridTraversal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+unsigned int
+PHG4CellGridTraversal::Traverse(const double ax, const double ay, const double bx, const double by,
+				const double xmin, const double xstep, const double ymin, const double ystep,
+				const int axbin, const int aybin, const int bxbin, const int bybin,
+				vector<int> &xbins, vector<int> &ybins, vector<double> &lengths)
+{
+  const double dx = bx - ax;
+  const double dy = by - ay;
+  const double length = sqrt(dx * dx + dy * dy);
+  const int xdir = (bxbin > axbin) ? 1 : -1;
+  const int ydir = (bybin > aybin) ? 1 : -1;
+  int nxsteps = abs(bxbin - axbin);
+  int nysteps = abs(bybin - aybin);
+
+  // parameter t (0 at A, 1 at B) where the segment crosses the next x/y edge
+  double txnext = 2.;
+  double txdelta = 0.;
+  if (nxsteps > 0 && dx != 0.)
+    {
+      txnext = (xmin + (axbin + ((xdir > 0) ? 1 : 0)) * xstep - ax) / dx;
+      txdelta = xstep / fabs(dx);
+    }
+  double tynext = 2.;
+  double tydelta = 0.;
+  if (nysteps > 0 && dy != 0.)
+    {
+      tynext = (ymin + (aybin + ((ydir > 0) ? 1 : 0)) * ystep - ay) / dy;
+      tydelta = ystep / fabs(dy);
+    }
+
+  unsigned int ncells = 0;
+  int ix = axbin;
+  int iy = aybin;
+  double t = 0.;
+  // the number of steps is fixed by the bins of A and B, rounding cannot make the walk miss B
+  while (nxsteps > 0 || nysteps > 0)
+    {
+      const bool step_in_x = (nxsteps > 0 && (nysteps == 0 || txnext <= tynext));
+      const double tnext = min(max(step_in_x ? txnext : tynext, t), 1.);
+      if (tnext > t)
+	{
+	  xbins.push_back(ix);
+	  ybins.push_back(iy);
+	  lengths.push_back((tnext - t) * length);
+	  ncells++;
+	}
+      t = tnext;
+      if (step_in_x)
+	{
+	  ix += xdir;
+	  txnext += txdelta;
+	  nxsteps--;
+	}
+      else
+	{
+	  iy += ydir;
+	  tynext += tydelta;
+	  nysteps--;
+	}
+    }
+  if (t < 1. || ncells == 0)
+    {
+      xbins.push_back(ix);
+      ybins.push_back(iy);
+      lengths.push_back((1. - t) * length);
+      ncells++;
+    }
+  return ncells;
+}
@@ -0,0 +1,28 @@
+#ifndef PHG4CELLGRIDTRAVERSAL_H
+#define PHG4CELLGRIDTRAVERSAL_H
+
+#include <vector>
+
+//! cells of a uniform 2d grid crossed by a straight segment
+/*!
+  Walks the segment A-B cell by cell through the grid (DDA): at every
+  step the segment leaves the current cell through the nearer of its x
+  or y edge, so the crossed cells and the length of the segment inside
+  each of them come out in one pass, ordered from A to B. Cell (i,j)
+  covers [xmin + i*xstep, xmin + (i+1)*xstep] x [ymin + j*ystep, ymin + (j+1)*ystep].
+  The bins of A and B are given by the caller (as found by the cell
+  geometry), the walk goes from the first to the second and the lengths
+  add up to |AB|. Cells which are only touched in a corner are skipped.
+*/
+class PHG4CellGridTraversal
+{
+ public:
+
+  //! appends the crossed cells and path lengths to xbins, ybins and lengths, returns the number of cells
+  static unsigned int Traverse(const double ax, const double ay, const double bx, const double by,
+			       const double xmin, const double xstep, const double ymin, const double ystep,
+			       const int axbin, const int aybin, const int bxbin, const int bybin,
+			       std::vector<int> &xbins, std::vector<int> &ybins, std::vector<double> &lengths);
+};
+
+#endif
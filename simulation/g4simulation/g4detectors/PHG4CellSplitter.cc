@@ -0,0 +1,38 @@
+#include "PHG4CellSplitter.h"
+#include "PHG4CellGridTraversal.h"
+
+#include <cmath>
+
+using namespace std;
+
+unsigned int
+PHG4CellSplitter::Split(const double ax, const double ay, const int axbin, const int aybin,
+			const double bx, const double by, const int bxbin, const int bybin)
+{
+  xbins.clear();
+  ybins.clear();
+  fractions.clear();
+  if (axbin < 0 || axbin >= nxbins || bxbin < 0 || bxbin >= nxbins ||
+      aybin < 0 || aybin >= nybins || bybin < 0 || bybin >= nybins)
+    {
+      return 0;
+    }
+
+  if (axbin == bxbin && aybin == bybin)
+    {
+      xbins.push_back(axbin);
+      ybins.push_back(aybin);
+      fractions.push_back(1.);
+      return 1;
+    }
+
+  PHG4CellGridTraversal::Traverse(ax, ay, bx, by, xmin, xstep, ymin, ystep,
+				  axbin, aybin, bxbin, bybin, xbins, ybins, fractions);
+  // A and B are in different cells, the length cannot be zero
+  const double norm = 1. / sqrt((bx - ax) * (bx - ax) + (by - ay) * (by - ay));
+  for (vector<double>::iterator iter = fractions.begin(); iter != fractions.end(); ++iter)
+    {
+      *iter *= norm;
+    }
+  return fractions.size();
+}
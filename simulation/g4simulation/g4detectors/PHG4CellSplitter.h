@@ -0,0 +1,103 @@
+#ifndef PHG4CELLSPLITTER_H
+#define PHG4CELLSPLITTER_H
+
+#include "PHG4BlockCellGeom.h"
+#include "PHG4CylinderCellGeom.h"
+
+#include <vector>
+
+// binnings of the cell geometries as uniform (x, y) grids: grid() reads
+// the cell boundaries of a layer from its cell geometry. The binning is
+// picked once when the PHG4CellSplitter of a layer is created, the
+// splitting itself does not depend on it.
+
+//! phi/eta cells of a cylinder layer (eta/phi and eta/slat binning, projective)
+struct PHG4CellSplitterEtaPhi
+{
+  typedef PHG4CylinderCellGeom geometry;
+  static void grid(const geometry *geo, double &xmin, double &xstep, int &nxbins, double &ymin, double &ystep, int &nybins)
+  {
+    xmin = geo->get_phimin();
+    xstep = geo->get_phistep();
+    nxbins = geo->get_phibins();
+    ymin = geo->get_etamin();
+    ystep = geo->get_etastep();
+    nybins = geo->get_etabins();
+  }
+};
+
+//! phi/z cells of a cylinder layer (size binning, planar)
+struct PHG4CellSplitterZPhi
+{
+  typedef PHG4CylinderCellGeom geometry;
+  static void grid(const geometry *geo, double &xmin, double &xstep, int &nxbins, double &ymin, double &ystep, int &nybins)
+  {
+    xmin = geo->get_phimin();
+    xstep = geo->get_phistep();
+    nxbins = geo->get_phibins();
+    ymin = geo->get_zmin();
+    ystep = geo->get_zstep();
+    nybins = geo->get_zbins();
+  }
+};
+
+//! x/eta cells of a block layer
+struct PHG4CellSplitterEtaX
+{
+  typedef PHG4BlockCellGeom geometry;
+  static void grid(const geometry *geo, double &xmin, double &xstep, int &nxbins, double &ymin, double &ystep, int &nybins)
+  {
+    xmin = geo->get_xmin();
+    xstep = geo->get_xstep();
+    nxbins = geo->get_xbins();
+    ymin = geo->get_etamin();
+    ystep = geo->get_etastep();
+    nybins = geo->get_etabins();
+  }
+};
+
+//! splits hit segments into the cells of one layer by path length
+/*!
+  Shared by the cell recos which distribute the energy of a hit over
+  the cells its segment crosses. The segment from the entry point A to
+  the exit point B (in the cell coordinates, with the bins the cell
+  geometry found for them) is walked through the grid with
+  PHG4CellGridTraversal, each crossed cell gets the fraction of the
+  segment length inside it. A segment within one cell gets fraction 1,
+  also for zero length segments.
+*/
+class PHG4CellSplitter
+{
+ public:
+
+  template <class Binning>
+  PHG4CellSplitter(const typename Binning::geometry *geo, const Binning &)
+  {
+    Binning::grid(geo, xmin, xstep, nxbins, ymin, ystep, nybins);
+  }
+
+  //! splits segment A-B, returns the number of cells (0 if A or B is outside the grid)
+  unsigned int Split(const double ax, const double ay, const int axbin, const int aybin,
+		     const double bx, const double by, const int bxbin, const int bybin);
+
+  //! cells and fractions of the last Split()
+  unsigned int size() const {return xbins.size();}
+  int get_xbin(const unsigned int i) const {return xbins[i];}
+  int get_ybin(const unsigned int i) const {return ybins[i];}
+  double get_fraction(const unsigned int i) const {return fractions[i];}
+
+ protected:
+
+  double xmin;
+  double xstep;
+  int nxbins;
+  double ymin;
+  double ystep;
+  int nybins;
+
+  std::vector<int> xbins;
+  std::vector<int> ybins;
+  std::vector<double> fractions;
+};
+
+#endif
@@ -3,7 +3,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 
 #include <g4main/PHG4TrackUserInfoV1.h>
 
@@ -53,7 +53,7 @@ bool PHG4ConeSteppingAction::UserSteppingAction( const G4Step* aStep, bool )
         {
         case fGeomBoundary:
         case fUndefined:
-          hit = new PHG4Hitv1();
+          hit = new PHG4Hitv2();
           //here we set the entrance values in cm
           hit->set_x( 0, prePoint->GetPosition().x() / cm);
           hit->set_y( 0, prePoint->GetPosition().y() / cm );
@@ -141,3 +141,9 @@ void PHG4ConeSteppingAction::SetInterfacePointers( PHCompositeNode* topNode )
     { std::cout << "PHG4ConeSteppingAction::SetTopNode - unable to find " << hitnodename << std::endl; }
 
 }
+
+//____________________________________________________________________________..
+int PHG4ConeSteppingAction::HandlesVolume( G4VPhysicalVolume *volume )
+{
+  return (detector_->IsInConeActive(volume)) ? 1 : 0;
+}
@@ -3,7 +3,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 
 #include <g4main/PHG4TrackUserInfoV1.h>
 
@@ -122,7 +122,7 @@ bool PHG4CrystalCalorimeterSteppingAction::UserSteppingAction( const G4Step* aSt
 	{
 	case fGeomBoundary:
 	case fUndefined:
-	  hit = new PHG4Hitv1();
+	  hit = new PHG4Hitv2();
 //	  hit->set_layer(0);
 	  hit->set_scint_id(tower_id);
 
@@ -328,3 +328,9 @@ PHG4CrystalCalorimeterSteppingAction::ParseG4VolumeName( G4VPhysicalVolume* volu
 
 	return 0;
 }
+
+//____________________________________________________________________________..
+int PHG4CrystalCalorimeterSteppingAction::HandlesVolume( G4VPhysicalVolume *volume )
+{
+  return (detector_->IsInCrystalCalorimeter(volume) != 0) ? 1 : 0;
+}
@@ -15,6 +15,9 @@ class PHG4CylinderCell : public PHObject
   typedef EdepMap::const_iterator EdepConstIterator;
   typedef std::pair<EdepIterator, EdepIterator> EdepRange;
   typedef std::pair<EdepConstIterator, EdepConstIterator> EdepConstRange;
+  typedef std::map<int, float> TrackEdepMap;
+  typedef TrackEdepMap::const_iterator TrackEdepConstIterator;
+  typedef std::pair<TrackEdepConstIterator, TrackEdepConstIterator> TrackEdepConstRange;
 
   virtual ~PHG4CylinderCell(){}
 
@@ -30,6 +33,13 @@ class PHG4CylinderCell : public PHObject
   virtual void add_edep(const PHG4HitDefs::keytype g4hitid, const float edep) {return;}
   virtual void add_edep(const PHG4HitDefs::keytype g4hitid, const float edep, const float light_yield) {return;}
 
+  //! energy per G4 track id of cells built without G4 hits (direct SPACAL cells)
+  virtual TrackEdepConstRange get_g4tracks() const {
+    static const TrackEdepMap dummy;
+    return std::make_pair(dummy.begin(), dummy.end());
+  }
+  virtual void add_track_edep(const int trkid, const float edep) {return;}
+
   virtual void set_cell_id(const PHG4CylinderCellDefs::keytype id) {return;}
   virtual void set_layer(const unsigned int i) {return;}
 
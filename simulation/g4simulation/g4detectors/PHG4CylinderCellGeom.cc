@@ -9,6 +9,21 @@ ClassImp(PHG4CylinderCellGeom)
 
 using namespace std;
 
+namespace
+{
+  // bins of a uniform binning, -1 outside [xmin, xmin + nbins*step] (and for NaN)
+  void
+  uniform_bins(const unsigned int n, const double *x, int *bins, const double xmin, const double step, const int nbins)
+  {
+    const double inv_step = 1. / step;
+    const double xmax = xmin + nbins * step;
+    for (unsigned int i = 0; i < n; i++)
+      {
+        bins[i] = (x[i] >= xmin && x[i] <= xmax) ? (int) ((x[i] - xmin) * inv_step) : -1;
+      }
+  }
+}
+
 PHG4CylinderCellGeom::PHG4CylinderCellGeom():
   layer(-9999),
   binning(0),
@@ -269,6 +284,69 @@ PHG4CylinderCellGeom::get_phibin(const double phi) const
   return floor( (norm_phi-phimin)/phistep );
 }
 
+void
+PHG4CylinderCellGeom::find_zbins(const unsigned int n, const double *z, int *bins) const
+{
+  check_binning_method(PHG4CylinderCellDefs::sizebinning);
+  uniform_bins(n, z, bins, zmin, zstep, nzbins);
+}
+
+void
+PHG4CylinderCellGeom::find_etabins(const unsigned int n, const double *eta, int *bins) const
+{
+  check_binning_method_eta();
+  uniform_bins(n, eta, bins, zmin, zstep, nzbins);
+}
+
+void
+PHG4CylinderCellGeom::find_phibins(const unsigned int n, const double *phi, int *bins) const
+{
+  check_binning_method_phi();
+  const double inv_step = 1. / phistep;
+  const double phimax = phimin + nphibins * phistep;
+  for (unsigned int i = 0; i < n; i++)
+    {
+      double norm_phi = phi[i];
+      if (norm_phi < phimin || norm_phi > phimax)
+        {
+          norm_phi -= 2 * M_PI * floor((norm_phi - phimin) * 0.5 / M_PI);
+        }
+      bins[i] = floor((norm_phi - phimin) * inv_step);
+    }
+}
+
+void
+PHG4CylinderCellGeom::find_bins(const unsigned int n, const double *x, const double *y, const double *z,
+                                double *phi, double *zeta, int *phibins, int *zetabins) const
+{
+  if (binning == PHG4CylinderCellDefs::sizebinning)
+    {
+      for (unsigned int i = 0; i < n; i++)
+        {
+          zeta[i] = z[i];
+        }
+      find_zbins(n, zeta, zetabins);
+    }
+  else
+    {
+      // same as -log(tan(theta/2)) with one transcendental call instead of three
+      for (unsigned int i = 0; i < n; i++)
+        {
+          zeta[i] = asinh(z[i] / sqrt(x[i] * x[i] + y[i] * y[i]));
+        }
+      find_etabins(n, zeta, zetabins);
+    }
+  if (phi && phibins)
+    {
+      for (unsigned int i = 0; i < n; i++)
+        {
+          phi[i] = atan2(y[i], x[i]);
+        }
+      find_phibins(n, phi, phibins);
+    }
+  return;
+}
+
 double
 PHG4CylinderCellGeom::get_zcenter(const int ibin) const
 {
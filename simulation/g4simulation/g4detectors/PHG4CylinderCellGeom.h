@@ -39,6 +39,14 @@ class PHG4CylinderCellGeom: public PHObject
   virtual int get_zbin(const double z) const;
   virtual int get_phibin(const double phi) const;
 
+  //! bins of n values at once, same as the single value versions (-1 outside the z/eta range)
+  virtual void find_etabins(const unsigned int n, const double *eta, int *bins) const;
+  virtual void find_zbins(const unsigned int n, const double *z, int *bins) const;
+  void find_phibins(const unsigned int n, const double *phi, int *bins) const;
+  //! phi and eta (eta binnings) or z (size binning) of n points and their bins, phi and phibins can be NULL
+  void find_bins(const unsigned int n, const double *x, const double *y, const double *z,
+                 double *phi, double *zeta, int *phibins, int *zetabins) const;
+
    void set_layer(const int i) {layer = i;}
    void set_binning(const int i) {binning = i;}
    void set_radius(const double r) {radius = r;}
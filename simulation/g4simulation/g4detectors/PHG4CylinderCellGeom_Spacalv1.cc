@@ -159,6 +159,20 @@ PHG4CylinderCellGeom_Spacalv1::get_etabin(const double eta) const
   return -1;
 }
 
+void
+PHG4CylinderCellGeom_Spacalv1::find_zbins(const unsigned int n, const double *z, int *bins) const
+{
+  cout << "PHG4CylinderCellGeom_Spacalv1::find_zbins is invalid" << endl;
+  exit(1);
+}
+
+void
+PHG4CylinderCellGeom_Spacalv1::find_etabins(const unsigned int n, const double *eta, int *bins) const
+{
+  cout << "PHG4CylinderCellGeom_Spacalv1::find_etabins is invalid" << endl;
+  exit(1);
+}
+
 double
 PHG4CylinderCellGeom_Spacalv1::get_zcenter(const int ibin) const
 {
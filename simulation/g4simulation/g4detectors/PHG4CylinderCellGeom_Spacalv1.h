@@ -40,6 +40,10 @@ public:
   get_etabin(const double eta) const;
   virtual int
   get_zbin(const double z) const;
+  virtual void
+  find_etabins(const unsigned int n, const double *eta, int *bins) const;
+  virtual void
+  find_zbins(const unsigned int n, const double *z, int *bins) const;
 
   void
   set_zbounds(const int ibin, const std::pair<double, double> & bounds);
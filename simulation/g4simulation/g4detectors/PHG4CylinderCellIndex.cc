@@ -0,0 +1,128 @@
+#include "PHG4CylinderCellIndex.h"
+
+using namespace std;
+
+PHG4CylinderCellIndex::PHG4CylinderCellIndex():
+  dense(false),
+  hash_bits(0)
+{
+  rehash(1 << 10);
+}
+
+void
+PHG4CylinderCellIndex::clear(const keytype nkeys)
+{
+  if (dense)
+    {
+      for (ConstIterator iter = entries.begin(); iter != entries.end(); ++iter)
+	{
+	  dense_index[iter->first] = 0;
+	}
+    }
+  else
+    {
+      for (vector<unsigned int>::const_iterator iter = entry_slot.begin(); iter != entry_slot.end(); ++iter)
+	{
+	  hash_index[*iter] = 0;
+	}
+    }
+  entries.clear();
+  entry_slot.clear();
+  dense = (nkeys > 0 && nkeys <= max_dense);
+  if (dense && dense_index.size() < nkeys)
+    {
+      dense_index.resize(nkeys, 0);
+    }
+  return;
+}
+
+unsigned int
+PHG4CylinderCellIndex::hash_slot(const keytype key) const
+{
+  // fibonacci hashing, the packed bins are far from random
+  return static_cast<unsigned int>((key * 0x9E3779B97F4A7C15ULL) >> (64 - hash_bits));
+}
+
+void
+PHG4CylinderCellIndex::rehash(const unsigned int size)
+{
+  hash_bits = 0;
+  while ((1U << hash_bits) < size)
+    {
+      hash_bits++;
+    }
+  hash_index.assign(1U << hash_bits, 0);
+  entry_slot.clear();
+  const unsigned int mask = (1U << hash_bits) - 1;
+  for (unsigned int i = 0; i < entries.size(); i++)
+    {
+      unsigned int slot = hash_slot(entries[i].first);
+      while (hash_index[slot])
+	{
+	  slot = (slot + 1) & mask;
+	}
+      hash_index[slot] = i + 1;
+      entry_slot.push_back(slot);
+    }
+  return;
+}
+
+PHG4CylinderCell *&
+PHG4CylinderCellIndex::operator[](const keytype key)
+{
+  if (dense)
+    {
+      unsigned int &index = dense_index[key];
+      if (!index)
+	{
+	  entries.push_back(make_pair(key, static_cast<PHG4CylinderCell *>(0)));
+	  index = entries.size();
+	}
+      return entries[index - 1].second;
+    }
+  // keep the load below 1/2
+  if (2 * (entries.size() + 1) > hash_index.size())
+    {
+      rehash(2 * hash_index.size());
+    }
+  const unsigned int mask = hash_index.size() - 1;
+  unsigned int slot = hash_slot(key);
+  while (hash_index[slot])
+    {
+      Entry &entry = entries[hash_index[slot] - 1];
+      if (entry.first == key)
+	{
+	  return entry.second;
+	}
+      slot = (slot + 1) & mask;
+    }
+  entries.push_back(make_pair(key, static_cast<PHG4CylinderCell *>(0)));
+  hash_index[slot] = entries.size();
+  entry_slot.push_back(slot);
+  return entries.back().second;
+}
+
+PHG4CylinderCell *
+PHG4CylinderCellIndex::find(const keytype key) const
+{
+  if (dense)
+    {
+      if (key >= dense_index.size() || !dense_index[key])
+	{
+	  return 0;
+	}
+      return entries[dense_index[key] - 1].second;
+    }
+  const unsigned int mask = hash_index.size() - 1;
+  unsigned int slot = hash_slot(key);
+  while (hash_index[slot])
+    {
+      const Entry &entry = entries[hash_index[slot] - 1];
+      if (entry.first == key)
+	{
+	  return entry.second;
+	}
+      slot = (slot + 1) & mask;
+    }
+  return 0;
+}
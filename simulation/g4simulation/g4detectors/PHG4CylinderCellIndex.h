@@ -0,0 +1,71 @@
+#ifndef PHG4CylinderCellIndex_H
+#define PHG4CylinderCellIndex_H
+
+#include <utility>
+#include <vector>
+
+class PHG4CylinderCell;
+
+//! finds the cell of a packed bin id among the cells fired in one layer
+/*!
+  Replaces the std::map<std::string, PHG4CylinderCell*> lookups of the cell
+  reco modules. The bins of a cell are packed into one integer key (see
+  the key() helpers). If the keys of the layer are known to be below
+  nkeys (e.g. phibin * nzbins + zbin) a flat array is used, otherwise an
+  open addressing hash. Both remember the fired cells, so clearing costs
+  only the number of fired cells and the memory is reused for the next
+  layer/event. The cells are not owned, they are handed to the cell
+  container.
+*/
+class PHG4CylinderCellIndex
+{
+ public:
+
+  typedef unsigned long long keytype;
+  typedef std::pair<keytype, PHG4CylinderCell *> Entry;
+  typedef std::vector<Entry>::const_iterator ConstIterator;
+
+  PHG4CylinderCellIndex();
+  virtual ~PHG4CylinderCellIndex() {}
+
+  //! forget the cells, next layer has keys below nkeys (0: unknown, use the hash)
+  void clear(const keytype nkeys = 0);
+
+  //! the cell slot of this key, a new slot holds NULL for the caller to fill
+  /*! the reference is valid until the next insertion */
+  PHG4CylinderCell *&operator[](const keytype key);
+
+  //! cell of this key, NULL if not fired
+  PHG4CylinderCell *find(const keytype key) const;
+
+  //! fired cells in the order they were created
+  ConstIterator begin() const {return entries.begin();}
+  ConstIterator end() const {return entries.end();}
+  unsigned int size() const {return entries.size();}
+
+  static keytype key(const unsigned int a, const unsigned int b)
+  {return (static_cast<keytype>(a) << 32) | b;}
+  //! four indices of up to 16 bit each
+  static keytype key(const unsigned int a, const unsigned int b, const unsigned int c, const unsigned int d)
+  {return (static_cast<keytype>(a & 0xFFFF) << 48) | (static_cast<keytype>(b & 0xFFFF) << 32) | ((c & 0xFFFF) << 16) | (d & 0xFFFF);}
+
+  //! largest layer (number of keys) handled by the flat array
+  static const keytype max_dense = 1 << 22;
+
+ protected:
+
+  unsigned int hash_slot(const keytype key) const;
+  void rehash(const unsigned int size);
+
+  std::vector<Entry> entries;
+  // flat array: entry index + 1 by key, 0 is empty
+  bool dense;
+  std::vector<unsigned int> dense_index;
+  // hash: power of 2 size, linear probing, entry index + 1 per slot
+  std::vector<unsigned int> hash_index;
+  std::vector<unsigned int> entry_slot;
+  unsigned int hash_bits;
+
+};
+
+#endif
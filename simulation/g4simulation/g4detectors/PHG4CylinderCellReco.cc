@@ -3,6 +3,7 @@
 #include "PHG4CylinderGeom.h"
 #include "PHG4CylinderCellGeomContainer.h"
 #include "PHG4CylinderCellGeom.h"
+#include "PHG4CellSplitter.h"
 #include "PHG4CylinderCellv1.h"
 #include "PHG4CylinderCellContainer.h"
 #include "PHG4CylinderCellDefs.h"
@@ -21,18 +22,35 @@
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 
 using namespace std;
+using namespace SeamStress;
 
 PHG4CylinderCellReco::PHG4CylinderCellReco(const string &name) :
   SubsysReco(name),
   _timer(PHTimeServer::get()->insert_new("PHG4CylinderCellReco")),
-  chkenergyconservation(0)
+  chkenergyconservation(0),
+  nthreads(1),
+  current_ntasks(0),
+  thread_tot(0),
+  vssp(NULL),
+  pins(NULL)
 {
   memset(nbins, 0, sizeof(nbins));
 }
 
+PHG4CylinderCellReco::~PHG4CylinderCellReco()
+{
+  for (unsigned int i = 0; i < vss.size(); i++)
+    {
+      vss[i].stop();
+    }
+  delete pins;
+  delete vssp;
+}
+
 int PHG4CylinderCellReco::InitRun(PHCompositeNode *topNode)
 {
   PHNodeIterator iter(topNode);
@@ -270,6 +288,21 @@ int PHG4CylinderCellReco::InitRun(PHCompositeNode *topNode)
     cout << "===========================================================================" << endl;
   }
 
+  if (nthreads > 1 && !pins)
+    {
+      Seamstress::init_vector(nthreads, vss);
+      vssp = new vector<Seamstress*>();
+      for (unsigned int i = 0; i < vss.size(); i++)
+	{
+	  vssp->push_back(&(vss[i]));
+	}
+      pins = new Pincushion<PHG4CylinderCellReco>(this, vssp);
+      if (verbosity > 0)
+	{
+	  cout << Name() << ": processing the layers on " << nthreads << " threads" << endl;
+	}
+    }
+
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -299,7 +332,6 @@ PHG4CylinderCellReco::process_event(PHCompositeNode *topNode)
       exit(1);
     }
 
-  map<int, std::pair <double, double> >::iterator sizeiter;
   PHG4HitContainer::LayerIter layer;
   pair<PHG4HitContainer::LayerIter, PHG4HitContainer::LayerIter> layer_begin_end = g4hit->getLayers();
   //   cout << "number of layers: " << g4hit->num_layers() << endl;
@@ -308,445 +340,202 @@ PHG4CylinderCellReco::process_event(PHCompositeNode *topNode)
   //     {
   //       cout << "layer number: " << *layer << endl;
   //     }
+
+  // the layers fire disjoint cells, their deposits are computed independently
+  // (in parallel with more than one thread) and added to the cells in layer order
+  unsigned int ntasks = 0;
   for (layer = layer_begin_end.first; layer != layer_begin_end.second; layer++)
     {
-      PHG4HitContainer::ConstIterator hiter;
-      PHG4HitContainer::ConstRange hit_begin_end = g4hit->getHits(*layer);
-      PHG4CylinderCellGeom *geo = seggeo->GetLayerCellGeom(*layer);
-      int nphibins = n_phi_z_bins[*layer].first;
-      int nzbins = n_phi_z_bins[*layer].second;
-
-      // ------- eta/phi binning ------------------------------------------------------------------------
-      if (binning[*layer] == PHG4CylinderCellDefs::etaphibinning)
-        {
-          for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; hiter++)
-            {
-              pair<double, double> etaphi[2];
-              double phibin[2];
-              double etabin[2];
-              for (int i = 0; i < 2; i++)
-                {
-                  etaphi[i] = get_etaphi(hiter->second->get_x(i), hiter->second->get_y(i), hiter->second->get_z(i));
-                  etabin[i] = geo->get_etabin( etaphi[i].first );
-                  phibin[i] = geo->get_phibin( etaphi[i].second );
-                }
-              // check bin range
-              if (phibin[0] < 0 || phibin[0] >= nphibins || phibin[1] < 0 || phibin[1] >= nphibins)
-                {
-                  continue;
-                }
-              if (etabin[0] < 0 || etabin[0] >= nzbins   || etabin[1] < 0 || etabin[1] >= nzbins)
-                {
-                  continue;
-                }
-
-              if (etabin[0] < 0)
-                {
-                  if (verbosity > 0)
-                    {
-                      hiter->second->identify();
-                    }
-                  continue;
-                }
-
-              int intphibin = phibin[0];
-              int intetabin = etabin[0];
-              int intphibinout = phibin[1];
-              int intetabinout = etabin[1];
-
-              // Determine all fired cells
-
-              double ax = (etaphi[0]).second; // phi
-              double ay = (etaphi[0]).first;  // eta
-              double bx = (etaphi[1]).second;
-              double by = (etaphi[1]).first;
-              if (intphibin > intphibinout)
-                {
-                  int tmp = intphibin;
-                  intphibin = intphibinout;
-                  intphibinout = tmp;
-                }
-              if (intetabin > intetabinout)
-                {
-                  int tmp = intetabin;
-                  intetabin = intetabinout;
-                  intetabinout = tmp;
-                }
-
-              double trklen = sqrt((ax - bx) * (ax - bx) + (ay - by) * (ay - by));
-	      // if entry and exit hit are the same (seems to happen rarely), trklen = 0
-	      // which leads to a 0/0 and an NaN in edep later on
-	      // this code does for particles in the same cell a trklen/trklen (vdedx[ii]/trklen)
-	      // so setting this to any non zero number will do just fine
-	      // I just pick -1 here to flag those strange hits in case I want t oanalyze them
-	      // later on
-	      if (trklen == 0)
-		{
-		  trklen = -1.;
-		}
-              vector<int> vphi;
-              vector<int> veta;
-              vector<double> vdedx;
-
-              if (intphibin == intphibinout && intetabin == intetabinout)   // single cell fired
-                {
-                  if (verbosity > 0) cout << "SINGLE CELL FIRED: " << intphibin << " " << intetabin << endl;
-                  vphi.push_back(intphibin);
-                  veta.push_back(intetabin);
-                  vdedx.push_back(trklen);
-                }
-              else
-                {
-                  for (int ibp = intphibin; ibp <= intphibinout; ibp++)
-                    {
-                      for (int ibz = intetabin; ibz <= intetabinout; ibz++)
-                        {
-                          double cx = geo->get_phicenter(ibp) - geo->get_phistep() / 2.;
-                          double dx = geo->get_phicenter(ibp) + geo->get_phistep() / 2.;
-                          double cy = geo->get_etacenter(ibz) - geo->get_etastep() / 2.;
-                          double dy = geo->get_etacenter(ibz) + geo->get_etastep() / 2.;
-                          double rr = 0.;
-                          //cout << "##### line: " << ax << " " << ay << " " << bx << " " << by << endl;
-                          //cout << "####### cell: " << cx << " " << cy << " " << dx << " " << dy << endl;
-                          bool yesno = line_and_rectangle_intersect(ax, ay, bx, by, cx, cy, dx, dy, &rr);
-                          if (yesno)
-                            {
-                              if (verbosity > 0) cout << "CELL FIRED: " << ibp << " " << ibz << " " << rr << endl;
-                              vphi.push_back(ibp);
-                              veta.push_back(ibz);
-                              vdedx.push_back(rr);
-                            }
-                        }
-                    }
-                }
-              if (verbosity > 0) cout << "NUMBER OF FIRED CELLS = " << vphi.size() << endl;
-
-              double tmpsum = 0.;
-              for (unsigned int ii = 0; ii < vphi.size(); ii++)
-                {
-                  tmpsum += vdedx[ii];
-                  vdedx[ii] = vdedx[ii] / trklen;
-                  if (verbosity > 0) cout << "  CELL " << ii << "  dE/dX = " <<  vdedx[ii] << endl;
-                }
-              if (verbosity > 0) cout << "    TOTAL TRACK LENGTH = " << tmpsum << " " << trklen << endl;
-
-              for (unsigned int i1 = 0; i1 < vphi.size(); i1++)   // loop over all fired cells
-                {
+      if (layertasks.size() <= ntasks)
+	{
+	  layertasks.resize(ntasks + 1);
+	}
+      LayerTask &task = layertasks[ntasks];
+      ntasks++;
+      task.layer = *layer;
+      task.hits = g4hit->getHits(*layer);
+      task.geo = seggeo->GetLayerCellGeom(*layer);
+      task.nphibins = n_phi_z_bins[*layer].first;
+      task.nzbins = n_phi_z_bins[*layer].second;
+      task.binning = binning[*layer];
+    }
 
-                  int iphibin = vphi[i1];
-                  int ietabin = veta[i1];
-
-		  // This is the key for cellptmap
-		  // It is constructed using the phi and z (or eta) bin index values
-		  // It will be unique for a given phi and z (or eta) bin combination
-		  char inkey[1024];
-		  sprintf(inkey,"%i-%i",iphibin,ietabin);
-		  std::string key(inkey);
-
-		  if(verbosity > 1)
-		    cout << " iphibin " << iphibin << " ietabin " << ietabin << " key " << key << endl;
-
-		  if(cellptmap.count(key) > 0)
-		    {
-		      if(verbosity > 1)
-			cout << "  add energy to existing cell " << endl;
-
-		      cellptmap.find(key)->second->add_edep(hiter->first, hiter->second->get_edep()*vdedx[i1], hiter->second->get_light_yield()*vdedx[i1]);
-		    }
-		  else
-		    {
-		      if(verbosity > 1)
-			cout << "    did not find a previous entry for key = " << key << " add a new one" << endl;
-
-		      cellptmap[key] = new PHG4CylinderCellv1();
-		      it = cellptmap.find(key);
-                      it->second->set_layer(*layer);
-                      it->second->set_phibin(iphibin);
-                      it->second->set_etabin(ietabin);		      
-		      it->second->add_edep(hiter->first, hiter->second->get_edep()*vdedx[i1], hiter->second->get_light_yield()*vdedx[i1]);
-		    }
-
-		  // just a sanity check - we don't want to mess up by having Nan's or Infs in our energy deposition
-		  if (! isfinite(hiter->second->get_edep()*vdedx[i1]))
-		    {
-		      cout << PHWHERE << " invalid energy dep " << hiter->second->get_edep()
-			   << " or path length: " << vdedx[i1] << endl;
-		    }
-                }
-              vphi.clear();
-              veta.clear();
+  if (pins && ntasks > 1)
+    {
+      current_ntasks = ntasks;
+      thread_tot = (ntasks < nthreads) ? ntasks : nthreads;
+      pins->sewStraight(&PHG4CylinderCellReco::process_layer_thread, thread_tot);
+    }
+  else
+    {
+      for (unsigned int i = 0; i < ntasks; i++)
+	{
+	  process_layer(layertasks[i]);
+	}
+    }
+  for (unsigned int i = 0; i < ntasks; i++)
+    {
+      add_cells(layertasks[i], cells);
+    }
 
-            } // end loop over g4hits
+  if (chkenergyconservation)
+    {
+      CheckEnergy(topNode);
+    }
+  _timer.get()->stop();
+  return Fun4AllReturnCodes::EVENT_OK;
+}
 
-          int numcells = 0;
 
-	  for(it = cellptmap.begin(); it != cellptmap.end(); ++it)
-	    {
-	      cells->AddCylinderCell(*layer, it->second);
-	      numcells++;
-	      if (verbosity > 1)
-		{
-		  cout << "Adding cell in bin phi: " << it->second->get_binphi()
-		       << " phi: " << geo->get_phicenter(it->second->get_binphi()) * 180./M_PI
-		       << ", z bin: " << it->second->get_bineta()
-		       << ", z: " <<  geo->get_etacenter(it->second->get_bineta())
-		       << ", energy dep: " << it->second->get_edep()
-		       << endl;
-		}
-	    }
+void
+PHG4CylinderCellReco::process_layer(LayerTask &task)
+{
+  PHG4HitContainer::ConstIterator hiter;
+  PHG4CylinderCellGeom *geo = task.geo;
+  task.deposits.clear();
 
-          if (verbosity > 0)
-            {
-              cout << Name() << ": found " << numcells << " eta/phi cells with energy deposition" << endl;
-            }
+  // bin the entry and exit points of all hits of the layer at once
+  unsigned int npoints = 2 * distance(task.hits.first, task.hits.second);
+  if (npoints == 0)
+    {
+      return;
+    }
+  task.x.resize(npoints);
+  task.y.resize(npoints);
+  task.z.resize(npoints);
+  task.phi.resize(npoints);
+  task.zeta.resize(npoints);
+  task.phibin.resize(npoints);
+  task.zetabin.resize(npoints);
+  unsigned int ipoint = 0;
+  for (hiter = task.hits.first; hiter != task.hits.second; hiter++)
+    {
+      for (int i = 0; i < 2; i++)
+        {
+          task.x[ipoint] = hiter->second->get_x(i);
+          task.y[ipoint] = hiter->second->get_y(i);
+          task.z[ipoint] = hiter->second->get_z(i);
+          ipoint++;
         }
-
-
-
-      else // ------ size binning ---------------------------------------------------------------
+    }
+  geo->find_bins(npoints, &task.x[0], &task.y[0], &task.z[0], &task.phi[0], &task.zeta[0], &task.phibin[0], &task.zetabin[0]);
+
+  // the binning only changes the cell grid (phi and eta or z), the hits are split the same way
+  PHG4CellSplitter splitter = (task.binning == PHG4CylinderCellDefs::etaphibinning) ?
+    PHG4CellSplitter(geo, PHG4CellSplitterEtaPhi()) :
+    PHG4CellSplitter(geo, PHG4CellSplitterZPhi());
+  ipoint = 0;
+  for (hiter = task.hits.first; hiter != task.hits.second; hiter++, ipoint += 2)
+    {
+      unsigned int ncells = splitter.Split(task.phi[ipoint], task.zeta[ipoint], task.phibin[ipoint], task.zetabin[ipoint],
+                                           task.phi[ipoint + 1], task.zeta[ipoint + 1], task.phibin[ipoint + 1], task.zetabin[ipoint + 1]);
+      if (verbosity > 0)
+        {
+          cout << "hit " << hiter->first << " in layer " << task.layer
+               << ": phi bins " << task.phibin[ipoint] << " to " << task.phibin[ipoint + 1]
+               << ", z/eta bins " << task.zetabin[ipoint] << " to " << task.zetabin[ipoint + 1]
+               << ", fired cells: " << ncells << endl;
+        }
+      for (unsigned int i = 0; i < ncells; i++)   // loop over all fired cells
         {
-          sizeiter = cell_size.find(*layer);
-          if (sizeiter == cell_size.end())
+          double fraction = splitter.get_fraction(i);
+          if (verbosity > 1)
             {
-              cout << "logical screwup!!! no sizes for layer " << *layer << endl;
-              exit(1);
+              cout << "  CELL " << splitter.get_xbin(i) << " " << splitter.get_ybin(i) << " path length fraction: " << fraction << endl;
             }
-          double zstepsize = (sizeiter->second).second;
-          double phistepsize = phistep[*layer];
+          task.deposits.push_back(CellDeposit(splitter.get_xbin(i), splitter.get_ybin(i), hiter->first, hiter->second->get_edep()*fraction, hiter->second->get_light_yield()*fraction));
 
-          for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; hiter++)
+          // just a sanity check - we don't want to mess up by having Nan's or Infs in our energy deposition
+          if (! isfinite(hiter->second->get_edep()*fraction))
             {
-              double xinout[2];
-              double yinout[2];
-              double px[2];
-              double py[2];
-              double phi[2];
-              double z[2];
-              double phibin[2];
-              double zbin[2];
-              if (verbosity > 0) cout << "--------- new hit in layer # " << *layer << endl;
-
-              for (int i = 0; i < 2; i++)
-                {
-                  xinout[i] = hiter->second->get_x(i);
-                  yinout[i] = hiter->second->get_y(i);
-                  px[i] = hiter->second->get_px(i);
-                  py[i] = hiter->second->get_py(i);
-                  phi[i] = atan2(hiter->second->get_y(i), hiter->second->get_x(i));
-                  z[i] =  hiter->second->get_z(i);
-                  phibin[i] = geo->get_phibin( phi[i] );
-                  zbin[i] = geo->get_zbin( hiter->second->get_z(i) );
-
-                  if (verbosity > 0) cout << " " << i << "  phibin: " << phibin[i] << ", phi: " << phi[i] << ", stepsize: " << phistepsize << endl;
-                  if (verbosity > 0) cout << " " << i << "  zbin: " << zbin[i] << ", z = " << hiter->second->get_z(i) << ", stepsize: " << zstepsize << " offset: " <<  zmin_max[*layer].first << endl;
-                }
-              // check bin range
-              if (phibin[0] < 0 || phibin[0] >= nphibins || phibin[1] < 0 || phibin[1] >= nphibins)
-                {
-                  continue;
-                }
-              if (zbin[0] < 0 || zbin[0] >= nzbins   || zbin[1] < 0 || zbin[1] >= nzbins)
-                {
-                  continue;
-                }
-
-
-              if (zbin[0] < 0)
-                {
-                  hiter->second->identify();
-                  continue;
-                }
-
-              int intphibin = phibin[0];
-              int intzbin = zbin[0];
-              int intphibinout = phibin[1];
-              int intzbinout = zbin[1];
-
-              if (verbosity > 0)
-                {
-                  cout << "    phi bin range: " << intphibin << " to " << intphibinout << " phi: " << phi[0] << " to " << phi[1] << endl;
-                  cout << "    Z bin range: " << intzbin << " to " << intzbinout << " Z: " << z[0] << " to " << z[1] << endl;
-                  cout << "    phi difference: " << (phi[1] - phi[0])*1000. << " milliradians." << endl;
-                  cout << "    phi difference: " << 2.5*(phi[1] - phi[0])*10000. << " microns." << endl;
-                  cout << "    path length = " << sqrt((xinout[1] - xinout[0])*(xinout[1] - xinout[0]) + (yinout[1] - yinout[0])*(yinout[1] - yinout[0])) << endl;
-                  cout << "       px = " << px[0] << " " << px[1] << endl;
-                  cout << "       py = " << py[0] << " " << py[1] << endl;
-                  cout << "       x = " << xinout[0] << " " << xinout[1] << endl;
-                  cout << "       y = " << yinout[0] << " " << yinout[1] << endl;
-                }
-
-              // Determine all fired cells
-
-              double ax = phi[0];
-              double ay = z[0];
-              double bx = phi[1];
-              double by = z[1];
-              if (intphibin > intphibinout)
-                {
-                  int tmp = intphibin;
-                  intphibin = intphibinout;
-                  intphibinout = tmp;
-                }
-              if (intzbin > intzbinout)
-                {
-                  int tmp = intzbin;
-                  intzbin = intzbinout;
-                  intzbinout = tmp;
-                }
-
-              double trklen = sqrt((ax - bx) * (ax - bx) + (ay - by) * (ay - by));
-              // if entry and exit hit are the same (seems to happen rarely), trklen = 0
-              // which leads to a 0/0 and an NaN in edep later on
-              // this code does for particles in the same cell a trklen/trklen (vdedx[ii]/trklen)
-              // so setting this to any non zero number will do just fine
-              // I just pick -1 here to flag those strange hits in case I want t oanalyze them
-              // later on
-              if (trklen == 0)
-          {
-            trklen = -1.;
-          }
-              vector<int> vphi;
-              vector<int> vz;
-              vector<double> vdedx;
-
-              if (intphibin == intphibinout && intzbin == intzbinout)   // single cell fired
-                {
-                  if (verbosity > 0) cout << "SINGLE CELL FIRED: " << intphibin << " " << intzbin << endl;
-                  vphi.push_back(intphibin);
-                  vz.push_back(intzbin);
-                  vdedx.push_back(trklen);
-                }
-              else
-                {
-                  for (int ibp = intphibin; ibp <= intphibinout; ibp++)
-                    {
-                      for (int ibz = intzbin; ibz <= intzbinout; ibz++)
-                        {
-                          double cx = geo->get_phicenter(ibp) - geo->get_phistep() / 2.;
-                          double dx = geo->get_phicenter(ibp) + geo->get_phistep() / 2.;
-                          double cy = geo->get_zcenter(ibz) - geo->get_zstep() / 2.;
-                          double dy = geo->get_zcenter(ibz) + geo->get_zstep() / 2.;
-                          double rr = 0.;
-                          //cout << "##### line: " << ax << " " << ay << " " << bx << " " << by << endl;
-                          //cout << "####### cell: " << cx << " " << cy << " " << dx << " " << dy << endl;
-                          bool yesno = line_and_rectangle_intersect(ax, ay, bx, by, cx, cy, dx, dy, &rr);
-                          if (yesno)
-                            {
-                              if (verbosity > 0) cout << "CELL FIRED: " << ibp << " " << ibz << " " << rr << endl;
-                              vphi.push_back(ibp);
-                              vz.push_back(ibz);
-                              vdedx.push_back(rr);
-                            }
-                        }
-                    }
-                }
-              if (verbosity > 0) cout << "NUMBER OF FIRED CELLS = " << vz.size() << endl;
-
-              double tmpsum = 0.;
-              for (unsigned int ii = 0; ii < vz.size(); ii++)
-                {
-                  tmpsum += vdedx[ii];
-                  vdedx[ii] = vdedx[ii] / trklen;
-                  if (verbosity > 0) cout << "  CELL " << ii << "  dE/dX = " <<  vdedx[ii] << endl;
-                }
-              if (verbosity > 0) cout << "    TOTAL TRACK LENGTH = " << tmpsum << " " << trklen << endl;
-
-              for (unsigned int i1 = 0; i1 < vphi.size(); i1++)   // loop over all fired cells
-                {
-                  int iphibin = vphi[i1];
-                  int izbin = vz[i1];
-
-		  char inkey[1024];
-		  sprintf(inkey,"%i-%i",iphibin,izbin);
-		  std::string key(inkey);
-
-		  if(verbosity > 1)
-		    cout << " iphibin " << iphibin << " izbin " << izbin << " key " << key << endl;
-	
-		  // check to see if there is already an entry for this cell
-		  if(cellptmap.count(key) > 0)
-		    {
-		      if(verbosity > 1)
-			cout << "  add energy to existing cell for key = " << cellptmap.find(key)->first << endl;
-
-		      cellptmap.find(key)->second->add_edep(hiter->first, hiter->second->get_edep()*vdedx[i1], hiter->second->get_light_yield()*vdedx[i1]);
-
-          if(verbosity > 1 and isnan(hiter->second->get_light_yield()*vdedx[i1]))
-            {
-
-              cout << "    NAN lighy yield with vdedx[i1] = "<<vdedx[i1]
-              <<" and hiter->second->get_light_yield() = "<<hiter->second->get_light_yield() << endl;
-
-            }
-		    }
-		  else
-		    {
-		      if(verbosity > 1)
-			cout << "    did not find a previous entry for key = " << key << " create a new one" << endl;
-
-		      cellptmap[key] = new PHG4CylinderCellv1();
-		      it = cellptmap.find(key);
-		      it->second->set_layer(*layer);
-                      it->second->set_phibin(iphibin);
-                      it->second->set_zbin(izbin);
-		      it->second->add_edep(hiter->first, hiter->second->get_edep()*vdedx[i1], hiter->second->get_light_yield()*vdedx[i1]);
-
-          if(verbosity > 1 and isnan(hiter->second->get_light_yield()*vdedx[i1]))
-            {
-
-              cout << "    NAN lighy yield with vdedx[i1] = "<<vdedx[i1]
-              <<" and hiter->second->get_light_yield() = "<<hiter->second->get_light_yield() << endl;
-
+              cout << PHWHERE << " invalid energy dep " << hiter->second->get_edep()
+                   << " or path length: " << fraction << endl;
             }
+        }
+    } // end loop over g4hits
 
-		    }
-		}
-              vphi.clear();
-              vz.clear();
-	      
-            } // end loop over hits
+  return;
+}
 
-          int numcells = 0;
+void
+PHG4CylinderCellReco::process_layer_thread(void *arg)
+{
+  unsigned long int w = *((unsigned long int *) arg);
+  for (unsigned long int i = w; i < current_ntasks; i += thread_tot)
+    {
+      process_layer(layertasks[i]);
+    }
+  return;
+}
 
-	  for(it = cellptmap.begin(); it != cellptmap.end(); ++it)
+void
+PHG4CylinderCellReco::add_cells(const LayerTask &task, PHG4CylinderCellContainer *cells)
+{
+  // replaying the deposits in order creates the cells and sums their
+  // energies exactly as if they were added while looping over the hits
+  cellindex.clear(static_cast<PHG4CylinderCellIndex::keytype>(task.nphibins) * task.nzbins);
+  bool etaphi = (task.binning == PHG4CylinderCellDefs::etaphibinning);
+  for (vector<CellDeposit>::const_iterator iter = task.deposits.begin(); iter != task.deposits.end(); ++iter)
+    {
+      PHG4CylinderCell *&cell = cellindex[iter->phibin * task.nzbins + iter->zbin];
+      if (!cell)
+	{
+	  cell = new PHG4CylinderCellv1();
+	  cell->set_layer(task.layer);
+	  cell->set_phibin(iter->phibin);
+	  if (etaphi)
 	    {
-	      cells->AddCylinderCell(*layer, it->second);
-	      numcells++;
-	      if (verbosity > 1)
-		{
-		  cout << "Adding cell for key " << it->first << " in bin phi: " << it->second->get_binphi()
-		       << " phi: " << geo->get_phicenter(it->second->get_binphi()) * 180./M_PI
-		       << ", z bin: " << it->second->get_binz()
-		       << ", z: " <<  geo->get_zcenter(it->second->get_binz())
-		       << ", energy dep: " << it->second->get_edep()
-		       << endl;
-		}
+	      cell->set_etabin(iter->zbin);
 	    }
-	  
-          if (verbosity > 0)
-            {
-              cout << "found " << numcells << " z/phi cells with energy deposition" << endl;
-            }
-        }
+	  else
+	    {
+	      cell->set_zbin(iter->zbin);
+	    }
+	}
+      cell->add_edep(iter->hitid, iter->edep, iter->light_yield);
+    }
 
-      //==========================================================
-      // now reset the cell map before moving on to the next layer
-      if(verbosity > 1)
-	cout << "cellptmap for layer " << *layer << " has final length " << cellptmap.size();
-      while(cellptmap.begin() != cellptmap.end())
+  int numcells = 0;
+  for (PHG4CylinderCellIndex::ConstIterator it = cellindex.begin(); it != cellindex.end(); ++it)
+    {
+      cells->AddCylinderCell(task.layer, it->second);
+      numcells++;
+      if (verbosity > 1)
 	{
-	  // Assumes that mmmory is freed by the cylinder cell container when it is destroyed
-	  cellptmap.erase(cellptmap.begin());
-	} 
-      if(verbosity > 1)
-	cout << " reset it to " << cellptmap.size() << endl;
+	  if (etaphi)
+	    {
+	      cout << "Adding cell in bin phi: " << it->second->get_binphi()
+		   << " phi: " << task.geo->get_phicenter(it->second->get_binphi()) * 180./M_PI
+		   << ", z bin: " << it->second->get_bineta()
+		   << ", z: " <<  task.geo->get_etacenter(it->second->get_bineta())
+		   << ", energy dep: " << it->second->get_edep()
+		   << endl;
+	    }
+	  else
+	    {
+	      cout << "Adding cell for key " << it->first << " in bin phi: " << it->second->get_binphi()
+		   << " phi: " << task.geo->get_phicenter(it->second->get_binphi()) * 180./M_PI
+		   << ", z bin: " << it->second->get_binz()
+		   << ", z: " <<  task.geo->get_zcenter(it->second->get_binz())
+		   << ", energy dep: " << it->second->get_edep()
+		   << endl;
+	    }
+	}
     }
-  if (chkenergyconservation)
+  if (verbosity > 0)
     {
-      CheckEnergy(topNode);
+      if (etaphi)
+	{
+	  cout << Name() << ": found " << numcells << " eta/phi cells with energy deposition" << endl;
+	}
+      else
+	{
+	  cout << "found " << numcells << " z/phi cells with energy deposition" << endl;
+	}
     }
-  _timer.get()->stop();
-  return Fun4AllReturnCodes::EVENT_OK;
+  // the memory of the cells is freed by the cylinder cell container
+  cellindex.clear();
+  return;
 }
 
 int
@@ -809,163 +598,6 @@ PHG4CylinderCellReco::get_eta(const double radius, const double z)
   return eta;
 }
 
-//---------------------------------------------------------------
-
-bool PHG4CylinderCellReco::lines_intersect(
-  double ax,
-  double ay,
-  double bx,
-  double by,
-  double cx,
-  double cy,
-  double dx,
-  double dy,
-  double* rx, // intersection point (output)
-  double* ry
-)
-{
-
-// Find if a line segment limited by points A and B
-// intersects line segment limited by points C and D.
-// First check if an infinite line defined by A and B intersects
-// segment (C,D). If h is from 0 to 1 line and line segment intersect
-// Then check in intersection point is between C and D
-
-  double ex = bx - ax; // E=B-A
-  double ey = by - ay;
-  double fx = dx - cx; // F=D-C
-  double fy = dy - cy;
-  double px = -ey;     // P
-  double py = ex;
-
-  double bottom = fx * px + fy * py; // F*P
-  double gx = ax - cx; // A-C
-  double gy = ay - cy;
-  double top = gx * px + gy * py; // G*P
-
-  double h = 99999.;
-  if (bottom != 0.)
-    {
-      h = top / bottom;
-    }
-
-//intersection point R = C + F*h
-  if (h > 0. && h < 1.)
-    {
-      *rx = cx + fx * h;
-      *ry = cy + fy * h;
-      //cout << "      line/segment intersection coordinates: " << *rx << " " << *ry << endl;
-      if ((*rx > ax && *rx > bx) || (*rx < ax && *rx < bx) || (*ry < ay && *ry < by) || (*ry > ay && *ry > by))
-        {
-          //cout << "       NO segment/segment intersection!" << endl;
-          return false;
-        }
-      else
-        {
-          //cout << "       segment/segment intersection!" << endl;
-          return true;
-        }
-    }
-
-  return false;
-}
-
-//---------------------------------------------------------------
-
-bool  PHG4CylinderCellReco::line_and_rectangle_intersect(
-  double ax,
-  double ay,
-  double bx,
-  double by,
-  double cx,
-  double cy,
-  double dx,
-  double dy,
-  double* rr // length of the line segment inside the rectangle (output)
-)
-{
-
-// find if a line isegment limited by points (A,B)
-// intersects with a rectangle defined by two
-// corner points (C,D) two other points are E and F
-//   E--------D
-//   |        |
-//   |        |
-//   C--------F
-
-  if (cx > dx || cy > dy)
-    {
-      cerr << "ERROR: Bad rectangle definition!" << endl;
-      return false;
-    }
-
-  double ex = cx;
-  double ey = dy;
-  double fx = dx;
-  double fy = cy;
-  double rx = 99999.;
-  double ry = 99999.;
-
-  vector<double> vx;
-  vector<double> vy;
-
-  bool i1 = lines_intersect(ax, ay, bx, by, cx, cy, fx, fy, &rx, &ry);
-  if (i1)
-    {
-      vx.push_back(rx);
-      vy.push_back(ry);
-    }
-  bool i2 = lines_intersect(ax, ay, bx, by, fx, fy, dx, dy, &rx, &ry);
-  if (i2)
-    {
-      vx.push_back(rx);
-      vy.push_back(ry);
-    }
-  bool i3 = lines_intersect(ax, ay, bx, by, ex, ey, dx, dy, &rx, &ry);
-  if (i3)
-    {
-      vx.push_back(rx);
-      vy.push_back(ry);
-    }
-  bool i4 = lines_intersect(ax, ay, bx, by, cx, cy, ex, ey, &rx, &ry);
-  if (i4)
-    {
-      vx.push_back(rx);
-      vy.push_back(ry);
-    }
-
-//cout << "Rectangle intersections: " << i1 << " " << i2 << " " << i3 << " " << i4 << endl;
-//cout << "Number of intersections = " << vx.size() << endl;
-
-  *rr = 0.;
-  if (vx.size() == 2)
-    {
-      *rr = sqrt( (vx[0] - vx[1]) * (vx[0] - vx[1]) + (vy[0] - vy[1]) * (vy[0] - vy[1]) );
-//  cout << "Length of intersection = " << *rr << endl;
-    }
-  if (vx.size() == 1)
-    {
-      // find which point (A or B) is within the rectangle
-      if (ax > cx && ay > cy && ax < dx && ay < dy)   // point A is inside the rectangle
-        {
-          //cout << "Point A is inside the rectangle." << endl;
-          *rr = sqrt((vx[0] - ax) * (vx[0] - ax) + (vy[0] - ay) * (vy[0] - ay));
-        }
-      if (bx > cx && by > cy && bx < dx && by < dy)   // point B is inside the rectangle
-        {
-          //cout << "Point B is inside the rectangle." << endl;
-          *rr = sqrt((vx[0] - bx) * (vx[0] - bx) + (vy[0] - by) * (vy[0] - by));
-        }
-    }
-
-  if (i1 || i2 || i3 || i4)
-    {
-      return true;
-    }
-  return false;
-}
-
-
 int
 PHG4CylinderCellReco::CheckEnergy(PHCompositeNode *topNode)
 {
@@ -1,13 +1,23 @@
 #ifndef PHG4CYLINDERCELLRECO_H
 #define PHG4CYLINDERCELLRECO_H
 
+#include "PHG4CylinderCellIndex.h"
+
 #include <fun4all/SubsysReco.h>
 #include <phool/PHTimeServer.h>
 #include <string>
 #include <map>
+#include <vector>
+
+#ifndef __CINT__
+#include <g4main/PHG4HitContainer.h>
+#include <Pincushion.h>
+#endif
 
 class PHCompositeNode;
 class PHG4CylinderCell;
+class PHG4CylinderCellContainer;
+class PHG4CylinderCellGeom;
 
 class PHG4CylinderCellReco : public SubsysReco
 {
@@ -15,7 +25,7 @@ class PHG4CylinderCellReco : public SubsysReco
 
   PHG4CylinderCellReco(const std::string &name = "CYLINDERRECO");
 
-  virtual ~PHG4CylinderCellReco(){}
+  virtual ~PHG4CylinderCellReco();
   
   //! module initialization
   int InitRun(PHCompositeNode *topNode);
@@ -35,13 +45,14 @@ class PHG4CylinderCellReco : public SubsysReco
   void checkenergy(const int i=1) {chkenergyconservation = i;}
   void OutputDetector(const std::string &d) {outdetector = d;}
 
+  //! process the layers on n threads (default 1: serially), the cells are identical
+  void set_num_threads(const unsigned int n) {nthreads = (n > 0) ? n : 1;}
+
  protected:
   void set_size(const int i, const double sizeA, const double sizeB, const int what);
   int CheckEnergy(PHCompositeNode *topNode);
   static std::pair<double, double> get_etaphi(const double x, const double y, const double z);
   static double get_eta(const double radius, const double z);
-  bool lines_intersect( double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy, double* rx, double* ry);
-  bool line_and_rectangle_intersect( double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy, double* rr);
 
   std::map<int, int>  binning;
   std::map<int, std::pair <double,double> > cell_size; // cell size in phi/z
@@ -55,12 +66,55 @@ class PHG4CylinderCellReco : public SubsysReco
   std::string geonodename;
   std::string seggeonodename;
   std::map<int, std::pair<int, int> > n_phi_z_bins;
-  std::map<std::string, PHG4CylinderCell*> cellptmap;  // This map holds the hit cells
-  std::map<std::string, PHG4CylinderCell*>::iterator it;
+  PHG4CylinderCellIndex cellindex;  // the hit cells of the current layer by phibin * nzbins + z/etabin
 
   PHTimeServer::timer _timer;
   int nbins[2];
   int chkenergyconservation;
+  unsigned int nthreads;
+
+#ifndef __CINT__
+  //! energy deposit of one hit in one cell
+  struct CellDeposit
+  {
+    CellDeposit(const int phi, const int z, const PHG4HitDefs::keytype id, const double e, const double ly):
+      phibin(phi), zbin(z), hitid(id), edep(e), light_yield(ly) {}
+    int phibin;
+    int zbin; // eta bin for eta/phi binning
+    PHG4HitDefs::keytype hitid;
+    double edep;
+    double light_yield;
+  };
+
+  //! everything needed to process one layer without touching the module state
+  struct LayerTask
+  {
+    unsigned int layer;
+    PHG4HitContainer::ConstRange hits;
+    PHG4CylinderCellGeom *geo;
+    int nphibins;
+    int nzbins;
+    int binning;
+    std::vector<CellDeposit> deposits;
+    // entry (2*i) and exit (2*i + 1) points of hit i, their phi, eta or z and bins
+    std::vector<double> x, y, z, phi, zeta;
+    std::vector<int> phibin, zetabin;
+  };
+
+  //! computes the cell deposits of the hits of one layer, thread safe
+  void process_layer(LayerTask &task);
+  //! thread w processes the layers w, w + thread_tot, ...
+  void process_layer_thread(void *arg);
+  //! creates the cells from the deposits of one layer
+  void add_cells(const LayerTask &task, PHG4CylinderCellContainer *cells);
+
+  std::vector<LayerTask> layertasks;
+  unsigned long int current_ntasks;
+  unsigned long int thread_tot;
+  std::vector<SeamStress::Seamstress> vss;
+  std::vector<SeamStress::Seamstress*> *vssp;
+  SeamStress::Pincushion<PHG4CylinderCellReco> *pins;
+#endif
 
 };
 
@@ -22,18 +22,116 @@
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <vector>
 
 using namespace std;
 
+namespace
+{
+  //! erf on a fine grid with linear interpolation (error below 2e-7), +-1 beyond |x| = 6
+  class ErfTable
+  {
+  public:
+    ErfTable() : inv_step(1000.), xmax(6.)
+    {
+      int n = (int)(xmax*inv_step + 0.5);
+      table.resize(n + 2);
+      for(int i = 0; i <= n + 1; ++i){table[i] = erf(i/inv_step);}
+    }
+    
+    double operator()(const double x) const
+    {
+      double ax = fabs(x);
+      if(ax >= xmax){return (x > 0.) ? 1. : -1.;}
+      double f = ax*inv_step;
+      int i = (int)f;
+      f -= i;
+      double y = table[i] + f*(table[i + 1] - table[i]);
+      return (x < 0.) ? -y : y;
+    }
+    
+  private:
+    double inv_step;
+    double xmax;
+    vector<double> table;
+  };
+  
+  const ErfTable fast_erf;
+}
 
 PHG4CylinderCellTPCReco::PHG4CylinderCellTPCReco(const string &name) :
-SubsysReco(name), diffusion(0.0057), elec_per_kev(38.)
+SubsysReco(name), diffusion(0.0057), elec_per_kev(38.), electron_diffusion(false)
 {
   memset(nbins, 0, sizeof(nbins));
 }
 
 
+void PHG4CylinderCellTPCReco::bin_fractions(const double disp, const double binwidth, const double sigma, const int n, vector<double> &fraction)
+{
+  // the bins -n..n share their edges, so 2n+2 erf evaluations give all 2n+1 integrals
+  fraction.resize(2*n + 1);
+  double scale = M_SQRT1_2/sigma;
+  double lower = fast_erf(((-0.5 - n)*binwidth - disp)*scale);
+  for( int i = -n; i <= n; ++i )
+  {
+    double upper = fast_erf(((0.5 + i)*binwidth - disp)*scale);
+    fraction[i + n] = 0.5*(upper - lower);
+    lower = upper;
+  }
+}
+
+
+void PHG4CylinderCellTPCReco::add_electrons(const PHG4HitDefs::keytype hitid, const int layer, const int phibin, const int zbin, const int nzbins, const double nelec)
+{
+  PHG4CylinderCell *&cell = cellindex[phibin * nzbins + zbin];
+  if(!cell)
+  {
+    cell = new PHG4CylinderCellv1();
+    cell->set_layer(layer);
+    cell->set_phibin(phibin);
+    cell->set_zbin(zbin);
+  }
+  cell->add_edep(hitid, nelec);
+}
+
+
+void PHG4CylinderCellTPCReco::deposit_electrons(const PHG4HitDefs::keytype hitid, const int layer, const int phibin, const int zbin, const int nphibins, const int nzbins, const int n_phi, const int n_z, const double xdisp, const double zdisp, const double xstep, const double zstep, const double sigma_x, const double sigma_z, const double nelec)
+{
+  // every electron drifts on its own, counted in the (2n_phi+1) x (2n_z+1) window around the hit first
+  int nx = 2*n_phi + 1;
+  int nz = 2*n_z + 1;
+  electron_count.assign(nx*nz, 0);
+  int ne = rand.Poisson(nelec);
+  for( int ie = 0; ie < ne; ++ie )
+  {
+    int iphi = (int)floor((xdisp + rand.Gaus(0., sigma_x))/xstep + 0.5);
+    int iz = (int)floor((zdisp + rand.Gaus(0., sigma_z))/zstep + 0.5);
+    if( iphi < -n_phi || iphi > n_phi || iz < -n_z || iz > n_z ){continue;}
+    electron_count[(iphi + n_phi)*nz + iz + n_z]++;
+  }
+  for( int iphi = -n_phi; iphi <= n_phi; ++iphi )
+  {
+    int cur_phi_bin = phibin + iphi;
+    if( cur_phi_bin < 0 ){cur_phi_bin += nphibins;}
+    else if( cur_phi_bin >= nphibins ){cur_phi_bin -= nphibins;}
+    
+    if( (cur_phi_bin < 0) || (cur_phi_bin >= nphibins) ){continue;}
+    
+    for( int iz = -n_z; iz <= n_z; ++iz )
+    {
+      int cur_z_bin = zbin + iz;if( (cur_z_bin < 0) || (cur_z_bin >= nzbins) ){continue;}
+      
+      int count = electron_count[(iphi + n_phi)*nz + iz + n_z];
+      if( count == 0 ){continue;}
+      
+      add_electrons( hitid, layer, cur_phi_bin, cur_z_bin, nzbins, count );
+    }
+  }
+}
+
+
 void PHG4CylinderCellTPCReco::Detector(const std::string &d)
 {
   detector = d;
@@ -175,32 +273,46 @@ int PHG4CylinderCellTPCReco::process_event(PHCompositeNode *topNode)
   
   for(layer = layer_begin_end.first; layer != layer_begin_end.second; layer++)
   {
-    std::map<std::string, PHG4CylinderCell*> cellptmap;
     PHG4HitContainer::ConstIterator hiter;
     PHG4HitContainer::ConstRange hit_begin_end = g4hit->getHits(*layer);
     PHG4CylinderCellGeom *geo = seggeo->GetLayerCellGeom(*layer);
     int nphibins = n_phi_z_bins[*layer].first;
     int nzbins = n_phi_z_bins[*layer].second;
+    cellindex.clear(static_cast<PHG4CylinderCellIndex::keytype>(nphibins) * nzbins);
     
     sizeiter = cell_size.find(*layer);
     if (sizeiter == cell_size.end()){cout << "logical screwup!!! no sizes for layer " << *layer << endl;exit(1);}
     double zstepsize = (sizeiter->second).second;
     double phistepsize = phistep[*layer];
-    for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; hiter++)
+    
+    // bin the entry points of all hits of the layer at once
+    unsigned int nhits = distance(hit_begin_end.first, hit_begin_end.second);
+    if(nhits == 0){continue;}
+    hit_x.resize(nhits);hit_y.resize(nhits);hit_z.resize(nhits);hit_phi.resize(nhits);hit_zeta.resize(nhits);
+    hit_phibin.resize(nhits);hit_zbin.resize(nhits);
+    unsigned int ihit = 0;
+    for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; hiter++, ihit++)
+    {
+      hit_x[ihit] = hiter->second->get_x(0);
+      hit_y[ihit] = hiter->second->get_y(0);
+      hit_z[ihit] = hiter->second->get_z(0);
+    }
+    geo->find_bins(nhits, &hit_x[0], &hit_y[0], &hit_z[0], &hit_phi[0], &hit_zeta[0], &hit_phibin[0], &hit_zbin[0]);
+    
+    ihit = 0;
+    for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; hiter++, ihit++)
     {
-      double xinout;double yinout;double px;double py;double phi;double z;int phibin;int zbin;
-      xinout = hiter->second->get_x(0);
-      yinout = hiter->second->get_y(0);
+      double xinout;double yinout;double phi;double z;int phibin;int zbin;
+      xinout = hit_x[ihit];
+      yinout = hit_y[ihit];
       double r = sqrt( xinout*xinout + yinout*yinout );
-      px = hiter->second->get_px(0);
-      py = hiter->second->get_py(0);
-      phi = atan2(hiter->second->get_y(0), hiter->second->get_x(0));
-      z =  hiter->second->get_z(0);
-      phibin = geo->get_phibin( phi );
+      phi = hit_phi[ihit];
+      z =  hit_z[ihit];
+      phibin = hit_phibin[ihit];
       if(phibin < 0 || phibin >= nphibins){continue;}
       double phidisp = phi - geo->get_phicenter(phibin);
       
-      zbin = geo->get_zbin( hiter->second->get_z(0) );
+      zbin = hit_zbin[ihit];
       if(zbin < 0 || zbin >= nzbins){continue;}
       double zdisp = z - geo->get_zcenter(zbin);
       
@@ -208,34 +320,39 @@ int PHG4CylinderCellTPCReco::process_event(PHCompositeNode *topNode)
       
       if( (*layer) < 2 )
       {
-        char inkey[1024];
-        sprintf(inkey,"%i-%i",phibin,zbin);
-        std::string key(inkey);
-        if(cellptmap.count(key) > 0){cellptmap.find(key)->second->add_edep(hiter->first, edep);}
-        else
+        PHG4CylinderCell *&cell = cellindex[phibin * nzbins + zbin];
+        if(!cell)
         {
-          cellptmap[key] = new PHG4CylinderCellv1();
-          std::map<std::string, PHG4CylinderCell*>::iterator it = cellptmap.find(key);
-          it->second->set_layer(*layer);
-          it->second->set_phibin(phibin);
-          it->second->set_zbin(zbin);
-          it->second->add_edep(hiter->first, edep);
+          cell = new PHG4CylinderCellv1();
+          cell->set_layer(*layer);
+          cell->set_phibin(phibin);
+          cell->set_zbin(zbin);
         }
+        cell->add_edep(hiter->first, edep);
       }
       else
       {
         double nelec = elec_per_kev*1.0e6*edep;
+        double drift_z = fabs(hiter->second->get_z(0));
 
-        double cloud_sig_x = 1.5*sqrt( diffusion*diffusion*(100. - TMath::Abs(hiter->second->get_z(0))) + 0.03*0.03 );
-        double cloud_sig_z = 1.5*sqrt((1.+2.2*2.2)*diffusion*diffusion*(80. - TMath::Abs(hiter->second->get_z(0))) + 0.03*0.03 );
+        double cloud_sig_x = 1.5*sqrt( diffusion*diffusion*(100. - drift_z) + 0.03*0.03 );
+        double cloud_sig_z = 1.5*sqrt((1.+2.2*2.2)*diffusion*diffusion*(80. - drift_z) + 0.03*0.03 );
         
         int n_phi = (int)(3.*( cloud_sig_x/(r*phistepsize) )) + 1;
         int n_z = (int)(3.*( cloud_sig_z/zstepsize )) + 1;
         
-        double cloud_sig_x_inv = 1./cloud_sig_x;
-        double cloud_sig_z_inv = 1./cloud_sig_z;
-        
         // we will store effective number of electrons instead of edep
+        if( electron_diffusion )
+        {
+          deposit_electrons( hiter->first, *layer, phibin, zbin, nphibins, nzbins, n_phi, n_z,
+                             phidisp*r, zdisp, phistepsize*r, zstepsize, cloud_sig_x, cloud_sig_z, nelec );
+          continue;
+        }
+        
+        // fraction of the cloud in each phi and z bin around the hit
+        bin_fractions( phidisp*r, phistepsize*r, cloud_sig_x, n_phi, phi_fraction );
+        bin_fractions( zdisp, zstepsize, cloud_sig_z, n_z, z_fraction );
+        
         for( int iphi = -n_phi; iphi <= n_phi; ++iphi )
         {
           int cur_phi_bin = phibin + iphi;
@@ -243,39 +360,24 @@ int PHG4CylinderCellTPCReco::process_event(PHCompositeNode *topNode)
           else if( cur_phi_bin >= nphibins ){cur_phi_bin -= nphibins;}
           
           if( (cur_phi_bin < 0) || (cur_phi_bin >= nphibins) ){continue;}
-        
           
-          double phi_integral = 0.5*erf(-0.5*sqrt(2.)*phidisp*r*cloud_sig_x_inv + 0.5*sqrt(2.)*( (0.5 + (double)iphi)*phistepsize*r )*cloud_sig_x_inv) - 0.5*erf(-0.5*sqrt(2.)*phidisp*r*cloud_sig_x_inv + 0.5*sqrt(2.)*( (-0.5 + (double)iphi)*phistepsize*r )*cloud_sig_x_inv);
+          double phi_electrons = nelec*phi_fraction[iphi + n_phi];
           
           for( int iz = -n_z; iz <= n_z; ++iz )
           {
             int cur_z_bin = zbin + iz;if( (cur_z_bin < 0) || (cur_z_bin >= nzbins) ){continue;}
             
-            double z_integral = 0.5*erf(-0.5*sqrt(2.)*zdisp*r*cloud_sig_z_inv + 0.5*sqrt(2.)*( (0.5 + (double)iz)*zstepsize*r )*cloud_sig_z_inv) - 0.5*erf(-0.5*sqrt(2.)*zdisp*r*cloud_sig_z_inv + 0.5*sqrt(2.)*( (-0.5 + (double)iz)*zstepsize*r )*cloud_sig_z_inv);
-            
-            double total_weight = rand.Poisson( nelec*( phi_integral * z_integral ) );
+            double total_weight = rand.Poisson( phi_electrons*z_fraction[iz + n_z] );
             
-            if( !(total_weight == total_weight) ){continue;}
+            if( !(total_weight > 0) ){continue;}
             
-            char inkey[1024];
-            sprintf(inkey,"%i-%i",cur_phi_bin,cur_z_bin);
-            std::string key(inkey);
-            if(cellptmap.count(key) > 0){cellptmap.find(key)->second->add_edep(hiter->first, total_weight);}
-            else
-            {
-              cellptmap[key] = new PHG4CylinderCellv1();
-              std::map<std::string, PHG4CylinderCell*>::iterator it = cellptmap.find(key);
-              it->second->set_layer(*layer);
-              it->second->set_phibin(cur_phi_bin);
-              it->second->set_zbin(cur_z_bin);
-              it->second->add_edep(hiter->first, total_weight);
-            }
+            add_electrons( hiter->first, *layer, cur_phi_bin, cur_z_bin, nzbins, total_weight );
           }
         }
       }
     }
     int count = 0;
-    for(std::map<std::string, PHG4CylinderCell*>::iterator it = cellptmap.begin(); it != cellptmap.end(); ++it)
+    for(PHG4CylinderCellIndex::ConstIterator it = cellindex.begin(); it != cellindex.end(); ++it)
     {
       cells->AddCylinderCell((unsigned int)(*layer), it->second);
       count += 1;
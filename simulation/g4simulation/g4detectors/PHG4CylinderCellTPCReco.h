@@ -1,10 +1,14 @@
 #ifndef PHG4CYLINDERCELLTPCRECO_H
 #define PHG4CYLINDERCELLTPCRECO_H
 
+#include "PHG4CylinderCellIndex.h"
+
+#include <g4main/PHG4HitDefs.h>
 #include <fun4all/SubsysReco.h>
 #include <phool/PHTimeServer.h>
 #include <string>
 #include <map>
+#include <vector>
 #include "TRandom3.h"
 
 class PHCompositeNode;
@@ -38,6 +42,8 @@ public:
 
   void setDiffusion( double diff ){diffusion = diff;}
   void setElectronsPerKeV( double epk ){elec_per_kev = epk;}
+  //! diffuse every electron on its own instead of sampling the cloud integral per cell (slower, keeps the correlations)
+  void setElectronDiffusion( const bool b = true ){electron_diffusion = b;}
   
 protected:
 //   void set_size(const int i, const double sizeA, const double sizeB, const int what);
@@ -47,6 +53,11 @@ protected:
 //   bool lines_intersect( double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy, double* rx, double* ry);
 //   bool line_and_rectangle_intersect( double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy, double* rr);
   
+  //! fraction of a gaussian (sigma) centered at disp from the center of bin 0 in the bins -n..n
+  static void bin_fractions(const double disp, const double binwidth, const double sigma, const int n, std::vector<double> &fraction);
+  void add_electrons(const PHG4HitDefs::keytype hitid, const int layer, const int phibin, const int zbin, const int nzbins, const double nelec);
+  void deposit_electrons(const PHG4HitDefs::keytype hitid, const int layer, const int phibin, const int zbin, const int nphibins, const int nzbins, const int n_phi, const int n_z, const double xdisp, const double zdisp, const double xstep, const double zstep, const double sigma_x, const double sigma_z, const double nelec);
+  
   std::map<int, int>  binning;
   std::map<int, std::pair <double,double> > cell_size; // cell size in phi/z
   std::map<int, std::pair <double,double> > zmin_max; // zmin/zmax for each layer for faster lookup
@@ -59,6 +70,7 @@ protected:
   std::string geonodename;
   std::string seggeonodename;
   std::map<int, std::pair<int, int> > n_phi_z_bins;
+  PHG4CylinderCellIndex cellindex;  // the hit cells of the current layer by phibin * nzbins + zbin
   
   int nbins[2];
   int chkenergyconservation;
@@ -67,6 +79,14 @@ protected:
 
   double diffusion;
   double elec_per_kev;
+  bool electron_diffusion;
+  
+  // scratch space reused for every hit and layer
+  std::vector<double> phi_fraction;
+  std::vector<double> z_fraction;
+  std::vector<int> electron_count;
+  std::vector<double> hit_x, hit_y, hit_z, hit_phi, hit_zeta;
+  std::vector<int> hit_phibin, hit_zbin;
   
 };
 
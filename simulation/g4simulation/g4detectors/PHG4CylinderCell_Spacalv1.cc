@@ -30,3 +30,14 @@ PHG4CylinderCell_Spacalv1::~PHG4CylinderCell_Spacalv1()
 {
   // TODO Auto-generated destructor stub
 }
+
+double
+PHG4CylinderCell_Spacalv1::get_edep() const
+{
+  double esum = PHG4CylinderCellv1::get_edep();
+  for (TrackEdepConstIterator iter = track_edeps.begin(); iter != track_edeps.end(); ++iter)
+    {
+      esum += iter->second;
+    }
+  return esum;
+}
@@ -36,14 +36,34 @@ public:
     fiber_ID = fiberId;
   }
 
+  //! energy of the g4hits and of the G4 tracks
+  double
+  get_edep() const;
+
+  //! direct cells have no g4hits, the energy is kept per G4 track id
+  TrackEdepConstRange
+  get_g4tracks() const
+  {
+    return make_pair(track_edeps.begin(), track_edeps.end());
+  }
+
+  void
+  add_track_edep(const int trkid, const float edep)
+  {
+    track_edeps[trkid] += edep;
+  }
+
 
 protected:
 
   //! Group hit into each fiber, so we allow fiber-fiber variation studies off-Geant production.
   int fiber_ID;
 
+  //! energy by G4 track id, filled instead of the g4hits in direct cell mode
+  TrackEdepMap track_edeps;
+
 
-ClassDef(PHG4CylinderCell_Spacalv1,1)
+ClassDef(PHG4CylinderCell_Spacalv1,2)
 
 };
 
@@ -161,6 +161,29 @@ PHG4CylinderGeom_Spacalv3::get_tower_z_phi_ID(const int tower_ID,
   return make_pair<int, int>(z_bin, phi_bin);
 }
 
+void
+PHG4CylinderGeom_Spacalv3::get_tower_z_phi_tables(vector<int> &z_IDs,
+    vector<int> &phi_IDs_in_sec) const
+{
+  z_IDs.clear();
+  phi_IDs_in_sec.clear();
+  if (sector_tower_map.empty())
+    return;
+
+  // tower_IDs are positive and sorted in the map
+  const int n_tower_IDs = sector_tower_map.rbegin()->first + 1;
+  z_IDs.resize(n_tower_IDs, -1);
+  phi_IDs_in_sec.resize(n_tower_IDs, -1);
+
+  for (tower_map_t::const_iterator it = sector_tower_map.begin();
+      it != sector_tower_map.end(); ++it)
+    {
+      const pair<int, int> z_phi_ID = get_tower_z_phi_ID(it->first, 0);
+      z_IDs[it->first] = z_phi_ID.first;
+      phi_IDs_in_sec[it->first] = z_phi_ID.second;
+    }
+}
+
 void
 PHG4CylinderGeom_Spacalv3::load_demo_sector_tower_map1()
 {
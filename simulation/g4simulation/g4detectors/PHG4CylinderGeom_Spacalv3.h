@@ -14,6 +14,7 @@
 #include <string>
 #include <map>
 #include <utility>      // std::pair, std::make_pair
+#include <vector>
 
 
 class PHG4CylinderGeom_Spacalv3 : public PHG4CylinderGeom_Spacalv2
@@ -177,6 +178,9 @@ public:
   //! @return: a std::pair of zbin and phibin number
   virtual std::pair<int,int> get_tower_z_phi_ID(const int tower_ID, const int sector_ID) const;
 
+  //! z ID and phi ID in the sector (get_tower_z_phi_ID() for sector 0) of all towers in sector_tower_map as dense tables indexed by tower_ID, -1 for tower_IDs without a tower
+  void get_tower_z_phi_tables(std::vector<int> &z_IDs, std::vector<int> &phi_IDs_in_sec) const;
+
 protected:
   double sidewall_thickness;
   double sidewall_outer_torr;
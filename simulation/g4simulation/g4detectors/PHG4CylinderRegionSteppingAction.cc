@@ -3,7 +3,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 
 #include <phool/getClass.h>
 
@@ -42,7 +42,7 @@ void PHG4CylinderRegionSteppingAction::UserSteppingAction( const G4Step* aStep)
         {
         case fGeomBoundary:
         case fUndefined:
-          hit = new PHG4Hitv1();
+          hit = new PHG4Hitv2();
           //here we set the entrance values in cm
 	  hit->set_layer((unsigned int)layer_id);
           hit->set_x( 0, prePoint->GetPosition().x() / cm);
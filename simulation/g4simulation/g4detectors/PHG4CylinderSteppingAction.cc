@@ -3,7 +3,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 
 #include <g4main/PHG4TrackUserInfoV1.h>
 
@@ -19,11 +19,27 @@ using namespace std;
 PHG4CylinderSteppingAction::PHG4CylinderSteppingAction( PHG4CylinderDetector* detector ):
   detector_( detector ),
   hits_(NULL),
+  worker_hits_(NULL),
   hit(NULL),
   zmin(NAN),
   zmax(NAN)
 {}
 
+//____________________________________________________________________________..
+PHG4CylinderSteppingAction::~PHG4CylinderSteppingAction()
+{
+  delete worker_hits_;
+}
+
+//____________________________________________________________________________..
+void PHG4CylinderSteppingAction::UseWorkerHitBuffer()
+{
+  if (!worker_hits_)
+    {
+      worker_hits_ = new PHG4HitContainer();
+    }
+}
+
 //____________________________________________________________________________..
 bool PHG4CylinderSteppingAction::UserSteppingAction( const G4Step* aStep, bool )
 {
@@ -74,7 +90,7 @@ bool PHG4CylinderSteppingAction::UserSteppingAction( const G4Step* aStep, bool )
         case fGeomBoundary:
         case fUndefined:
 
-          hit = new PHG4Hitv1();
+          hit = new PHG4Hitv2();
 
 	  hit->set_layer((unsigned int)layer_id);
 
@@ -106,7 +122,14 @@ bool PHG4CylinderSteppingAction::UserSteppingAction( const G4Step* aStep, bool )
 
           // Now add the hit
 	  //	  hit->print();
-          hits_->AddHit(layer_id, hit);
+          if (worker_hits_)
+	    {
+	      worker_hits_->AddHit(layer_id, hit);
+	    }
+	  else
+	    {
+	      hits_->AddHit(layer_id, hit);
+	    }
 	  if (hit->get_z(0) > zmax || hit->get_z(0) < zmin)
 	    {
 	      cout << "PHG4CylinderSteppingAction: hit outside acceptance, layer: " << layer_id << endl;
@@ -181,3 +204,29 @@ void PHG4CylinderSteppingAction::SetInterfacePointers( PHCompositeNode* topNode
     { std::cout << "PHG4CylinderSteppingAction::SetTopNode - unable to find " << hitnodename << std::endl; }
 
 }
+
+//____________________________________________________________________________..
+void PHG4CylinderSteppingAction::FlushWorkerOutput()
+{
+  if (!worker_hits_)
+    {
+      return;
+    }
+  if (hits_)
+    {
+      // the hit ids of the workers overlap, AddHit assigns new ones
+      PHG4HitContainer::ConstRange range = worker_hits_->getHits();
+      for (PHG4HitContainer::ConstIterator iter = range.first; iter != range.second; ++iter)
+	{
+	  hits_->AddHit(iter->second->get_layer(), new PHG4Hitv2(*(iter->second)));
+	}
+    }
+  worker_hits_->Reset();
+  hit = NULL;
+}
+
+//____________________________________________________________________________..
+int PHG4CylinderSteppingAction::HandlesVolume( G4VPhysicalVolume *volume )
+{
+  return (detector_->IsInCylinder(volume)) ? 1 : 0;
+}
@@ -4,6 +4,7 @@
 #include "g4main/PHG4SteppingAction.h"
 #include <string>
 
+class G4VPhysicalVolume;
 class PHG4CylinderDetector;
 class PHG4Hit;
 class PHG4HitContainer;
@@ -17,17 +18,27 @@ class PHG4CylinderSteppingAction : public PHG4SteppingAction
   PHG4CylinderSteppingAction( PHG4CylinderDetector* );
 
   //! destroctor
-  virtual ~PHG4CylinderSteppingAction()
-  {}
+  virtual ~PHG4CylinderSteppingAction();
 
   //! stepping action
   virtual bool UserSteppingAction(const G4Step*, bool);
 
+  //! reimplemented from base class
+  virtual int HandlesVolume(G4VPhysicalVolume *volume);
+
   //! reimplemented from base class
   virtual void SetInterfacePointers( PHCompositeNode* );
 
+  //! reimplemented from base class, moves the hits of the worker buffer to the node tree
+  virtual void FlushWorkerOutput();
+
+  //! keep the hits in a private buffer (for G4 worker threads)
+  void UseWorkerHitBuffer();
+
   void set_zmin(const float z) {zmin = z;}
   void set_zmax(const float z) {zmax = z;}
+  float get_zmin() const {return zmin;}
+  float get_zmax() const {return zmax;}
 
   private:
 
@@ -36,6 +47,9 @@ class PHG4CylinderSteppingAction : public PHG4SteppingAction
 
   //! pointer to hit container
   PHG4HitContainer * hits_;
+
+  //! thread local hit buffer of a worker (NULL in sequential running)
+  PHG4HitContainer * worker_hits_;
   PHG4Hit *hit;
   float zmin;
   float zmax;
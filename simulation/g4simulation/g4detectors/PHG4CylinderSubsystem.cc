@@ -141,4 +141,18 @@ PHG4SteppingAction* PHG4CylinderSubsystem::GetSteppingAction( void ) const
   return steppingAction_;
 }
 
+//_______________________________________________________________________
+PHG4SteppingAction* PHG4CylinderSubsystem::CreateWorkerSteppingAction( void ) const
+{
+  if (!steppingAction_)
+    {
+      return NULL;
+    }
+  PHG4CylinderSteppingAction *action = new PHG4CylinderSteppingAction(detector_);
+  action->set_zmin(steppingAction_->get_zmin());
+  action->set_zmax(steppingAction_->get_zmax());
+  action->UseWorkerHitBuffer();
+  return action;
+}
+
 
@@ -40,6 +40,7 @@ class PHG4CylinderSubsystem: public PHG4Subsystem
   //! accessors (reimplemented)
   virtual PHG4Detector* GetDetector( void ) const;
   virtual PHG4SteppingAction* GetSteppingAction( void ) const;
+  virtual PHG4SteppingAction* CreateWorkerSteppingAction( void ) const;
   PHG4EventAction* GetEventAction() const {return eventAction_;}
 
   void SetRadius(const G4double dbl) {radius = dbl;}
@@ -3,7 +3,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 
 #include <g4main/PHG4TrackUserInfoV1.h>
 
@@ -86,7 +86,7 @@ bool PHG4EnvelopeSteppingAction::UserSteppingAction( const G4Step* aStep, bool )
 		{
 			case fGeomBoundary:
 			case fUndefined:
-				hit = new PHG4Hitv1();
+				hit = new PHG4Hitv2();
 				//	  hit->set_layer(0);
 				hit->set_scint_id(tower_id);
 
@@ -192,3 +192,9 @@ void PHG4EnvelopeSteppingAction::SetInterfacePointers( PHCompositeNode* topNode
 	
 	
 }
+
+//____________________________________________________________________________..
+int PHG4EnvelopeSteppingAction::HandlesVolume( G4VPhysicalVolume *volume )
+{
+  return (detector_->IsInEnvelope(volume)) ? 1 : 0;
+}
@@ -4,6 +4,7 @@
 #include <g4main/PHG4SteppingAction.h>
 #include <Geant4/G4Step.hh>
 
+class G4VPhysicalVolume;
 class PHG4EnvelopeDetector;
 class PHG4Hit;
 class PHG4HitContainer;
@@ -20,6 +21,9 @@ class PHG4EnvelopeSteppingAction: public PHG4SteppingAction
 	
 		//Stepping Action
 		virtual bool UserSteppingAction( const G4Step*, bool);
+
+		//! reimplemented from base class
+		virtual int HandlesVolume(G4VPhysicalVolume *volume);
 	
 		//reimplemented from base class
 		virtual void SetInterfacePointers( PHCompositeNode* );
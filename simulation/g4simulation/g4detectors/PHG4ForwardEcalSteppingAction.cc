@@ -3,7 +3,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 
 #include <g4main/PHG4TrackUserInfoV1.h>
 
@@ -113,7 +113,7 @@ bool PHG4ForwardEcalSteppingAction::UserSteppingAction( const G4Step* aStep, boo
 	{
 	case fGeomBoundary:
 	case fUndefined:
-	  hit = new PHG4Hitv1();
+	  hit = new PHG4Hitv2();
 	  hit->set_scint_id(tower_id);
 
 	  /* Set hit location (tower index) */
@@ -271,3 +271,71 @@ PHG4ForwardEcalSteppingAction::ParseG4VolumeName( G4VPhysicalVolume* volume, int
 
 	return 0;
 }
+
+//____________________________________________________________________________..
+int PHG4ForwardEcalSteppingAction::HandlesVolume( G4VPhysicalVolume *volume )
+{
+  return (detector_->IsInForwardEcal(volume) != 0) ? 1 : 0;
+}
+
+//____________________________________________________________________________..
+int PHG4ForwardEcalSteppingAction::ShowerDepositType( G4VPhysicalVolume *volume )
+{
+  int whichactive = detector_->IsInForwardEcal(volume);
+  if (whichactive > 0)
+    {
+      return 1;
+    }
+  else if (whichactive < 0)
+    {
+      return 0;
+    }
+  return -1;
+}
+
+//____________________________________________________________________________..
+bool PHG4ForwardEcalSteppingAction::AddShowerDeposit( const G4VTouchable *touchable, const double x, const double y, const double z,
+						      const double t, const double edep, const double, const bool active, const int trkid )
+{
+  int whichactive = detector_->IsInForwardEcal(touchable->GetVolume());
+  if ( !whichactive || !detector_->IsActive() )
+    {
+      return false;
+    }
+
+  PHG4HitContainer *container = active ? hits_ : absorberhits_;
+  if ( !container )
+    {
+      /* absorber hits are not stored */
+      return true;
+    }
+
+  PHG4Hit *showerhit = new PHG4Hitv2();
+  showerhit->set_scint_id(touchable->GetCopyNumber());
+
+  /* an active deposit located in the absorber goes to the tower containing it,
+   * absorber and scintillator plates are both placed in the tower volume */
+  int idx_j = -1;
+  int idx_k = -1;
+  if (active)
+    {
+      ParseG4VolumeName(touchable->GetVolume(1), idx_j, idx_k);
+    }
+  showerhit->set_index_j(idx_j);
+  showerhit->set_index_k(idx_k);
+  showerhit->set_index_l(-1);
+
+  for (int i = 0; i < 2; i++)
+    {
+      showerhit->set_x( i, x );
+      showerhit->set_y( i, y );
+      showerhit->set_z( i, z );
+      showerhit->set_t( i, t );
+    }
+  showerhit->set_trkid(trkid);
+  showerhit->set_edep( edep );
+  showerhit->set_eion( edep );
+
+  container->AddHit(detector_->get_Layer(), showerhit);
+  return true;
+}
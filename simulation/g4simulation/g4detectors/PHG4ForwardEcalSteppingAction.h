@@ -5,6 +5,7 @@
 #include <Geant4/G4Step.hh>
 
 
+class G4VPhysicalVolume;
 class PHG4ForwardEcalDetector;
 class PHG4Hit;
 class PHG4HitContainer;
@@ -24,9 +25,19 @@ public:
   //! stepping action
   virtual bool UserSteppingAction(const G4Step*, bool);
 
+  //! reimplemented from base class
+  virtual int HandlesVolume(G4VPhysicalVolume *volume);
+
   //! reimplemented from base class
   virtual void SetInterfacePointers( PHCompositeNode* );
 
+  //! reimplemented from base class, the scintillator plates are active
+  virtual int ShowerDepositType(G4VPhysicalVolume *volume);
+
+  //! reimplemented from base class
+  virtual bool AddShowerDeposit(const G4VTouchable *touchable, const double x, const double y, const double z,
+				const double t, const double edep, const double light_yield, const bool active, const int trkid);
+
 private:
 
   int FindTowerIndex(G4TouchableHandle touch, int& j, int& k);
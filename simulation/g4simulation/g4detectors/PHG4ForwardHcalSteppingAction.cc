@@ -3,7 +3,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 
 #include <g4main/PHG4TrackUserInfoV1.h>
 
@@ -113,7 +113,7 @@ bool PHG4ForwardHcalSteppingAction::UserSteppingAction( const G4Step* aStep, boo
 	{
 	case fGeomBoundary:
 	case fUndefined:
-	  hit = new PHG4Hitv1();
+	  hit = new PHG4Hitv2();
 	  hit->set_scint_id(tower_id);
 
 	  /* Set hit location (tower index) */
@@ -271,3 +271,9 @@ PHG4ForwardHcalSteppingAction::ParseG4VolumeName( G4VPhysicalVolume* volume, int
 
 	return 0;
 }
+
+//____________________________________________________________________________..
+int PHG4ForwardHcalSteppingAction::HandlesVolume( G4VPhysicalVolume *volume )
+{
+  return (detector_->IsInForwardHcal(volume) != 0) ? 1 : 0;
+}
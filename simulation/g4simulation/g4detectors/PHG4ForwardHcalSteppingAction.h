@@ -5,6 +5,7 @@
 #include <Geant4/G4Step.hh>
 
 
+class G4VPhysicalVolume;
 class PHG4ForwardHcalDetector;
 class PHG4Hit;
 class PHG4HitContainer;
@@ -24,6 +25,9 @@ public:
   //! stepping action
   virtual bool UserSteppingAction(const G4Step*, bool);
 
+  //! reimplemented from base class
+  virtual int HandlesVolume(G4VPhysicalVolume *volume);
+
   //! reimplemented from base class
   virtual void SetInterfacePointers( PHCompositeNode* );
 
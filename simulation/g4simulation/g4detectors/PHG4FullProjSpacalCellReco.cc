@@ -9,6 +9,7 @@
 #include "PHG4CylinderCellContainer.h"
 #include "PHG4CylinderCellDefs.h"
 
+#include <g4main/PHG4CellAccumulator.h>
 #include <g4main/PHG4Hit.h>
 #include <g4main/PHG4HitContainer.h>
 #include <fun4all/Fun4AllReturnCodes.h>
@@ -24,7 +25,6 @@
 #include <sstream>
 #include <cassert>
 #include <boost/foreach.hpp>
-#include <exception>
 
 using namespace std;
 
@@ -56,6 +56,8 @@ PHG4FullProjSpacalCellReco::InitRun(PHCompositeNode *topNode)
       cout << "Could not locate g4 hit node " << hitnodename << endl;
       exit(1);
     }
+  // only present if the stepping action sums the deposits directly into cells
+  cellaccnodename = "G4CELLACC_" + detector;
   cellnodename = "G4CELL_" + detector;
   PHG4CylinderCellContainer *cells = findNode::getClass<
       PHG4CylinderCellContainer>(topNode, cellnodename);
@@ -107,6 +109,7 @@ PHG4FullProjSpacalCellReco::InitRun(PHCompositeNode *topNode)
       map<int, PHG4CylinderGeom *>::const_iterator> begin_end =
       geo->get_begin_end();
   map<int, std::pair<double, int> >::iterator sizeiter;
+  tower_tables.clear();
   for (miter = begin_end.first; miter != begin_end.second; ++miter)
     {
       const PHG4CylinderGeom *layergeom_raw = miter->second;
@@ -201,6 +204,19 @@ PHG4FullProjSpacalCellReco::InitRun(PHCompositeNode *topNode)
       layerseggeo->set_etamin(NAN);
       layerseggeo->set_etastep(NAN);
 
+      // dense tower_ID -> eta bin, phi bin tables for the per fiber lookups
+      TowerTable &table = tower_tables[layergeom->get_layer()];
+      layergeom->get_tower_z_phi_tables(table.etabin, table.phibin_in_sec);
+      table.max_phi_bin_in_sec = layergeom->get_max_phi_bin_in_sec();
+      for (vector<int>::iterator it = table.etabin.begin(); it != table.etabin.end(); ++it)
+        {
+          if (*it < 0)
+            continue;
+          PHG4CylinderCellGeom_Spacalv1::tower_z_ID_eta_bin_map_t::const_iterator bin =
+              tower_z_ID_eta_bin_map.find(*it);
+          *it = (bin != tower_z_ID_eta_bin_map.end()) ? bin->second : -1;
+        }
+
       //build eta bin maps
       BOOST_FOREACH(const PHG4CylinderGeom_Spacalv3::tower_map_t::value_type& tower_pair, tower_map)
         {
@@ -278,24 +294,17 @@ PHG4FullProjSpacalCellReco::process_event(PHCompositeNode *topNode)
       exit(1);
     }
 
-  PHG4CylinderCellGeomContainer *seggeo = findNode::getClass<
-      PHG4CylinderCellGeomContainer>(topNode, seggeonodename.c_str());
-  if (!seggeo)
-    {
-      cout
-          << "PHG4FullProjSpacalCellReco::process_event - Fatal Error - could not locate cell geometry node "
-          << seggeonodename << endl;
-      exit(1);
-    }
-
-  PHG4CylinderGeomContainer *layergeo = findNode::getClass<
-      PHG4CylinderGeomContainer>(topNode, geonodename.c_str());
-  if (!layergeo)
+  PHG4CellAccumulator *cellacc = findNode::getClass<PHG4CellAccumulator>(
+      topNode, cellaccnodename);
+  if (cellacc)
     {
-      cout
-          << "PHG4FullProjSpacalCellReco::process_event - Fatal Error - Could not locate sim geometry node "
-          << geonodename << endl;
-      exit(1);
+      FillFromAccumulator(cellacc, cells);
+      if (chkenergyconservation or verbosity > 4)
+        {
+          CheckEnergy(topNode);
+        }
+      _timer.get()->stop();
+      return Fun4AllReturnCodes::EVENT_OK;
     }
 
   PHG4HitContainer::LayerIter layer;
@@ -307,68 +316,25 @@ PHG4FullProjSpacalCellReco::process_event(PHCompositeNode *topNode)
       PHG4HitContainer::ConstIterator hiter;
       PHG4HitContainer::ConstRange hit_begin_end = g4hit->getHits(*layer);
 
-      PHG4CylinderCellGeom *geo_raw = seggeo->GetLayerCellGeom(*layer);
-      PHG4CylinderCellGeom_Spacalv1 * geo =
-          dynamic_cast<PHG4CylinderCellGeom_Spacalv1 *>(geo_raw);
-      assert(geo);
-
-      const PHG4CylinderGeom *layergeom_raw = layergeo->GetLayerGeom(*layer);
-      assert(layergeom_raw);
-      // a special implimentation of PHG4CylinderGeom is required here.
-      const PHG4CylinderGeom_Spacalv3 *layergeom =
-          dynamic_cast<const PHG4CylinderGeom_Spacalv3 *>(layergeom_raw);
-      assert(layergeom);
+      const TowerTable &table = GetTowerTable(*layer);
 
       for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; ++hiter)
         {
           // hit loop
           int scint_id = hiter->second->get_scint_id();
 
-          unsigned int key = static_cast<unsigned int>(scint_id);
-          if (celllist.find(key) == celllist.end())
+          PHG4CylinderCell *&cell = celllist[static_cast<unsigned int>(scint_id)];
+          if (!cell)
             {
-              // decode scint_id
-              PHG4CylinderGeom_Spacalv3::scint_id_coder decoder(scint_id);
-
-              // convert to z_ID, phi_ID
-              std::pair<int, int> tower_z_phi_ID =
-                  layergeom->get_tower_z_phi_ID(decoder.tower_ID,
-                      decoder.sector_ID);
-              const int & tower_ID_z = tower_z_phi_ID.first;
-              const int & tower_ID_phi = tower_z_phi_ID.second;
-
-              // convert tower_ID_z to to eta bin number
-              int etabin = -1;
-              try
-                {
-                  etabin = geo->get_etabin(tower_ID_z);
-                }
-              catch (exception & e)
-                {
-                  cout << "Print cell geometry:" << endl;
-                  geo->identify();
-                  cout << "Print scint_id_coder:" << endl;
-                  decoder.identify();
-                  cout << "Print the hit:" << endl;
-                  hiter->second->print();
-                  cout << "PHG4FullProjSpacalCellReco::process_event::" << Name()
-                      << " - Fatal Error - " << e.what() << endl;
-                  exit(1);
-                }
-
-              celllist[key] = new PHG4CylinderCell_Spacalv1();
-              celllist[key]->set_layer(*layer);
-              celllist[key]->set_phibin(tower_ID_phi);
-              celllist[key]->set_etabin(etabin);
-              celllist[key]->set_fiber_ID(decoder.fiber_ID);
+              cell = MakeCell(*layer, scint_id, table);
             }
 
-          celllist[key]->add_edep(hiter->first, hiter->second->get_edep(),
+          cell->add_edep(hiter->first, hiter->second->get_edep(),
               hiter->second->get_light_yield());
 
         } // end loop over g4hits
       int numcells = 0;
-      for (map<unsigned int, PHG4CylinderCell *>::const_iterator mapiter =
+      for (PHG4CylinderCellIndex::ConstIterator mapiter =
           celllist.begin(); mapiter != celllist.end(); ++mapiter)
         {
           cells->AddCylinderCell(*layer, mapiter->second);
@@ -402,6 +368,90 @@ PHG4FullProjSpacalCellReco::process_event(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+const PHG4FullProjSpacalCellReco::TowerTable &
+PHG4FullProjSpacalCellReco::GetTowerTable(const int layer) const
+{
+  map<int, TowerTable>::const_iterator iter = tower_tables.find(layer);
+  if (iter == tower_tables.end())
+    {
+      cout << "PHG4FullProjSpacalCellReco::GetTowerTable::" << Name()
+          << " - Fatal Error - no tower table for layer " << layer
+          << ", not in the geometry at InitRun" << endl;
+      exit(1);
+    }
+  return iter->second;
+}
+
+PHG4CylinderCell *
+PHG4FullProjSpacalCellReco::MakeCell(const unsigned int layer, const int scint_id,
+    const TowerTable &table)
+{
+  // decode scint_id
+  PHG4CylinderGeom_Spacalv3::scint_id_coder decoder(scint_id);
+
+  // convert tower_ID to eta bin and phi bin
+  const int tower_ID = decoder.tower_ID;
+  if (tower_ID < 0 or tower_ID >= static_cast<int>(table.etabin.size())
+      or table.etabin[tower_ID] < 0)
+    {
+      cout << "Print scint_id_coder:" << endl;
+      decoder.identify();
+      cout << "PHG4FullProjSpacalCellReco::process_event::" << Name()
+          << " - Fatal Error - no tower (or eta bin) for tower_ID " << tower_ID
+          << " in layer " << layer << endl;
+      exit(1);
+    }
+
+  PHG4CylinderCell *cell = new PHG4CylinderCell_Spacalv1();
+  cell->set_layer(layer);
+  cell->set_phibin(decoder.sector_ID * table.max_phi_bin_in_sec + table.phibin_in_sec[tower_ID]);
+  cell->set_etabin(table.etabin[tower_ID]);
+  cell->set_fiber_ID(decoder.fiber_ID);
+  return cell;
+}
+
+void
+PHG4FullProjSpacalCellReco::FillFromAccumulator(PHG4CellAccumulator *cellacc,
+    PHG4CylinderCellContainer *cells)
+{
+  // one cell per accumulator cell, in the same order
+  vector<PHG4CylinderCell *> newcells;
+  newcells.reserve(cellacc->size());
+  int current_layer = -1;
+  const TowerTable *table = 0;
+  PHG4CellAccumulator::ConstRange cell_begin_end = cellacc->getCells();
+  for (PHG4CellAccumulator::ConstIterator citer = cell_begin_end.first;
+      citer != cell_begin_end.second; ++citer)
+    {
+      if (static_cast<int>(citer->layer) != current_layer)
+        {
+          current_layer = citer->layer;
+          table = &GetTowerTable(current_layer);
+        }
+      PHG4CylinderCell *cell = MakeCell(citer->layer, citer->key, *table);
+      cell->set_light_yield(citer->light_yield);
+      newcells.push_back(cell);
+    }
+  // no g4hits in this mode, the energy is kept per G4 track
+  PHG4CellAccumulator::TrackRange track_begin_end = cellacc->getTracks();
+  for (PHG4CellAccumulator::TrackIterator titer = track_begin_end.first;
+      titer != track_begin_end.second; ++titer)
+    {
+      newcells[titer->cell]->add_track_edep(titer->trkid, titer->edep);
+    }
+  for (unsigned int i = 0; i < newcells.size(); i++)
+    {
+      cells->AddCylinderCell(cellacc->getCell(i).layer, newcells[i]);
+    }
+  if (verbosity > 0)
+    {
+      cout << "PHG4FullProjSpacalCellReco::process_event::" << Name() << " - "
+          << " found " << newcells.size() << " fibers with energy deposition (direct cells)"
+          << endl;
+    }
+  return;
+}
+
 int
 PHG4FullProjSpacalCellReco::End(PHCompositeNode *topNode)
 {
@@ -415,13 +465,24 @@ PHG4FullProjSpacalCellReco::CheckEnergy(PHCompositeNode *topNode)
       hitnodename.c_str());
   PHG4CylinderCellContainer *cells = findNode::getClass<
       PHG4CylinderCellContainer>(topNode, cellnodename);
+  PHG4CellAccumulator *cellacc = findNode::getClass<PHG4CellAccumulator>(
+      topNode, cellaccnodename);
   double sum_energy_g4hit = 0.;
   double sum_energy_cells = 0.;
-  PHG4HitContainer::ConstRange hit_begin_end = g4hit->getHits();
-  PHG4HitContainer::ConstIterator hiter;
-  for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; ++hiter)
+  if (cellacc)
     {
-      sum_energy_g4hit += hiter->second->get_edep();
+      // direct cells, compare with the energy of the steps the stepping
+      // action handed to the accumulator
+      sum_energy_g4hit = cellacc->get_step_edep();
+    }
+  else
+    {
+      PHG4HitContainer::ConstRange hit_begin_end = g4hit->getHits();
+      PHG4HitContainer::ConstIterator hiter;
+      for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; ++hiter)
+        {
+          sum_energy_g4hit += hiter->second->get_edep();
+        }
     }
   PHG4CylinderCellContainer::ConstRange cell_begin_end =
       cells->getCylinderCells();
@@ -1,6 +1,8 @@
 #ifndef PHG4FullProjSpacalCellReco_H
 #define PHG4FullProjSpacalCellReco_H
 
+#include "PHG4CylinderCellIndex.h"
+
 #include <fun4all/SubsysReco.h>
 #include <phool/PHTimeServer.h>
 #include <string>
@@ -8,7 +10,13 @@
 #include <vector>
 
 class PHCompositeNode;
+class PHG4CellAccumulator;
 class PHG4CylinderCell;
+class PHG4CylinderCellContainer;
+class PHG4CylinderCellGeom_Spacalv1;
+class PHG4CylinderCellGeomContainer;
+class PHG4CylinderGeom_Spacalv3;
+class PHG4CylinderGeomContainer;
 
 class PHG4FullProjSpacalCellReco : public SubsysReco
 {
@@ -35,16 +43,39 @@ class PHG4FullProjSpacalCellReco : public SubsysReco
 
   int CheckEnergy(PHCompositeNode *topNode);
 
+#ifndef __CINT__
+  //! eta bin and phi bin in the sector of each tower_ID of a layer (-1: no tower), built in InitRun
+  struct TowerTable
+  {
+    std::vector<int> etabin;
+    std::vector<int> phibin_in_sec;
+    int max_phi_bin_in_sec;
+  };
+
+  //! table of the layer, exits if there is none
+  const TowerTable &GetTowerTable(const int layer) const;
+
+  //! new cell for the fiber with this scint_id
+  PHG4CylinderCell *MakeCell(const unsigned int layer, const int scint_id, const TowerTable &table);
+#endif
+
+  //! build the cells from the deposits the stepping action summed up (PHG4SpacalSubsystem::SetDirectCells)
+  void FillFromAccumulator(PHG4CellAccumulator *cellacc, PHG4CylinderCellContainer *cells);
+
 
   std::string detector;
   std::string hitnodename;
   std::string cellnodename;
   std::string geonodename;
   std::string seggeonodename;
+  std::string cellaccnodename;
 
   PHTimeServer::timer _timer;
   int chkenergyconservation;
-  std::map<unsigned int, PHG4CylinderCell *> celllist;
+  PHG4CylinderCellIndex celllist; // fired fibers by scint_id
+#ifndef __CINT__
+  std::map<int, TowerTable> tower_tables;
+#endif
 };
 
 #endif
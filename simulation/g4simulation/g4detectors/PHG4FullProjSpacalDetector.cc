@@ -10,6 +10,7 @@
 #include "PHG4FullProjSpacalDetector.h"
 #include "PHG4CylinderGeomContainer.h"
 #include "PHG4CylinderGeom_Spacalv1.h"
+#include "PHG4SpacalFiberParameterization.h"
 
 #include <g4main/PHG4PhenixDetector.h>
 #include <g4main/PHG4Utils.h>
@@ -28,6 +29,7 @@
 #include <Geant4/G4UserLimits.hh>
 #include <Geant4/G4Material.hh>
 #include <Geant4/G4PhysicalConstants.hh>
+#include <Geant4/G4PVParameterised.hh>
 #include <Geant4/G4PVPlacement.hh>
 #include <Geant4/G4SubtractionSolid.hh>
 #include <Geant4/G4SystemOfUnits.hh>
@@ -370,6 +372,14 @@ PHG4FullProjSpacalDetector::Construct_Fibers_SameLengthFiberPerTower(
   ss << string("_Tower") << g_tower.id;
   G4LogicalVolume *fiber_logic = Construct_Fiber(fiber_length, ss.str());
 
+  // owned by the detector, none for a tower without fibers
+  PHG4SpacalFiberParameterization *fiber_param = NULL;
+  if (parameterized_fibers && !fiber_par.empty())
+    {
+      fiber_param = new PHG4SpacalFiberParameterization();
+      fiber_params.push_back(fiber_param);
+    }
+
   BOOST_FOREACH(const fiber_par_map::value_type& val, fiber_par)
     {
       const int fiber_ID = val.first;
@@ -411,6 +421,15 @@ PHG4FullProjSpacalDetector::Construct_Fibers_SameLengthFiberPerTower(
           G4Translate3D(center_fiber.x(), center_fiber.y(), center_fiber.z())
               * G4Rotate3D(rotation_angle, rotation_axis));
 
+      fiber_count++;
+
+      if (fiber_param)
+        {
+          // the fiber IDs count up from 0 in map order, so copy number = fiber ID
+          fiber_param->AddFiber(fiber_place);
+          continue;
+        }
+
       stringstream name;
       name << GetName() + string("_Tower") << g_tower.id << "_fiber"
           << ss.str();
@@ -422,8 +441,20 @@ PHG4FullProjSpacalDetector::Construct_Fibers_SameLengthFiberPerTower(
           overlapcheck_fiber);
       fiber_vol[fiber_physi] = fiber_ID;
 
-      fiber_count++;
+    }
+
+  if (fiber_param)
+    {
+      stringstream name;
+      name << GetName() + string("_Tower") << g_tower.id << "_fiber"
+          << ss.str();
 
+      const bool overlapcheck_fiber = overlapcheck
+          and (_geom->get_construction_verbose() >= 3);
+      G4PVParameterised * fiber_physi = new G4PVParameterised(
+          G4String(name.str().c_str()), fiber_logic, LV_tower, kUndefined,
+          fiber_count, fiber_param, overlapcheck_fiber);
+      fiber_vol[fiber_physi] = 0;
     }
 
   if (_geom->get_construction_verbose() >= 2)
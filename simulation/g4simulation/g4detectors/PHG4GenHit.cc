@@ -4,7 +4,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 #include <fun4all/Fun4AllReturnCodes.h>
 
 #include <phool/getClass.h>
@@ -41,7 +41,7 @@ PHG4GenHit::process_event(PHCompositeNode *topNode)
   PHG4CylinderGeom *mygeom = geo->GetLayerGeom(layer);
   double inner_radius = mygeom->get_radius();
   double outer_radius = inner_radius + mygeom->get_thickness();
-  PHG4Hit *hit = new PHG4Hitv1();
+  PHG4Hit *hit = new PHG4Hitv2();
   hit->set_layer((unsigned int)layer);
   double x0 = inner_radius * cos(phi * M_PI / 180.);
   double y0 = inner_radius * sin(phi * M_PI / 180.);
@@ -0,0 +1,50 @@
+#include "PHG4GeometryInstancer.h"
+
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+
+PHG4GeometryInstancer::PHG4GeometryInstancer(const double prec):
+  precision(prec),
+  nshared(0)
+{}
+
+string
+PHG4GeometryInstancer::Key(const string &shape, const vector<double> &dimensions, const string &material) const
+{
+  ostringstream key;
+  key << shape << " " << material;
+  for (vector<double>::const_iterator iter = dimensions.begin(); iter != dimensions.end(); ++iter)
+    {
+      key << " " << static_cast<long long>(floor(*iter / precision + 0.5));
+    }
+  return key.str();
+}
+
+G4LogicalVolume *
+PHG4GeometryInstancer::Find(const string &key)
+{
+  map<string, G4LogicalVolume *>::const_iterator iter = instances.find(key);
+  if (iter == instances.end())
+    {
+      return NULL;
+    }
+  nshared++;
+  return iter->second;
+}
+
+G4LogicalVolume *
+PHG4GeometryInstancer::Register(const string &key, G4LogicalVolume *volume)
+{
+  instances[key] = volume;
+  return volume;
+}
+
+void
+PHG4GeometryInstancer::Print(ostream &os) const
+{
+  os << "PHG4GeometryInstancer: " << instances.size() << " logical volumes constructed, "
+     << nshared << " components placed as copies of them" << endl;
+  return;
+}
@@ -0,0 +1,49 @@
+#ifndef __PHG4GEOMETRYINSTANCER_H__
+#define __PHG4GEOMETRYINSTANCER_H__
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+class G4LogicalVolume;
+
+//! shares one logical volume between all identical components of a detector
+/*!
+  The detector builds a key from the shape type, its dimensions and the
+  material of a component (Key()) and asks Find() before constructing
+  it. Only the first component with a key gets its solid and logical
+  volume (Register()), all others are placements of that one. The
+  dimensions are compared after rounding to precision (G4 length units,
+  default 1 nm) so numerically equal parameters from different
+  computations are recognized.
+*/
+class PHG4GeometryInstancer
+{
+ public:
+
+  PHG4GeometryInstancer(const double precision = 1e-6);
+  virtual ~PHG4GeometryInstancer() {}
+
+  std::string Key(const std::string &shape, const std::vector<double> &dimensions, const std::string &material = "") const;
+
+  //! logical volume of this key, NULL if it has to be constructed
+  G4LogicalVolume *Find(const std::string &key);
+
+  //! returns volume
+  G4LogicalVolume *Register(const std::string &key, G4LogicalVolume *volume);
+
+  //! number of constructed and of shared (not constructed) components
+  unsigned int GetNConstructed() const {return instances.size();}
+  unsigned int GetNShared() const {return nshared;}
+
+  void Print(std::ostream &os = std::cout) const;
+
+ protected:
+
+  double precision;
+  std::map<std::string, G4LogicalVolume *> instances;
+  unsigned int nshared;
+};
+
+#endif
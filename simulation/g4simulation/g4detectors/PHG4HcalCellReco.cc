@@ -197,26 +197,26 @@ PHG4HcalCellReco::process_event(PHCompositeNode *topNode)
 		   << endl;
 	    }
 
-	  unsigned int key = (slatbin<<16) + slatno;
-	  if (celllist.find(key) == celllist.end())
+	  PHG4CylinderCell *&cell = celllist[PHG4CylinderCellIndex::key(slatbin, slatno)];
+	  if (!cell)
 	    {
-	      celllist[key] = new PHG4CylinderCellv1();
-	      celllist[key]->set_layer(*layer);
-	      celllist[key]->set_phibin(slatbin);
-	      celllist[key]->set_etabin(slatno);
+	      cell = new PHG4CylinderCellv1();
+	      cell->set_layer(*layer);
+	      cell->set_phibin(slatbin);
+	      cell->set_etabin(slatno);
 	    }
 
-	  celllist[key]->add_edep(hiter->first, hiter->second->get_edep(),hiter->second->get_light_yield());
+	  cell->add_edep(hiter->first, hiter->second->get_edep(),hiter->second->get_light_yield());
 	} // end loop over g4hits
       int numcells = 0;
-      for (map<unsigned int, PHG4CylinderCell *>::const_iterator mapiter = celllist.begin();mapiter != celllist.end() ; ++mapiter)
+      for (PHG4CylinderCellIndex::ConstIterator mapiter = celllist.begin();mapiter != celllist.end() ; ++mapiter)
 	{
 	  cells->AddCylinderCell(*layer, mapiter->second);
 	  numcells++;
 	  if (verbosity > 1)
 	    {
-	      cout << "Adding cell in bin slat: " << (mapiter->first >> 16)
-		   << ", eta: " << (mapiter->first & 0xFFFF)
+	      cout << "Adding cell in bin slat: " << mapiter->second->get_binphi()
+		   << ", eta: " << mapiter->second->get_bineta()
 		   << ", energy dep: " << mapiter->second->get_edep()
 		   << endl;
 	    }
@@ -1,6 +1,8 @@
 #ifndef PHG4HCALCELLRECO_H
 #define PHG4HCALCELLRECO_H
 
+#include "PHG4CylinderCellIndex.h"
+
 #include <fun4all/SubsysReco.h>
 #include <phool/PHTimeServer.h>
 #include <string>
@@ -53,7 +55,7 @@ class PHG4HcalCellReco : public SubsysReco
   int nslatscombined;
   int netabins;
   int chkenergyconservation;
-  std::map<unsigned int, PHG4CylinderCell *> celllist;
+  PHG4CylinderCellIndex celllist;
 };
 
 #endif
@@ -3,7 +3,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 #include <g4main/PHG4HitDefs.h>
 
 #include <g4main/PHG4TrackUserInfoV1.h>
@@ -74,7 +74,7 @@ bool PHG4HcalSteppingAction::UserSteppingAction( const G4Step* aStep, bool )
         case fGeomBoundary:
         case fUndefined:
 
-	  hit = new PHG4Hitv1();
+	  hit = new PHG4Hitv2();
 
 	  hit->set_layer((unsigned int)layer_id);
 	  hit->set_scint_id(isactive); // isactive contains the scintillator slat id
@@ -269,3 +269,9 @@ float PHG4HcalSteppingAction::GetLightCorrection(float r) {
 
   return value;
 }
+
+//____________________________________________________________________________..
+int PHG4HcalSteppingAction::HandlesVolume( G4VPhysicalVolume *volume )
+{
+  return (detector_->IsInCylinderActive(volume) > PHG4HcalDetector::INACTIVE) ? 1 : 0;
+}
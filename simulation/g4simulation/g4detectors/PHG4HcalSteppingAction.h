@@ -4,6 +4,7 @@
 #include "g4main/PHG4SteppingAction.h"
 #include <string>
 
+class G4VPhysicalVolume;
 class PHG4HcalDetector;
 class PHG4Hit;
 class PHG4HitContainer;
@@ -23,6 +24,9 @@ class PHG4HcalSteppingAction : public PHG4SteppingAction
   //! stepping action
   virtual bool UserSteppingAction(const G4Step*, bool);
 
+  //! reimplemented from base class
+  virtual int HandlesVolume(G4VPhysicalVolume *volume);
+
   //! reimplemented from base class
   virtual void SetInterfacePointers( PHCompositeNode* );
 
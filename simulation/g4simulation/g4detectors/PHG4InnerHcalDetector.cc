@@ -569,20 +569,21 @@ PHG4InnerHcalDetector::ConstructHcalScintillatorAssembly(G4LogicalVolume* hcalen
   ostringstream name;
   G4ThreeVector g4vec;
 
+  // the tiles differ in shape (and name), but share their step limits and vis attributes
+  G4UserLimits *g4userlimits = NULL;
+  if (isfinite(params->get_steplimits()))
+    {
+      g4userlimits = new G4UserLimits(params->get_steplimits());
+    }
+  G4VisAttributes *visattchk = new G4VisAttributes();
+  visattchk->SetVisibility(true);
+  visattchk->SetForceSolid(true);
+  visattchk->SetColour(G4Colour::Green());
   for (unsigned int i = 0; i < scinti_tiles_vec.size(); i++)
     {
       name.str("");
       name << scintilogicnameprefix << i;
-      G4UserLimits *g4userlimits = NULL;
-      if (isfinite(params->get_steplimits()))
-	{
-	  g4userlimits = new G4UserLimits(params->get_steplimits());
-	}
       G4LogicalVolume *scinti_tile_logic = new G4LogicalVolume(scinti_tiles_vec[i], G4Material::GetMaterial("G4_POLYSTYRENE"), name.str().c_str(), NULL, NULL, g4userlimits);
-      G4VisAttributes *visattchk = new G4VisAttributes();
-      visattchk->SetVisibility(true);
-      visattchk->SetForceSolid(true);
-      visattchk->SetColour(G4Colour::Green());
       scinti_tile_logic->SetVisAttributes(visattchk);
       assmeblyvol->AddPlacedVolume(scinti_tile_logic, g4vec, NULL);
     }
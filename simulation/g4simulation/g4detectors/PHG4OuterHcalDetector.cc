@@ -397,6 +397,12 @@ PHG4OuterHcalDetector::Construct( G4LogicalVolume* logicWorld )
   params->n_scinti_plates,/*G4int steelPlates*/
   params->scinti_gap, /*G4double scintiGap*/
   params->tilt_angle);/*G4double tiltAngle*/
+  if (params->field_table_nr > 0 && params->field_table_nz > 0)
+    {
+      field_setup->BuildFieldTables(params->inner_radius, params->outer_radius, params->field_table_nr,
+				    params->place_in_z - params->size_z / 2., params->place_in_z + params->size_z / 2.,
+				    params->field_table_nz, params->field_table_validate);
+    }
 
 
   G4Material* Air = G4Material::GetMaterial("G4_AIR");
@@ -682,20 +688,21 @@ PHG4OuterHcalDetector::ConstructHcalScintillatorAssembly(G4LogicalVolume* hcalen
   G4AssemblyVolume *assmeblyvol = new G4AssemblyVolume();
   ostringstream name;
   G4ThreeVector g4vec;
+  // the tiles differ in shape (and name), but share their step limits and vis attributes
+  G4UserLimits *g4userlimits = NULL;
+  if (isfinite(params->steplimits))
+    {
+      g4userlimits = new G4UserLimits(params->steplimits);
+    }
+  G4VisAttributes *visattchk = new G4VisAttributes();
+  visattchk->SetVisibility(true);
+  visattchk->SetForceSolid(true);
+  visattchk->SetColour(G4Colour::Green());
   for (unsigned int i=0; i<scinti_tiles_vec.size(); i++)
     {
       name.str("");
       name << scintilogicnameprefix << i;
-      G4UserLimits *g4userlimits = NULL;
-      if (isfinite(params->steplimits))
-	{
-	  g4userlimits = new G4UserLimits(params->steplimits);
-	}
       G4LogicalVolume *scinti_tile_logic = new G4LogicalVolume(scinti_tiles_vec[i],G4Material::GetMaterial("G4_POLYSTYRENE"),name.str().c_str(), NULL, NULL, g4userlimits);
-      G4VisAttributes *visattchk = new G4VisAttributes();
-      visattchk->SetVisibility(true);
-      visattchk->SetForceSolid(true);
-      visattchk->SetColour(G4Colour::Green());
       scinti_tile_logic->SetVisAttributes(visattchk);
       assmeblyvol->AddPlacedVolume(scinti_tile_logic,g4vec, NULL);
 
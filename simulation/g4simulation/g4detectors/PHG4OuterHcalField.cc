@@ -17,6 +17,11 @@
 #include <Geant4/G4EquationOfMotion.hh>
 #include <Geant4/G4PhysicalConstants.hh>
 #include <Geant4/G4SystemOfUnits.hh>
+
+#include <TRandom3.h>
+
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 using namespace std;
 
@@ -27,7 +32,15 @@ PHG4OuterHcalField::PHG4OuterHcalField(bool isInIron, G4int steelPlates,
     /*bool*/is_in_iron(isInIron),
     /*G4int*/n_steel_plates(steelPlates),
     /*G4double*/scinti_gap(scintiGap),
-    /*G4double*/tilt_angle(tiltAngle)
+    /*G4double*/tilt_angle(tiltAngle),
+    /*G4double*/cos_tilt(cos(tiltAngle)),
+    /*G4double*/sin_tilt(sin(tiltAngle)),
+    /*int*/table_nr(0),
+    /*int*/table_nz(0),
+    /*double*/table_rmin(0),
+    /*double*/table_zmin(0),
+    /*double*/table_dr(0),
+    /*double*/table_dz(0)
 {
 }
 
@@ -36,8 +49,8 @@ PHG4OuterHcalField::~PHG4OuterHcalField()
 
 }
 
-void
-PHG4OuterHcalField::GetFieldValue(const double Point[4], double *Bfield) const
+bool
+PHG4OuterHcalField::get_default_field(const double Point[4], double *Bfield) const
 {
 
   G4FieldManager* field_manager =
@@ -54,90 +67,272 @@ PHG4OuterHcalField::GetFieldValue(const double Point[4], double *Bfield) const
               << " - Error! can not find field manager in G4TransportationManager"
               << endl;
         }
+      return false;
     }
 
   const G4Field* default_field = field_manager->GetDetectorField();
 
-  if (default_field)
+  if (!default_field)
     {
-      default_field->GetFieldValue(Point, Bfield);
-
-      // scale_factor for field component along the plate surface
-      double x = Point[0];
-      double y = Point[1];
-//      double z = Point[2];
-
-      assert(cos(tilt_angle)>0);
-      assert(n_steel_plates>0);
-
-      // input 2D magnetic field vector
-      const G4Vector3D B0(Bfield[0], Bfield[1], Bfield[2]);
-      const G4Vector3D B0XY(Bfield[0], Bfield[1], 0);
-      const G4Vector3D B0Z(0, 0, Bfield[2]);
-
-      const double R = sqrt(x * x + y * y);
-      const double layer_RdPhi = R * twopi / n_steel_plates;
-      const double layer_width = layer_RdPhi * cos(tilt_angle);
-      const double gap_width = scinti_gap;
-
-      assert(gap_width<layer_width);
-
-      // sign definition of tilt_angle is rotation around the -z axis
-      const G4Vector3D absorber_dir(cos(atan2(y, x) - tilt_angle),
-          sin(atan2(y, x) - tilt_angle), 0);
-      const G4Vector3D radial_dir(cos(atan2(y, x)), sin(atan2(y, x)), 0);
-
-      const double radial_flux_per_layer = layer_RdPhi
-          * (B0XY.dot(radial_dir));
-      double B_XY_mag = radial_flux_per_layer
-          / (relative_permeability_absorber * (layer_width - gap_width)
-              + relative_permeability_gap * gap_width);
-      B_XY_mag *=
-          is_in_iron ?
-              relative_permeability_absorber : relative_permeability_gap;
-
-      const G4Vector3D B_New_XY = B_XY_mag * absorber_dir;
-
-      const double z_flux_per_layer = layer_width * B0Z.z();
-      double B_Z_mag = z_flux_per_layer
-          / (relative_permeability_absorber * (layer_width - gap_width)
-              + relative_permeability_gap * gap_width);
-      B_Z_mag *=
-          is_in_iron ?
-              relative_permeability_absorber : relative_permeability_gap;
-      const G4Vector3D B_New_Z(0, 0, B_Z_mag);
-
-      // scale B_T component
-      G4Vector3D B_New = B_New_Z + B_New_XY;
-      Bfield[0] = B_New.x();
-      Bfield[1] = B_New.y();
-      Bfield[2] = B_New.z();
-
       static bool once = true;
+
       if (once)
         {
           once = false;
           cout << "PHG4OuterHcalField::GetFieldValue"
-              << " - After-burner activated to produce 3D magnetic field in the outer HCal. First call to the after-burner: "
-              << (is_in_iron ? "inside iron, " : "inside gap, ") << "and R = "
-              << R / cm << " cm, field change from "
-              //
-              << "(" << B0.x() / tesla << "," << B0.y() / tesla << ","
-              << B0.z() / tesla << ") T" << " to " << "(" << B_New.x() / tesla
-              << "," << B_New.y() / tesla << "," << B_New.z() / tesla << ") T"
+              << " - Error! can not find detecor field in field manager!"
               << endl;
         }
+      return false;
     }
-  else
+
+  default_field->GetFieldValue(Point, Bfield);
+  return true;
+}
+
+void
+PHG4OuterHcalField::GetFieldValue(const double Point[4], double *Bfield) const
+{
+  if (get_table_field(Point, Bfield))
     {
-      static bool once = true;
+      return;
+    }
 
-      if (once)
+  if (!get_default_field(Point, Bfield))
+    {
+      return;
+    }
+
+  // same as GetFieldValueReference with the directions expressed by
+  // cos/sin of phi and the tilt angle
+  const double x = Point[0];
+  const double y = Point[1];
+  const double B0[3] =
+    { Bfield[0], Bfield[1], Bfield[2] };
+
+  assert(cos_tilt>0);
+  assert(n_steel_plates>0);
+
+  const double R = sqrt(x * x + y * y);
+  const double cos_phi = x / R;
+  const double sin_phi = y / R;
+  const double layer_RdPhi = R * twopi / n_steel_plates;
+  const double layer_width = layer_RdPhi * cos_tilt;
+  const double gap_width = scinti_gap;
+
+  assert(gap_width<layer_width);
+
+  const double relative_permeability =
+      is_in_iron ? relative_permeability_absorber : relative_permeability_gap;
+  const double flux_scale = relative_permeability
+      / (relative_permeability_absorber * (layer_width - gap_width)
+          + relative_permeability_gap * gap_width);
+
+  const double B_XY_mag = layer_RdPhi * (B0[0] * cos_phi + B0[1] * sin_phi)
+      * flux_scale;
+
+  // sign definition of tilt_angle is rotation around the -z axis
+  Bfield[0] = B_XY_mag * (cos_phi * cos_tilt + sin_phi * sin_tilt);
+  Bfield[1] = B_XY_mag * (sin_phi * cos_tilt - cos_phi * sin_tilt);
+  Bfield[2] = layer_width * B0[2] * flux_scale;
+
+  static bool once = true;
+  if (once)
+    {
+      once = false;
+      cout << "PHG4OuterHcalField::GetFieldValue"
+          << " - After-burner activated to produce 3D magnetic field in the outer HCal. First call to the after-burner: "
+          << (is_in_iron ? "inside iron, " : "inside gap, ") << "and R = "
+          << R / cm << " cm, field change from "
+          //
+          << "(" << B0[0] / tesla << "," << B0[1] / tesla << ","
+          << B0[2] / tesla << ") T" << " to " << "(" << Bfield[0] / tesla
+          << "," << Bfield[1] / tesla << "," << Bfield[2] / tesla << ") T"
+          << endl;
+    }
+}
+
+void
+PHG4OuterHcalField::GetFieldValueReference(const double Point[4], double *Bfield) const
+{
+  if (!get_default_field(Point, Bfield))
+    {
+      return;
+    }
+
+  // scale_factor for field component along the plate surface
+  double x = Point[0];
+  double y = Point[1];
+//      double z = Point[2];
+
+  assert(cos(tilt_angle)>0);
+  assert(n_steel_plates>0);
+
+  // input 2D magnetic field vector
+  const G4Vector3D B0XY(Bfield[0], Bfield[1], 0);
+  const G4Vector3D B0Z(0, 0, Bfield[2]);
+
+  const double R = sqrt(x * x + y * y);
+  const double layer_RdPhi = R * twopi / n_steel_plates;
+  const double layer_width = layer_RdPhi * cos(tilt_angle);
+  const double gap_width = scinti_gap;
+
+  assert(gap_width<layer_width);
+
+  // sign definition of tilt_angle is rotation around the -z axis
+  const G4Vector3D absorber_dir(cos(atan2(y, x) - tilt_angle),
+      sin(atan2(y, x) - tilt_angle), 0);
+  const G4Vector3D radial_dir(cos(atan2(y, x)), sin(atan2(y, x)), 0);
+
+  const double radial_flux_per_layer = layer_RdPhi
+      * (B0XY.dot(radial_dir));
+  double B_XY_mag = radial_flux_per_layer
+      / (relative_permeability_absorber * (layer_width - gap_width)
+          + relative_permeability_gap * gap_width);
+  B_XY_mag *=
+      is_in_iron ?
+          relative_permeability_absorber : relative_permeability_gap;
+
+  const G4Vector3D B_New_XY = B_XY_mag * absorber_dir;
+
+  const double z_flux_per_layer = layer_width * B0Z.z();
+  double B_Z_mag = z_flux_per_layer
+      / (relative_permeability_absorber * (layer_width - gap_width)
+          + relative_permeability_gap * gap_width);
+  B_Z_mag *=
+      is_in_iron ?
+          relative_permeability_absorber : relative_permeability_gap;
+  const G4Vector3D B_New_Z(0, 0, B_Z_mag);
+
+  // scale B_T component
+  G4Vector3D B_New = B_New_Z + B_New_XY;
+  Bfield[0] = B_New.x();
+  Bfield[1] = B_New.y();
+  Bfield[2] = B_New.z();
+}
+
+void
+PHG4OuterHcalField::BuildTable(const double rmin, const double rmax,
+    const int nr, const double zmin, const double zmax, const int nz)
+{
+  table.clear();
+  double probe[4] =
+    { rmin, 0, zmin, 0 };
+  double B[3] =
+    { 0, 0, 0 };
+  if (nr <= 0 || nz <= 0 || rmin <= 0 || rmax <= rmin || zmax <= zmin
+      || !get_default_field(probe, B))
+    {
+      cout << "PHG4OuterHcalField::BuildTable - cannot build table for r = "
+          << rmin / cm << " - " << rmax / cm << " cm (" << nr << " bins), z = "
+          << zmin / cm << " - " << zmax / cm << " cm (" << nz
+          << " bins), using the analytic calculation" << endl;
+      return;
+    }
+  table_nr = nr;
+  table_nz = nz;
+  table_rmin = rmin;
+  table_zmin = zmin;
+  table_dr = (rmax - rmin) / nr;
+  table_dz = (zmax - zmin) / nz;
+  // nodes at the bin edges
+  table.resize((nr + 1) * (nz + 1) * 3);
+  for (int iz = 0; iz <= nz; iz++)
+    {
+      for (int ir = 0; ir <= nr; ir++)
         {
-          once = false;
-          cout << "PHG4OuterHcalField::GetFieldValue"
-              << " - Error! can not find detecor field in field manager!"
-              << endl;
+          // at phi = 0 x/y are the radial/tangential components
+          double point[4] =
+            { rmin + ir * table_dr, 0, zmin + iz * table_dz, 0 };
+          GetFieldValueReference(point, B);
+          float *node = &table[(iz * (nr + 1) + ir) * 3];
+          node[0] = B[0];
+          node[1] = B[1];
+          node[2] = B[2];
+        }
+    }
+}
+
+bool
+PHG4OuterHcalField::get_table_field(const double Point[4], double *Bfield) const
+{
+  if (table.empty())
+    {
+      return false;
+    }
+  const double x = Point[0];
+  const double y = Point[1];
+  const double R = sqrt(x * x + y * y);
+  const double rpos = (R - table_rmin) / table_dr;
+  const double zpos = (Point[2] - table_zmin) / table_dz;
+  if (rpos < 0 || rpos >= table_nr || zpos < 0 || zpos >= table_nz)
+    {
+      return false;
+    }
+  const int ir = static_cast<int>(rpos);
+  const int iz = static_cast<int>(zpos);
+  const double rweight = rpos - ir;
+  const double zweight = zpos - iz;
+  const float *b00 = &table[(iz * (table_nr + 1) + ir) * 3];
+  const float *b01 = b00 + 3;
+  const float *b10 = b00 + (table_nr + 1) * 3;
+  const float *b11 = b10 + 3;
+  double Blocal[3];
+  for (int i = 0; i < 3; i++)
+    {
+      Blocal[i] = (1 - zweight) * ((1 - rweight) * b00[i] + rweight * b01[i])
+          + zweight * ((1 - rweight) * b10[i] + rweight * b11[i]);
+    }
+  // rotate from phi = 0 to the phi of the point
+  const double cos_phi = x / R;
+  const double sin_phi = y / R;
+  Bfield[0] = Blocal[0] * cos_phi - Blocal[1] * sin_phi;
+  Bfield[1] = Blocal[0] * sin_phi + Blocal[1] * cos_phi;
+  Bfield[2] = Blocal[2];
+  return true;
+}
+
+double
+PHG4OuterHcalField::Validate(const int npoints) const
+{
+  if (table.empty())
+    {
+      cout << "PHG4OuterHcalField::Validate - no table, nothing to validate"
+          << endl;
+      return 0;
+    }
+  double bmax = 0;
+  for (vector<float>::const_iterator iter = table.begin(); iter != table.end();
+      ++iter)
+    {
+      bmax = max(bmax, static_cast<double>(fabs(*iter)));
+    }
+  if (bmax <= 0)
+    {
+      bmax = tesla;
+    }
+  TRandom3 rnd(4357);
+  double maxdiff = 0;
+  for (int i = 0; i < npoints; i++)
+    {
+      const double R = table_rmin + rnd.Rndm() * table_nr * table_dr;
+      const double phi = rnd.Rndm() * twopi;
+      double point[4] =
+        { R * cos(phi), R * sin(phi), table_zmin + rnd.Rndm() * table_nz
+            * table_dz, 0 };
+      double B[3];
+      double Bref[3];
+      GetFieldValue(point, B);
+      GetFieldValueReference(point, Bref);
+      for (int j = 0; j < 3; j++)
+        {
+          maxdiff = max(maxdiff, fabs(B[j] - Bref[j]));
         }
     }
+  cout << "PHG4OuterHcalField::Validate - " << (is_in_iron ? "iron" : "gap")
+      << " field table " << table_nr << " x " << table_nz
+      << " bins, largest difference to the analytic field at " << npoints
+      << " points: " << maxdiff / tesla << " T (" << maxdiff / bmax
+      << " of the maximum field " << bmax / tesla << " T)" << endl;
+  return maxdiff / bmax;
 }
@@ -14,6 +14,10 @@
 #include <Geant4/G4MagneticField.hh>
 #include <Geant4/globals.hh>
 #include <Geant4/G4ios.hh>
+
+#include <cmath>
+#include <vector>
+
 /*!
  * \brief PHG4OuterHcalField
  *
@@ -25,6 +29,14 @@
  *
  * relative_permeability_absorber = 1514, relative permeability for Steel 1006 @ B = 1.06T
  * http://www.fieldp.com/magneticproperties.html
+ *
+ * GetFieldValue evaluates the after burner in closed form (no trigonometric
+ * functions). Optionally BuildTable() tabulates the resulting field in (r, z)
+ * (radial, tangential and z component, the field of a plate does not
+ * depend on the position within the sector) so the lookup of the default
+ * field is skipped inside the table. This assumes a phi symmetric default
+ * field, Validate() compares with GetFieldValueReference() (the original
+ * computation) at random points.
  */
 class PHG4OuterHcalField : public G4MagneticField
 {
@@ -37,6 +49,23 @@ public:
   void
   GetFieldValue(const double Point[4], double *Bfield) const;
 
+  //! original computation with the vector algebra, reference for the validation
+  void
+  GetFieldValueReference(const double Point[4], double *Bfield) const;
+
+  //! tabulate the field in nr x nz bins of rmin < r < rmax, zmin < z < zmax
+  void
+  BuildTable(const double rmin, const double rmax, const int nr,
+      const double zmin, const double zmax, const int nz);
+
+  //! compare GetFieldValue with GetFieldValueReference at npoints random points inside the table
+  /*!
+   * returns the largest difference of a field component relative to the
+   * largest field component in the table
+   */
+  double
+  Validate(const int npoints) const;
+
   bool
   is_is_in_iron() const
   {
@@ -107,10 +136,20 @@ public:
   set_tilt_angle(G4double tiltAngle)
   {
     tilt_angle = tiltAngle;
+    cos_tilt = cos(tilt_angle);
+    sin_tilt = sin(tilt_angle);
   }
 
 private:
 
+  //! the default field (from the global field manager), false if there is none
+  bool
+  get_default_field(const double Point[4], double *Bfield) const;
+
+  //! field from table, false if Point is outside the table
+  bool
+  get_table_field(const double Point[4], double *Bfield) const;
+
   double relative_permeability_absorber;
   double relative_permeability_gap;
 
@@ -118,6 +157,17 @@ private:
   G4int n_steel_plates;
   G4double scinti_gap;
   G4double tilt_angle;
+  G4double cos_tilt;
+  G4double sin_tilt;
+
+  //! (r, z) table of the field (radial, tangential, z component) in the plane phi = 0
+  std::vector<float> table;
+  int table_nr;
+  int table_nz;
+  double table_rmin;
+  double table_zmin;
+  double table_dr;
+  double table_dz;
 };
 
 #endif /* PHG4OUTERHCALFIELD_H_ */
@@ -91,6 +91,20 @@ PHG4OuterHcalFieldSetup::PHG4OuterHcalFieldSetup(G4int steelPlates,
     }
 }
 
+void
+PHG4OuterHcalFieldSetup::BuildFieldTables(const double rmin, const double rmax,
+    const int nr, const double zmin, const double zmax, const int nz,
+    const bool validate)
+{
+  fEMfieldIron->BuildTable(rmin, rmax, nr, zmin, zmax, nz);
+  fEMfieldGap->BuildTable(rmin, rmax, nr, zmin, zmax, nz);
+  if (validate)
+    {
+      fEMfieldIron->Validate(100000);
+      fEMfieldGap->Validate(100000);
+    }
+}
+
 PHG4OuterHcalFieldSetup::~PHG4OuterHcalFieldSetup()
 {
 //  interesting that pointers in the F03FieldSetup was not cleaned up at the end
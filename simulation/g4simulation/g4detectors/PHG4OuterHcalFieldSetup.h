@@ -24,6 +24,7 @@ class G4Mag_UsualEqRhs;
 class G4MagIntegratorStepper;
 class G4MagInt_Driver;
 class G4TBFieldMessenger;
+class PHG4OuterHcalField;
 
 /*!
  * \brief PHG4OuterHcalFieldSetup following Geant4 example F03FieldSetup
@@ -36,6 +37,11 @@ public:
   virtual
   ~PHG4OuterHcalFieldSetup();
 
+  //! tabulate the iron and gap fields in nr x nz (r, z) bins, see PHG4OuterHcalField::BuildTable
+  void
+  BuildFieldTables(const double rmin, const double rmax, const int nr,
+      const double zmin, const double zmax, const int nz, const bool validate);
+
   G4FieldManager*
   get_Field_Manager_Gap() const
   {
@@ -116,8 +122,8 @@ private:
   G4Mag_UsualEqRhs* fEquationGap;
   G4ChordFinder* fChordFinderIron;
   G4ChordFinder* fChordFinderGap;
-  G4MagneticField* fEMfieldIron;
-  G4MagneticField* fEMfieldGap;
+  PHG4OuterHcalField* fEMfieldIron;
+  PHG4OuterHcalField* fEMfieldGap;
   G4MagIntegratorStepper* fStepperIron;
   G4MagIntegratorStepper* fStepperGap;
 
@@ -30,6 +30,9 @@ PHG4OuterHcalParameters::PHG4OuterHcalParameters():
   material("G4_Fe"),
   steplimits(NAN),
   enable_field_checker(false),
+  field_table_nr(0),
+  field_table_nz(0),
+  field_table_validate(false),
   light_scint_model(true),
   light_balance(false),
   light_balance_inner_radius(0.0),
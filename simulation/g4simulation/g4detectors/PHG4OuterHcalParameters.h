@@ -33,6 +33,11 @@ class PHG4OuterHcalParameters
   G4String material;
   G4double steplimits;
   bool enable_field_checker;
+  //! bins of the (r, z) table of the field after burner, no table if 0
+  G4int field_table_nr;
+  G4int field_table_nz;
+  //! compare the field table with the analytic field after building it
+  bool field_table_validate;
   bool  light_scint_model;
   bool light_balance;
   G4double light_balance_inner_radius;
@@ -301,3 +301,11 @@ PHG4OuterHcalSubsystem:: SetLightScintModel(const bool b)
 {
   params->light_scint_model = b;
 }
+
+void
+PHG4OuterHcalSubsystem::SetFieldTable(const int nr, const int nz, const bool validate)
+{
+  params->field_table_nr = nr;
+  params->field_table_nz = nz;
+  params->field_table_validate = validate;
+}
@@ -78,6 +78,8 @@ class PHG4OuterHcalSubsystem: public PHG4Subsystem
   void SetLightCorrection(const float inner_radius, const float inner_corr,
 			  const float outer_radius, const float outer_corr);
   void SetLightScintModel(const bool b = true);
+  //! tabulate the field in the steel/gaps in nr x nz bins in r and z instead of computing it at every step
+  void SetFieldTable(const int nr, const int nz, const bool validate = false);
 
   private:
 
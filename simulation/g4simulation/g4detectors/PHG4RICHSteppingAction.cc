@@ -12,7 +12,7 @@
 #include "PHG4RICHDetector.h"
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 #include <g4main/PHG4TrackUserInfoV1.h>
 
 #include "Geant4/G4ProcessManager.hh"
@@ -126,7 +126,7 @@ bool PHG4RICHSteppingAction::MakeHit(const G4Step* aStep){
 
   int layer_id = 0;
 
-  hit = new PHG4Hitv1();
+  hit = new PHG4Hitv2();
 
   //here we set the entrance values in cm
   hit->set_x( 0, postPoint->GetPosition().x() / cm);
@@ -1,6 +1,8 @@
 #ifndef PHG4SILICONTRACKERCELLRECO_H
 #define PHG4SILICONTRACKERCELLRECO_H
 
+#include "PHG4CylinderCellIndex.h"
+
 #include <fun4all/SubsysReco.h>
 #include <phool/PHTimeServer.h>
 #include <string>
@@ -51,8 +53,7 @@ class PHG4SiliconTrackerCellReco : public SubsysReco
   int nslatscombined;
   int chkenergyconservation;
   int layer;
-  //std::map<unsigned int, PHG4CylinderCell *> celllist;
-  std::map<std::string, PHG4CylinderCell*> celllist;  // This map holds the hit cells
+  PHG4CylinderCellIndex celllist;  // the hit strips by ladder z/phi and strip z/y index
 };
 
 #endif
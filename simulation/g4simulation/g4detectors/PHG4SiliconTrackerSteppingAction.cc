@@ -3,7 +3,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4Hit.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 
 #include <g4main/PHG4TrackUserInfoV1.h>
 
@@ -165,7 +165,7 @@ bool PHG4SiliconTrackerSteppingAction::UserSteppingAction( const G4Step* aStep,
 	case fGeomBoundary:
 	case fUndefined:
 	  
-	  hit = new PHG4Hitv1();
+	  hit = new PHG4Hitv2();
 	  
 	  hit->set_layer((unsigned int)layer_id);
 	  
@@ -306,3 +306,9 @@ void PHG4SiliconTrackerSteppingAction::SetInterfacePointers( PHCompositeNode* to
 	}
     }
 }
+
+//____________________________________________________________________________..
+int PHG4SiliconTrackerSteppingAction::HandlesVolume( G4VPhysicalVolume *volume )
+{
+  return (detector_->IsInSiliconTracker(volume) != 0) ? 1 : 0;
+}
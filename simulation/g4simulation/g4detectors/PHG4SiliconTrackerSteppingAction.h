@@ -3,6 +3,7 @@
 
 #include "g4main/PHG4SteppingAction.h"
 
+class G4VPhysicalVolume;
 class PHG4SiliconTrackerDetector;
 class PHG4Hit;
 class PHG4HitContainer;
@@ -22,6 +23,9 @@ class PHG4SiliconTrackerSteppingAction : public PHG4SteppingAction
   //! stepping action
   virtual bool UserSteppingAction(const G4Step*, bool);
 
+  //! reimplemented from base class
+  virtual int HandlesVolume(G4VPhysicalVolume *volume);
+
   //! reimplemented from base class
   virtual void SetInterfacePointers( PHCompositeNode* );
 
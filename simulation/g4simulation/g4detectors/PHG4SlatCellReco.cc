@@ -3,6 +3,7 @@
 #include "PHG4CylinderGeom.h"
 #include "PHG4CylinderCellGeomContainer.h"
 #include "PHG4CylinderCellGeom.h"
+#include "PHG4CellSplitter.h"
 #include "PHG4CylinderCellv1.h"
 #include "PHG4CylinderCellContainer.h"
 #include "PHG4CylinderCellDefs.h"
@@ -17,19 +18,14 @@
 #include <phool/getClass.h>
 
 
-#include <boost/tuple/tuple.hpp>
-
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 
 using namespace std;
 
-#define ARRAYDIM1 1000
-#define ARRAYDIM2 1000
-static PHG4CylinderCell *cellptarray[ARRAYDIM1][ARRAYDIM2];
-
 PHG4SlatCellReco::PHG4SlatCellReco(const string &name) :
   SubsysReco(name),
   _timer(PHTimeServer::get()->insert_new(name.c_str())),
@@ -37,7 +33,6 @@ PHG4SlatCellReco::PHG4SlatCellReco(const string &name) :
   chkenergyconservation(0)
 {
   memset(nbins, 0, sizeof(nbins));
-  memset(cellptarray, 0, sizeof(cellptarray));
 }
 
 int PHG4SlatCellReco::InitRun(PHCompositeNode *topNode)
@@ -220,35 +215,44 @@ PHG4SlatCellReco::process_event(PHCompositeNode *topNode)
       PHG4CylinderCellGeom *geo = seggeo->GetLayerCellGeom(*layer);
       int nslatbins = n_phi_z_bins[*layer].first;
       int nzbins = n_phi_z_bins[*layer].second;
-      if ( nslatbins >= ARRAYDIM1)
-        {
-          cout << "required bins in numslats " << nslatbins
-               << " exceed array size: " << ARRAYDIM1
-               << " adjust ARRAYDIM1 and recompile" << endl;
-          exit(1);
-        }
-
-      if (nzbins >= ARRAYDIM2)
-        {
-          cout << "required bins in z: " << nzbins
-               << " exceed array size: " << ARRAYDIM2
-               << " adjust ARRAYDIM2 and recompile" << endl;
-          exit(1);
-        }
-
+      cellindex.clear(nslatbins * nzbins);
 
       // ------- eta/phi binning ------------------------------------------------------------------------
       if (binning[*layer] == PHG4CylinderCellDefs::etaslatbinning)
         {
+          // eta bins of the entry (2*i) and exit (2*i + 1) points of all hits at once
+          unsigned int npoints = 2 * distance(hit_begin_end.first, hit_begin_end.second);
+          hit_x.resize(npoints);
+          hit_y.resize(npoints);
+          hit_z.resize(npoints);
+          hit_eta.resize(npoints);
+          hit_etabin.resize(npoints);
+          unsigned int ipoint = 0;
           for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; ++hiter)
+            {
+              for (int i = 0; i < 2; i++)
+                {
+                  hit_x[ipoint] = hiter->second->get_x(i);
+                  hit_y[ipoint] = hiter->second->get_y(i);
+                  hit_z[ipoint] = hiter->second->get_z(i);
+                  ipoint++;
+                }
+            }
+          if (npoints > 0)
+            {
+              geo->find_bins(npoints, &hit_x[0], &hit_y[0], &hit_z[0], NULL, &hit_eta[0], NULL, &hit_etabin[0]);
+            }
+          PHG4CellSplitter splitter(geo, PHG4CellSplitterEtaPhi());
+          ipoint = 0;
+          for (hiter = hit_begin_end.first; hiter != hit_begin_end.second; ++hiter, ipoint += 2)
             {
               double etaphi[2];
               int slatbin;
-              double etabin[2];
+              int etabin[2];
               for (int i = 0; i < 2; i++)
                 {
-                  etaphi[i] = get_eta(sqrt(hiter->second->get_x(i) * hiter->second->get_x(i) + hiter->second->get_y(i) * hiter->second->get_y(i)), hiter->second->get_z(i));
-                  etabin[i] = geo->get_etabin( etaphi[i]);
+                  etaphi[i] = hit_eta[ipoint + i];
+                  etabin[i] = hit_etabin[ipoint + i];
                 }
               slatbin = hiter->second->get_scint_id() / nslatscombined;
               if (etabin[0] < 0 || etabin[0] >= nzbins   || etabin[1] < 0 || etabin[1] >= nzbins)
@@ -265,7 +269,7 @@ PHG4SlatCellReco::process_event(PHCompositeNode *topNode)
 		  continue;
 		}
 
-	      if (slatbin < 0 || slatbin > nslatbins)
+	      if (slatbin < 0 || slatbin >= nslatbins)
 		{
 		  if (slatbin + 1 > nslatbins)
 		    {
@@ -290,80 +294,34 @@ PHG4SlatCellReco::process_event(PHCompositeNode *topNode)
                   continue;
                 }
 
-              int intetabin = etabin[0];
-	      int intetabinout = etabin[1];
-	      if (intetabin != intetabinout)
-		{
-		  vector< boost::tuple<int, int, double> > bins_fraction;
-		  double etaboundary = NAN;
-		  double boundlow = etaphi[0];
-		  double boundhi = etaphi[1];
-		  int binstart = intetabin;
-		  int binend = intetabinout;
-		  if (intetabin > intetabinout)
-		    {
-		      binstart = intetabinout;
-		      binend = intetabin;
-		      boundlow = etaphi[1];
-		      boundhi = etaphi[0];
-		    }
-		  for (int i = binstart; i <= binend; i++)
-		    {
-		      etaboundary = geo->get_etamin() +  geo->get_etastep() * (i + 1);
-		      double fraction = fabs((boundlow - etaboundary) / (etaphi[0] - etaphi[1]));
-		      if (etaboundary > boundhi)
-			{
-			  fraction = fabs((boundlow - boundhi) / (etaphi[0] - etaphi[1]));
-			}
-		      bins_fraction.push_back(boost::make_tuple(slatbin, i, fraction));
-		      boundlow = etaboundary;
-		    }
-		  while (bins_fraction.size() > 0)
-		    {
-		      slatbin = bins_fraction.back().get<0>();
-		      intetabin = bins_fraction.back().get<1>();
-		      if (!cellptarray[slatbin][intetabin])
-			{
-			  cellptarray[slatbin][intetabin] = new PHG4CylinderCellv1();
-			  cellptarray[slatbin][intetabin]->set_layer(*layer);
-			  cellptarray[slatbin][intetabin]->set_phibin(slatbin);
-			  cellptarray[slatbin][intetabin]->set_etabin(intetabin);
-			}
-		      cellptarray[slatbin][intetabin]->add_edep(hiter->first, hiter->second->get_edep()*bins_fraction.back().get<2>(), hiter->second->get_light_yield()*bins_fraction.back().get<2>());
-		      bins_fraction.pop_back();
-		    }
-		}
-	      else // all in same cell this is easy (keep from previous code)
+	      // the slat is fixed, only the eta boundaries split the hit
+	      unsigned int ncells = splitter.Split(0., etaphi[0], slatbin, etabin[0], 0., etaphi[1], slatbin, etabin[1]);
+	      for (unsigned int i = 0; i < ncells; i++)
 		{
-		  if (!cellptarray[slatbin][intetabin])
+		  int intetabin = splitter.get_ybin(i);
+		  double fraction = splitter.get_fraction(i);
+		  PHG4CylinderCell *&cell = cellindex[slatbin * nzbins + intetabin];
+		  if (!cell)
 		    {
-		      cellptarray[slatbin][intetabin] = new PHG4CylinderCellv1();
-		      cellptarray[slatbin][intetabin]->set_layer(*layer);
-		      cellptarray[slatbin][intetabin]->set_phibin(slatbin);
-		      cellptarray[slatbin][intetabin]->set_etabin(intetabin);
+		      cell = new PHG4CylinderCellv1();
+		      cell->set_layer(*layer);
+		      cell->set_phibin(slatbin);
+		      cell->set_etabin(intetabin);
 		    }
-		  cellptarray[slatbin][intetabin]->add_edep(hiter->first, hiter->second->get_edep(), hiter->second->get_light_yield());
+		  cell->add_edep(hiter->first, hiter->second->get_edep()*fraction, hiter->second->get_light_yield()*fraction);
 		}
 	    } // end loop over g4hits
           int numcells = 0;
-          for (int islat = 0; islat < nslatbins; islat++)
+          for (PHG4CylinderCellIndex::ConstIterator iter = cellindex.begin(); iter != cellindex.end(); ++iter)
             {
-              for (int iz = 0; iz < nzbins; iz++)
+              cells->AddCylinderCell(*layer, iter->second);
+              numcells++;
+              if (verbosity > 1)
                 {
-                  if (cellptarray[islat][iz])
-                    {
-                      cells->AddCylinderCell(*layer, cellptarray[islat][iz]);
-                      numcells++;
-                      if (verbosity > 1)
-                        {
-                          cout << "Adding cell in bin slat: " << islat
-                               << ", eta: " << iz
-                               << ", energy dep: " << cellptarray[islat][iz]->get_edep()
-                               << endl;
-                        }
-                      cellptarray[islat][iz] = 0;
-                    }
-
+                  cout << "Adding cell in bin slat: " << iter->second->get_binphi()
+                       << ", eta: " << iter->second->get_bineta()
+                       << ", energy dep: " << iter->second->get_edep()
+                       << endl;
                 }
             }
 
@@ -1,6 +1,8 @@
 #ifndef PHG4SLATCELLRECO_H
 #define PHG4SLATCELLRECO_H
 
+#include "PHG4CylinderCellIndex.h"
+
 #include <fun4all/SubsysReco.h>
 #include <phool/PHTimeServer.h>
 #include <string>
@@ -50,6 +52,10 @@ class PHG4SlatCellReco : public SubsysReco
   std::string geonodename;
   std::string seggeonodename;
   std::map<int, std::pair<int, int> > n_phi_z_bins;
+  PHG4CylinderCellIndex cellindex; // the hit cells of the current layer by slatbin * nzbins + etabin
+  // hit coordinates and eta bins of the current layer
+  std::vector<double> hit_x, hit_y, hit_z, hit_eta;
+  std::vector<int> hit_etabin;
   PHTimeServer::timer _timer;
   int nbins[2];
   int nslatscombined;
@@ -10,6 +10,8 @@
 #include "PHG4SpacalDetector.h"
 #include "PHG4CylinderGeomContainer.h"
 #include "PHG4CylinderGeom_Spacalv1.h"
+#include "PHG4GeometryInstancer.h"
+#include "PHG4SpacalFiberParameterization.h"
 
 #include <g4main/PHG4PhenixDetector.h>
 #include <g4main/PHG4Utils.h>
@@ -26,6 +28,7 @@
 #include <Geant4/G4UserLimits.hh>
 #include <Geant4/G4Material.hh>
 #include <Geant4/G4PhysicalConstants.hh>
+#include <Geant4/G4PVParameterised.hh>
 #include <Geant4/G4PVPlacement.hh>
 #include <Geant4/G4SubtractionSolid.hh>
 #include <Geant4/G4SystemOfUnits.hh>
@@ -46,8 +49,8 @@ using namespace std;
 PHG4SpacalDetector::PHG4SpacalDetector(PHCompositeNode *Node,
     const std::string &dnam, SpacalGeom_t * geom, const int lyr) :
     PHG4Detector(Node, dnam), _region(NULL), cylinder_solid(NULL), cylinder_logic(
-        NULL), cylinder_physi(NULL), active(0), absorberactive(0), layer(
-        lyr), _geom(geom)
+        NULL), cylinder_physi(NULL), active(0), absorberactive(0), parameterized_fibers(
+        0), layer(lyr), _geom(geom)
 {
 
   if (_geom == NULL)
@@ -72,6 +75,10 @@ PHG4SpacalDetector::~PHG4SpacalDetector(void)
     delete step_limits;
     delete clading_step_limits;
     delete fiber_core_step_limits;
+    BOOST_FOREACH(PHG4SpacalFiberParameterization *fiber_param, fiber_params)
+      {
+        delete fiber_param;
+      }
 }
 
 //_______________________________________________________________
@@ -234,6 +241,7 @@ PHG4SpacalDetector::Construct(G4LogicalVolume* logicWorld)
       cout << "PHG4SpacalDetector::Construct::" << GetName()
           << " - Completed. Print Geometry:" << endl;
       Print();
+      fiber_instances.Print();
     }
 }
 
@@ -261,6 +269,8 @@ PHG4SpacalDetector::Construct_AzimuthalSeg()
       - 2 * _geom->get_fiber_outer_r() * cm;
   G4LogicalVolume *fiber_logic = Construct_Fiber(fiber_length, string(""));
 
+  PHG4SpacalFiberParameterization *fiber_param = NULL;
+
   int fiber_count = 0;
 //  double z_step = _geom->get_fiber_distance() * cm * sqrt(3) / 2.;
   double z_step = _geom->get_z_distance() * cm;
@@ -276,6 +286,20 @@ PHG4SpacalDetector::Construct_AzimuthalSeg()
               * G4TranslateX3D(_geom->get_half_radius() * cm)
               * G4RotateY3D(halfpi));
 
+      if (parameterized_fibers)
+        {
+          // created with the first fiber, owned by the detector
+          if (!fiber_param)
+            {
+              fiber_param = new PHG4SpacalFiberParameterization();
+              fiber_params.push_back(fiber_param);
+            }
+          fiber_param->AddFiber(fiber_place);
+          z += z_step;
+          fiber_count++;
+          continue;
+        }
+
       stringstream name;
       name << GetName() << "_fiber_" << fiber_count;
 
@@ -287,6 +311,14 @@ PHG4SpacalDetector::Construct_AzimuthalSeg()
       z += z_step;
       fiber_count++;
     }
+  if (fiber_param)
+    {
+      // copy number = fiber count as for the placements
+      G4PVParameterised * fiber_physi = new G4PVParameterised(
+          G4String(GetName() + string("_fiber")), fiber_logic, sec_logic,
+          kUndefined, fiber_count, fiber_param, overlapcheck);
+      fiber_vol[fiber_physi] = 0;
+    }
   _geom->set_nscint(fiber_count);
 
   if (verbosity > 0) {
@@ -310,6 +342,12 @@ PHG4SpacalDetector::Construct_AzimuthalSeg()
 G4LogicalVolume *
 PHG4SpacalDetector::Construct_Fiber(const G4double length, const string & id)
 {
+  // fibers of the same length (the radii and materials are fixed) share one logical volume
+  const string key = fiber_instances.Key("fiber", vector<double>(1, length));
+  if (G4LogicalVolume *fiber_logic = fiber_instances.Find(key))
+    {
+      return fiber_logic;
+    }
 
   G4Tubs* fiber_solid = new G4Tubs(G4String(GetName() + string("_fiber") + id),
       0, _geom->get_fiber_outer_r() * cm, length / 2.0, 0, twopi);
@@ -356,7 +394,7 @@ PHG4SpacalDetector::Construct_Fiber(const G4double length, const string & id)
       false, 0, overlapcheck_fiber);
   fiber_core_vol[core_physi] = 0;
 
-  return fiber_logic;
+  return fiber_instances.Register(key, fiber_logic);
 }
 
 void
@@ -13,6 +13,7 @@
 
 #include "g4main/PHG4Detector.h"
 #include "PHG4CylinderGeom_Spacalv1.h"
+#include "PHG4GeometryInstancer.h"
 
 #include <Geant4/globals.hh>
 #include <Geant4/G4Region.hh>
@@ -22,12 +23,14 @@
 #include <map>
 #include <set>
 #include <utility>
+#include <vector>
 
 class G4Material;
 class G4Tubs;
 class G4LogicalVolume;
 class G4VPhysicalVolume;
 class G4UserLimits;
+class PHG4SpacalFiberParameterization;
 
 class PHG4SpacalDetector : public PHG4Detector
 {
@@ -65,6 +68,13 @@ public:
     absorberactive = i;
   }
 
+  //! place the identical fibers of a sector/tower with one G4PVParameterised instead of one G4PVPlacement each
+  void
+  SetParameterizedFibers(const int i = 1)
+  {
+    parameterized_fibers = i;
+  }
+
   void
   SetDetectorType(const std::string& typ)
   {
@@ -148,6 +158,9 @@ protected:
   //! map for G4VPhysicalVolume -> fiber ID
   std::map<const G4VPhysicalVolume*, int> fiber_vol;
 
+  //! fiber logical volumes by length
+  PHG4GeometryInstancer fiber_instances;
+
   //! map for G4VPhysicalVolume -> Sector ID
   std::map<const G4VPhysicalVolume*, int> calo_vol;
 
@@ -156,6 +169,7 @@ protected:
 
   int active;
   int absorberactive;
+  int parameterized_fibers;
   int layer;
   std::string detector_type;
   std::string superdetector;
@@ -164,6 +178,9 @@ protected:
   G4UserLimits * clading_step_limits;
   G4UserLimits * fiber_core_step_limits;
 
+  //! fiber parameterisations of the G4PVParameterised volumes, G4 does not delete them
+  std::vector<PHG4SpacalFiberParameterization *> fiber_params;
+
 private:
 
   SpacalGeom_t * _geom;
@@ -0,0 +1,21 @@
+#include "PHG4SpacalFiberParameterization.h"
+
+#include <Geant4/G4VPhysicalVolume.hh>
+
+using namespace std;
+
+int
+PHG4SpacalFiberParameterization::AddFiber(const G4Transform3D &place)
+{
+  translations.push_back(place.getTranslation());
+  rotations.push_back(place.getRotation().inverse());
+  return translations.size() - 1;
+}
+
+void
+PHG4SpacalFiberParameterization::ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* physVol) const
+{
+  physVol->SetTranslation(translations[copyNo]);
+  // the physical volume keeps the pointer, the vector does not change after construction
+  physVol->SetRotation(const_cast<G4RotationMatrix *>(&rotations[copyNo]));
+}
@@ -0,0 +1,43 @@
+#ifndef __PHG4SPACALFIBERPARAMETERIZATION_H__
+#define __PHG4SPACALFIBERPARAMETERIZATION_H__
+
+#include <Geant4/globals.hh>
+#include <Geant4/G4RotationMatrix.hh>
+#include <Geant4/G4ThreeVector.hh>
+#include <Geant4/G4Transform3D.hh>
+#include <Geant4/G4VPVParameterisation.hh>
+
+#include <vector>
+
+class G4VPhysicalVolume;
+
+// Places identical fibers (same logical volume) at arbitrary positions
+// inside their mother volume, fiber i is copy number i. One
+// G4PVParameterised per tower/sector replaces one G4PVPlacement per
+// fiber, the copy numbers (fiber IDs) seen by the stepping action stay
+// the same.
+
+class PHG4SpacalFiberParameterization : public G4VPVParameterisation
+{
+public:
+
+  PHG4SpacalFiberParameterization() {}
+
+  virtual ~PHG4SpacalFiberParameterization() {}
+
+  //! add the next fiber with the same transformation a G4PVPlacement would get, returns its copy number
+  int AddFiber(const G4Transform3D &place);
+
+  int GetNFibers() const {return translations.size();}
+
+  void ComputeTransformation(const G4int copyNo,
+			     G4VPhysicalVolume* physVol) const;
+
+private:
+
+  std::vector<G4ThreeVector> translations;
+  //! frame rotations (inverse of the rotation of the fiber), as stored by G4PVPlacement
+  std::vector<G4RotationMatrix> rotations;
+};
+
+#endif
@@ -10,8 +10,9 @@
 #include "PHG4SpacalDetector.h"
 #include "PHG4CylinderGeom_Spacalv3.h"
 
+#include <g4main/PHG4CellAccumulator.h>
 #include <g4main/PHG4HitContainer.h>
-#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
 #include <g4main/PHG4HitDefs.h>
 
 #include <g4main/PHG4TrackUserInfoV1.h>
@@ -28,7 +29,7 @@ using namespace std;
 //____________________________________________________________________________..
 PHG4SpacalSteppingAction::PHG4SpacalSteppingAction(PHG4SpacalDetector* detector) :
     PHG4SteppingAction(0), detector_(detector), hits_(NULL), absorberhits_(
-        NULL), hit(NULL)
+        NULL), cells_(NULL), hit(NULL)
 {
 }
 
@@ -67,54 +68,28 @@ PHG4SpacalSteppingAction::UserSteppingAction(const G4Step* aStep, bool)
         }
       G4StepPoint * prePoint = aStep->GetPreStepPoint();
       G4StepPoint * postPoint = aStep->GetPostStepPoint();
-      int scint_id = -1;
+      int scint_id = get_scint_id(prePoint->GetTouchable(), isactive);
 
-      if (//
-          detector_->get_geom()->get_config() == PHG4SpacalDetector::SpacalGeom_t::kFullProjective_2DTaper //
-          or //
-      detector_->get_geom()->get_config() == PHG4SpacalDetector::SpacalGeom_t::kFullProjective_2DTaper_SameLengthFiberPerTower//
-      )
+      if (cells_ and isactive == PHG4SpacalDetector::FIBER_CORE)
         {
-          //SPACAL ID that is associated with towers
-          int sector_ID =0;
-          int tower_ID = 0;
-          int fiber_ID = 0;
-
-          if (isactive == PHG4SpacalDetector::FIBER_CORE)
-            {
-
-              fiber_ID = prePoint->GetTouchable()->GetReplicaNumber(1);
-              tower_ID = prePoint->GetTouchable()->GetReplicaNumber(2);
-              sector_ID  = prePoint->GetTouchable()->GetReplicaNumber(3);
-
-            }
-
-          else if (isactive == PHG4SpacalDetector::FIBER_CLADING)
-            {
-              fiber_ID = prePoint->GetTouchable()->GetReplicaNumber(0);
-              tower_ID = prePoint->GetTouchable()->GetReplicaNumber(1);
-              sector_ID  = prePoint->GetTouchable()->GetReplicaNumber(2);
-            }
-
-          else if (isactive == PHG4SpacalDetector::ABSORBER)
+          // direct cell accumulation, no hits for the fiber cores
+          if (edep > 0)
             {
-              tower_ID = prePoint->GetTouchable()->GetReplicaNumber(0);
-              sector_ID  = prePoint->GetTouchable()->GetReplicaNumber(1);
+              int trkoffset = 0;
+              if (G4VUserTrackInformation* p = aTrack->GetUserInformation())
+                {
+                  if (PHG4TrackUserInfoV1* pp =
+                      dynamic_cast<PHG4TrackUserInfoV1*>(p))
+                    {
+                      trkoffset = pp->GetTrackIdOffset();
+                      pp->SetKeep(1); // we want to keep the track
+                    }
+                }
+              cells_->add_step_edep(edep);
+              cells_->add(layer_id, scint_id, aTrack->GetTrackID() + trkoffset,
+                  edep, GetVisibleEnergyDeposition(aStep));
             }
-
-          // compact the tower/sector/fiber ID into 32 bit scint_id, so we could save some space for SPACAL hits
-          scint_id = PHG4CylinderGeom_Spacalv3::scint_id_coder(sector_ID, tower_ID, fiber_ID).scint_ID;
-
-        }
-      else
-        {
-          // other configuraitons
-          if (isactive == PHG4SpacalDetector::FIBER_CORE)
-            scint_id = prePoint->GetTouchable()->GetReplicaNumber(2);
-          else if (isactive == PHG4SpacalDetector::FIBER_CLADING)
-            scint_id = prePoint->GetTouchable()->GetReplicaNumber(1);
-          else
-            scint_id = prePoint->GetTouchable()->GetReplicaNumber(0);
+          return true;
         }
 
       //       cout << "track id " << aTrack->GetTrackID() << endl;
@@ -125,7 +100,7 @@ PHG4SpacalSteppingAction::UserSteppingAction(const G4Step* aStep, bool)
       case fGeomBoundary:
       case fUndefined:
 
-        hit = new PHG4Hitv1();
+        hit = new PHG4Hitv2();
 
         hit->set_layer((unsigned int) layer_id);
         hit->set_scint_id(scint_id); // isactive contains the scintillator slat id
@@ -253,6 +228,63 @@ PHG4SpacalSteppingAction::UserSteppingAction(const G4Step* aStep, bool)
     }
 }
 
+//____________________________________________________________________________..
+int
+PHG4SpacalSteppingAction::get_scint_id(const G4VTouchable *touchable,
+    const int isactive) const
+{
+  int scint_id = -1;
+
+  if (//
+      detector_->get_geom()->get_config() == PHG4SpacalDetector::SpacalGeom_t::kFullProjective_2DTaper //
+      or //
+  detector_->get_geom()->get_config() == PHG4SpacalDetector::SpacalGeom_t::kFullProjective_2DTaper_SameLengthFiberPerTower//
+  )
+    {
+      //SPACAL ID that is associated with towers
+      int sector_ID =0;
+      int tower_ID = 0;
+      int fiber_ID = 0;
+
+      if (isactive == PHG4SpacalDetector::FIBER_CORE)
+        {
+
+          fiber_ID = touchable->GetReplicaNumber(1);
+          tower_ID = touchable->GetReplicaNumber(2);
+          sector_ID  = touchable->GetReplicaNumber(3);
+
+        }
+
+      else if (isactive == PHG4SpacalDetector::FIBER_CLADING)
+        {
+          fiber_ID = touchable->GetReplicaNumber(0);
+          tower_ID = touchable->GetReplicaNumber(1);
+          sector_ID  = touchable->GetReplicaNumber(2);
+        }
+
+      else if (isactive == PHG4SpacalDetector::ABSORBER)
+        {
+          tower_ID = touchable->GetReplicaNumber(0);
+          sector_ID  = touchable->GetReplicaNumber(1);
+        }
+
+      // compact the tower/sector/fiber ID into 32 bit scint_id, so we could save some space for SPACAL hits
+      scint_id = PHG4CylinderGeom_Spacalv3::scint_id_coder(sector_ID, tower_ID, fiber_ID).scint_ID;
+
+    }
+  else
+    {
+      // other configuraitons
+      if (isactive == PHG4SpacalDetector::FIBER_CORE)
+        scint_id = touchable->GetReplicaNumber(2);
+      else if (isactive == PHG4SpacalDetector::FIBER_CLADING)
+        scint_id = touchable->GetReplicaNumber(1);
+      else
+        scint_id = touchable->GetReplicaNumber(0);
+    }
+  return scint_id;
+}
+
 //____________________________________________________________________________..
 void
 PHG4SpacalSteppingAction::SetInterfacePointers(PHCompositeNode* topNode)
@@ -275,6 +307,16 @@ PHG4SpacalSteppingAction::SetInterfacePointers(PHCompositeNode* topNode)
   hits_ = findNode::getClass<PHG4HitContainer>(topNode, hitnodename.c_str());
   absorberhits_ = findNode::getClass<PHG4HitContainer>(topNode,
       absorbernodename.c_str());
+  // the cell accumulator node only exists in direct cell mode
+  string cellaccnodename = "G4CELLACC_"
+      + ((detector_->SuperDetector() != "NONE") ?
+          detector_->SuperDetector() : detector_->GetName());
+  cells_ = findNode::getClass<PHG4CellAccumulator>(topNode,
+      cellaccnodename.c_str());
+  if (cells_)
+    {
+      cells_->Reset();
+    }
   // if we do not find the node we need to make it.
   if (!hits_)
     {
@@ -308,3 +350,72 @@ PHG4SpacalSteppingAction::get_zmax()
   else
     return detector_->get_geom()->get_zmax() + .0001;
 }
+
+//____________________________________________________________________________..
+int
+PHG4SpacalSteppingAction::HandlesVolume(G4VPhysicalVolume *volume)
+{
+  return (detector_->IsInCylinderActive(volume) > PHG4SpacalDetector::INACTIVE) ? 1 : 0;
+}
+
+//____________________________________________________________________________..
+int
+PHG4SpacalSteppingAction::ShowerDepositType(G4VPhysicalVolume *volume)
+{
+  int isactive = detector_->IsInCylinderActive(volume);
+  if (isactive == PHG4SpacalDetector::FIBER_CORE)
+    return 1;
+  else if (isactive > PHG4SpacalDetector::INACTIVE)
+    return 0;
+  return -1;
+}
+
+//____________________________________________________________________________..
+bool
+PHG4SpacalSteppingAction::AddShowerDeposit(const G4VTouchable *touchable,
+    const double x, const double y, const double z, const double t,
+    const double edep, const double light_yield, const bool active,
+    const int trkid)
+{
+  int isactive = detector_->IsInCylinderActive(touchable->GetVolume());
+  if (isactive <= PHG4SpacalDetector::INACTIVE)
+    return false;
+
+  int layer_id = detector_->get_Layer();
+  // an active deposit which is located in the cladding or absorber goes to the
+  // fiber core hits of the tower (fiber 0 if the point is in the absorber)
+  int scint_id = get_scint_id(touchable, isactive);
+
+  if (active and cells_)
+    {
+      cells_->add_step_edep(edep);
+      cells_->add(layer_id, scint_id, trkid, edep, light_yield);
+      return true;
+    }
+  PHG4HitContainer *container = active ? hits_ : absorberhits_;
+  if (!container)
+    {
+      // absorber hits are not stored
+      return true;
+    }
+
+  PHG4Hit *showerhit = new PHG4Hitv2();
+  showerhit->set_layer((unsigned int) layer_id);
+  showerhit->set_scint_id(scint_id);
+  for (int i = 0; i < 2; i++)
+    {
+      showerhit->set_x(i, x);
+      showerhit->set_y(i, y);
+      showerhit->set_z(i, z);
+      showerhit->set_t(i, t);
+    }
+  showerhit->set_trkid(trkid);
+  showerhit->set_edep(edep);
+  if (active)
+    {
+      showerhit->set_eion(edep);
+      showerhit->set_light_yield(light_yield);
+    }
+  container->AddHit(layer_id, showerhit);
+  return true;
+}
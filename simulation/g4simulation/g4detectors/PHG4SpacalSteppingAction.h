@@ -14,7 +14,10 @@
 #include "g4main/PHG4SteppingAction.h"
 #include <string>
 
+class G4VPhysicalVolume;
+class G4VTouchable;
 class PHG4SpacalDetector;
+class PHG4CellAccumulator;
 class PHG4Hit;
 class PHG4HitContainer;
 
@@ -36,10 +39,24 @@ public:
   virtual bool
   UserSteppingAction(const G4Step*, bool);
 
+  //! reimplemented from base class
+  virtual int
+  HandlesVolume(G4VPhysicalVolume *volume);
+
   //! reimplemented from base class
   virtual void
   SetInterfacePointers(PHCompositeNode*);
 
+  //! reimplemented from base class, the fiber cores are active
+  virtual int
+  ShowerDepositType(G4VPhysicalVolume *volume);
+
+  //! reimplemented from base class
+  virtual bool
+  AddShowerDeposit(const G4VTouchable *touchable, const double x,
+      const double y, const double z, const double t, const double edep,
+      const double light_yield, const bool active, const int trkid);
+
   double
   get_zmin();
 
@@ -47,12 +64,19 @@ public:
   get_zmax();
 private:
 
+  //! scint_id of the fiber, tower or sector for a volume with this IsInCylinderActive result
+  int
+  get_scint_id(const G4VTouchable *touchable, const int isactive) const;
+
   //! pointer to the detector
   PHG4SpacalDetector* detector_;
 
 //! pointer to hit container
   PHG4HitContainer * hits_;
   PHG4HitContainer * absorberhits_;
+
+  //! fiber core deposits are summed directly into cells if set (no hits)
+  PHG4CellAccumulator * cells_;
   PHG4Hit *hit;
 };
 
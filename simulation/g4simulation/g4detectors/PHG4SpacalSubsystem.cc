@@ -19,6 +19,7 @@
 #include <g4main/PHG4Utils.h>
 
 #include <g4main/PHG4PhenixDetector.h>
+#include <g4main/PHG4CellAccumulator.h>
 #include <g4main/PHG4HitContainer.h>
 
 #include <phool/getClass.h>
@@ -36,6 +37,8 @@ PHG4SpacalSubsystem::PHG4SpacalSubsystem( const std::string &na, const int lyr):
   eventAction_(NULL),
   active(0),
   absorberactive(0),
+  directcells(0),
+  parameterizedfibers(0),
   layer(lyr),
   lengthViaRapidityCoverage(true),
   detector_type(na),
@@ -93,6 +96,7 @@ int PHG4SpacalSubsystem::InitRun( PHCompositeNode* topNode )
 
   detector_->SetActive(active);
   detector_->SetAbsorberActive(absorberactive);
+  detector_->SetParameterizedFibers(parameterizedfibers);
   detector_->SuperDetector(superdetector);
   detector_->OverlapCheck(overlapcheck);
 
@@ -133,6 +137,29 @@ int PHG4SpacalSubsystem::InitRun( PHCompositeNode* topNode )
           cylinder_hits->AddLayer(layer);
           evtac->AddNode(nodename.str());
         }
+      if (directcells)
+        {
+          // the cell reco for direct cells (PHG4FullProjSpacalCellReco) needs the scint_id of the full projective geometries
+          if (_geom.get_config() != PHG4CylinderGeom_Spacalv1::kFullProjective_2DTaper
+              && _geom.get_config() != PHG4CylinderGeom_Spacalv1::kFullProjective_2DTaper_SameLengthFiberPerTower)
+            {
+              cout << "PHG4SpacalSubsystem::InitRun - direct cell accumulation is only implemented for the full projective SPACAL, exiting" << endl;
+              exit(1);
+            }
+          nodename.str("");
+          if (superdetector != "NONE")
+            {
+              nodename <<  "G4CELLACC_" << superdetector;
+            }
+          else
+            {
+              nodename <<  "G4CELLACC_" << detector_type << "_" << layer;
+            }
+          if (!findNode::getClass<PHG4CellAccumulator>(topNode, nodename.str().c_str()))
+            {
+              dstNode->addNode(new PHDataNode<PHG4CellAccumulator>(new PHG4CellAccumulator(), nodename.str().c_str()));
+            }
+        }
       eventAction_ = evtac;
       steppingAction_ = new PHG4SpacalSteppingAction(detector_);
     }
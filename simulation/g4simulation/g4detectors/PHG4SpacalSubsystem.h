@@ -79,6 +79,29 @@ public:
   {
     absorberactive = i;
   }
+  //! sum the fiber core deposits directly into cells instead of creating G4 hits
+  /*!
+   for the full projective SPACAL, the G4HIT node stays empty and
+   PHG4FullProjSpacalCellReco builds the cells from the accumulated deposits.
+   The cells have no g4hits, their energy per G4 track id is in
+   PHG4CylinderCell::get_g4tracks()
+   */
+  void
+  SetDirectCells(const int i = 1)
+  {
+    directcells = i;
+  }
+  //! place the fibers of a sector (non projective) or tower (same length fibers) with one G4PVParameterised
+  /*!
+   much fewer physical volumes to build and voxelize, the fiber IDs
+   (copy numbers) are unchanged. The other configurations use fibers
+   of different lengths and always place them one by one
+   */
+  void
+  SetParameterizedFibers(const int i = 1)
+  {
+    parameterizedfibers = i;
+  }
   void
   SuperDetector(const std::string &name)
   {
@@ -127,6 +150,8 @@ private:
 
   int active;
   int absorberactive;
+  int directcells;
+  int parameterizedfibers;
   int layer;
   G4bool lengthViaRapidityCoverage;
   std::string detector_type;
@@ -0,0 +1,307 @@
+// splits random segments with PHG4CellSplitter (PHG4CellGridTraversal)
+// and compares the cells and fractions with the brute force rectangle
+// test the cell recos used before (make check). Segments along a bin
+// axis are compared with the exact overlaps instead, the rectangle test
+// loses some of them to rounding.
+
+#include <g4detectors/PHG4BlockCellGeom.h>
+#include <g4detectors/PHG4CellGridTraversal.h>
+#include <g4detectors/PHG4CellSplitter.h>
+#include <g4detectors/PHG4CylinderCellDefs.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// reference: the segment/rectangle intersection of the old
+// PHG4BlockCellReco, unchanged
+
+static bool
+lines_intersect(double ax, double ay, double bx, double by,
+		double cx, double cy, double dx, double dy,
+		double *rx, double *ry)
+{
+  // Find if a line segment limited by points A and B
+  // intersects line segment limited by points C and D.
+  double ex = bx - ax; // E=B-A
+  double ey = by - ay;
+  double fx = dx - cx; // F=D-C
+  double fy = dy - cy;
+  double px = -ey;     // P
+  double py = ex;
+
+  double bottom = fx * px + fy * py; // F*P
+  double gx = ax - cx; // A-C
+  double gy = ay - cy;
+  double top = gx * px + gy * py; // G*P
+
+  double h = 99999.;
+  if (bottom != 0.)
+    {
+      h = top / bottom;
+    }
+
+  //intersection point R = C + F*h
+  if (h > 0. && h < 1.)
+    {
+      *rx = cx + fx * h;
+      *ry = cy + fy * h;
+      if ((*rx > ax && *rx > bx) || (*rx < ax && *rx < bx) || (*ry < ay && *ry < by) || (*ry > ay && *ry > by))
+	{
+	  return false;
+	}
+      else
+	{
+	  return true;
+	}
+    }
+  return false;
+}
+
+static bool
+line_and_rectangle_intersect(double ax, double ay, double bx, double by,
+			     double cx, double cy, double dx, double dy,
+			     double *rr)
+{
+  // corners C (lower left) and D (upper right), E upper left, F lower right
+  double ex = cx;
+  double ey = dy;
+  double fx = dx;
+  double fy = cy;
+  double rx = 99999.;
+  double ry = 99999.;
+
+  vector<double> vx;
+  vector<double> vy;
+
+  bool i1 = lines_intersect(ax, ay, bx, by, cx, cy, fx, fy, &rx, &ry);
+  if (i1)
+    {
+      vx.push_back(rx);
+      vy.push_back(ry);
+    }
+  bool i2 = lines_intersect(ax, ay, bx, by, fx, fy, dx, dy, &rx, &ry);
+  if (i2)
+    {
+      vx.push_back(rx);
+      vy.push_back(ry);
+    }
+  bool i3 = lines_intersect(ax, ay, bx, by, ex, ey, dx, dy, &rx, &ry);
+  if (i3)
+    {
+      vx.push_back(rx);
+      vy.push_back(ry);
+    }
+  bool i4 = lines_intersect(ax, ay, bx, by, cx, cy, ex, ey, &rx, &ry);
+  if (i4)
+    {
+      vx.push_back(rx);
+      vy.push_back(ry);
+    }
+
+  *rr = 0.;
+  if (vx.size() == 2)
+    {
+      *rr = sqrt((vx[0] - vx[1]) * (vx[0] - vx[1]) + (vy[0] - vy[1]) * (vy[0] - vy[1]));
+    }
+  if (vx.size() == 1)
+    {
+      // find which point (A or B) is within the rectangle
+      if (ax > cx && ay > cy && ax < dx && ay < dy)
+	{
+	  *rr = sqrt((vx[0] - ax) * (vx[0] - ax) + (vy[0] - ay) * (vy[0] - ay));
+	}
+      if (bx > cx && by > cy && bx < dx && by < dy)
+	{
+	  *rr = sqrt((vx[0] - bx) * (vx[0] - bx) + (vy[0] - by) * (vy[0] - by));
+	}
+    }
+  return (i1 || i2 || i3 || i4);
+}
+
+// fraction per (x bin, eta bin) as the old cell reco computed it
+static void
+brute_force(const PHG4BlockCellGeom &geo, const double ax, const double ay, const double bx, const double by,
+	    map<pair<int, int>, double> &fractions)
+{
+  int intxbin = geo.get_xbin(ax);
+  int intxbinout = geo.get_xbin(bx);
+  int intetabin = geo.get_etabin(ay);
+  int intetabinout = geo.get_etabin(by);
+  if (intxbin > intxbinout)
+    {
+      swap(intxbin, intxbinout);
+    }
+  if (intetabin > intetabinout)
+    {
+      swap(intetabin, intetabinout);
+    }
+  const double trklen = sqrt((ax - bx) * (ax - bx) + (ay - by) * (ay - by));
+  if (intxbin == intxbinout && intetabin == intetabinout)
+    {
+      fractions[make_pair(intxbin, intetabin)] = 1.;
+      return;
+    }
+  for (int ibp = intxbin; ibp <= intxbinout; ibp++)
+    {
+      for (int ibz = intetabin; ibz <= intetabinout; ibz++)
+	{
+	  double cx = geo.get_xcenter(ibp) - geo.get_xstep() / 2.;
+	  double dx = geo.get_xcenter(ibp) + geo.get_xstep() / 2.;
+	  double cy = geo.get_etacenter(ibz) - geo.get_etastep() / 2.;
+	  double dy = geo.get_etacenter(ibz) + geo.get_etastep() / 2.;
+	  double rr = 0.;
+	  if (line_and_rectangle_intersect(ax, ay, bx, by, cx, cy, dx, dy, &rr))
+	    {
+	      fractions[make_pair(ibp, ibz)] += rr / trklen;
+	    }
+	}
+    }
+  return;
+}
+
+// fraction per cell of a segment along x or along eta
+static void
+along_axis(const PHG4BlockCellGeom &geo, const double ax, const double ay, const double bx, const double by,
+	   map<pair<int, int>, double> &fractions)
+{
+  const bool along_x = (ay == by);
+  const double lo = along_x ? min(ax, bx) : min(ay, by);
+  const double hi = along_x ? max(ax, bx) : max(ay, by);
+  const double step = along_x ? geo.get_xstep() : geo.get_etastep();
+  const double start = along_x ? geo.get_xmin() : geo.get_etamin();
+  const int ibinlo = along_x ? geo.get_xbin(lo) : geo.get_etabin(lo);
+  const int ibinhi = along_x ? geo.get_xbin(hi) : geo.get_etabin(hi);
+  for (int ibin = ibinlo; ibin <= ibinhi; ibin++)
+    {
+      const double overlap = min(hi, start + (ibin + 1) * step) - max(lo, start + ibin * step);
+      if (overlap > 0 || ibinlo == ibinhi)
+	{
+	  pair<int, int> cell = along_x ? make_pair(ibin, geo.get_etabin(ay)) : make_pair(geo.get_xbin(ax), ibin);
+	  fractions[cell] = (ibinlo == ibinhi) ? 1. : overlap / (hi - lo);
+	}
+    }
+  return;
+}
+
+int
+main()
+{
+  PHG4BlockCellGeom geo;
+  geo.set_binning(PHG4CylinderCellDefs::etaslatbinning);
+  geo.set_xmin(-10.);
+  geo.set_xstep(0.2);
+  geo.set_xbins(100);
+  geo.set_etamin(-1.);
+  geo.set_etastep(0.05);
+  geo.set_etabins(40);
+
+  PHG4CellSplitter splitter(&geo, PHG4CellSplitterEtaX());
+
+  srand(4711);
+  int nfail = 0;
+  int nsplit = 0;
+  for (int i = 0; i < 200000; i++)
+    {
+      // short and long segments, some along a bin axis
+      const double scale = (i % 3) ? 1. : 0.1;
+      const double ax = -9.9 + 19.8 * rand() / (double) RAND_MAX;
+      const double ay = -0.99 + 1.98 * rand() / (double) RAND_MAX;
+      double bx = ax + scale * 4. * (rand() / (double) RAND_MAX - 0.5);
+      double by = ay + scale * 0.4 * (rand() / (double) RAND_MAX - 0.5);
+      if (i % 50 == 0)
+	{
+	  bx = ax;
+	}
+      else if (i % 50 == 1)
+	{
+	  by = ay;
+	}
+      if (bx <= -10. || bx >= 10. || by <= -1. || by >= 1.)
+	{
+	  continue;
+	}
+
+      map<pair<int, int>, double> reference;
+      if (ax == bx || ay == by)
+	{
+	  along_axis(geo, ax, ay, bx, by, reference);
+	}
+      else
+	{
+	  brute_force(geo, ax, ay, bx, by, reference);
+	}
+
+      const unsigned int ncells = splitter.Split(ax, ay, geo.get_xbin(ax), geo.get_etabin(ay),
+						 bx, by, geo.get_xbin(bx), geo.get_etabin(by));
+      map<pair<int, int>, double> split;
+      double sum = 0;
+      for (unsigned int icell = 0; icell < ncells; icell++)
+	{
+	  split[make_pair(splitter.get_xbin(icell), splitter.get_ybin(icell))] += splitter.get_fraction(icell);
+	  sum += splitter.get_fraction(icell);
+	}
+      if (ncells > 1)
+	{
+	  nsplit++;
+	}
+
+      bool ok = (fabs(sum - 1.) < 1e-9);
+      // every cell of either result has the same fraction in the other (0 if missing)
+      for (int pass = 0; pass < 2 && ok; pass++)
+	{
+	  const map<pair<int, int>, double> &from = pass ? reference : split;
+	  const map<pair<int, int>, double> &to = pass ? split : reference;
+	  for (map<pair<int, int>, double>::const_iterator iter = from.begin(); iter != from.end(); ++iter)
+	    {
+	      map<pair<int, int>, double>::const_iterator other = to.find(iter->first);
+	      const double fraction = (other == to.end()) ? 0. : other->second;
+	      if (fabs(fraction - iter->second) > 1e-9)
+		{
+		  ok = false;
+		  break;
+		}
+	    }
+	}
+      if (!ok)
+	{
+	  if (nfail < 10)
+	    {
+	      cout << "segment (" << ax << ", " << ay << ") - (" << bx << ", " << by
+		   << ") split differently, sum of fractions " << sum << endl;
+	    }
+	  nfail++;
+	}
+    }
+
+  // the traversal returns lengths which add up to the segment length
+  vector<int> xbins;
+  vector<int> ybins;
+  vector<double> lengths;
+  PHG4CellGridTraversal::Traverse(0.05, 0.05, 0.95, 0.35, 0., 0.1, 0., 0.1, 0, 0, 9, 3, xbins, ybins, lengths);
+  double length = 0;
+  for (unsigned int i = 0; i < lengths.size(); i++)
+    {
+      length += lengths[i];
+    }
+  if (fabs(length - sqrt(0.9 * 0.9 + 0.3 * 0.3)) > 1e-12 || xbins.front() != 0 || ybins.front() != 0 ||
+      xbins.back() != 9 || ybins.back() != 3)
+    {
+      cout << "traversal from cell (0, 0) to (9, 3) is wrong" << endl;
+      nfail++;
+    }
+
+  if (nfail)
+    {
+      cout << "testPHG4CellSplitter: " << nfail << " failures" << endl;
+      return 1;
+    }
+  cout << "testPHG4CellSplitter: " << nsplit << " segments over several cells split as before" << endl;
+  return 0;
+}
@@ -0,0 +1,235 @@
+// fills PHG4CylinderCellIndex with the cell keys of the cell recos and
+// compares the cells found and their order with the std::map lookup used
+// before, prints the time of both (make check)
+
+#include <g4detectors/PHG4CylinderCellIndex.h>
+#include <g4detectors/PHG4CylinderCellv1.h>
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef PHG4CylinderCellIndex::keytype keytype;
+
+static int nfail = 0;
+
+static void
+check(const bool ok, const string &what)
+{
+  if (!ok)
+    {
+      if (nfail < 10)
+	{
+	  cout << what << endl;
+	}
+      nfail++;
+    }
+}
+
+// one layer of cell keys: tracks crossing a few neighbouring bins,
+// hits of a track fire the same cells again
+struct Layer
+{
+  string name;
+  keytype nkeys; // 0: keys are not dense, the hash is used
+  vector<keytype> keys;
+};
+
+static Layer
+cylinder_layer(const unsigned int nphibins, const unsigned int nzbins, const unsigned int ntracks)
+{
+  Layer layer;
+  layer.name = "phi/z bins";
+  layer.nkeys = static_cast<keytype>(nphibins) * nzbins;
+  for (unsigned int itrack = 0; itrack < ntracks; itrack++)
+    {
+      unsigned int phibin = rand() % nphibins;
+      unsigned int zbin = rand() % nzbins;
+      for (int ihit = 0; ihit < 20; ihit++)
+	{
+	  layer.keys.push_back(static_cast<keytype>(phibin) * nzbins + zbin);
+	  // showers and loopers come back to their cells
+	  if (rand() % 3 == 0)
+	    {
+	      phibin = (phibin + 1) % nphibins;
+	    }
+	  if (rand() % 4 == 0 && zbin + 1 < nzbins)
+	    {
+	      zbin++;
+	    }
+	}
+    }
+  return layer;
+}
+
+static Layer
+silicon_layer(const unsigned int ntracks)
+{
+  // ladder z, ladder phi, strip z, strip y as PHG4SiliconTrackerCellReco
+  Layer layer;
+  layer.name = "silicon strips";
+  layer.nkeys = 0;
+  for (unsigned int itrack = 0; itrack < ntracks; itrack++)
+    {
+      const unsigned int ladderz = rand() % 4;
+      const unsigned int ladderphi = rand() % 48;
+      const unsigned int stripz = rand() % 5;
+      unsigned int stripy = rand() % 256;
+      for (int ihit = 0; ihit < 4; ihit++)
+	{
+	  layer.keys.push_back(PHG4CylinderCellIndex::key(ladderz, ladderphi, stripz, stripy));
+	  if (rand() % 2 && stripy < 255)
+	    {
+	      stripy++;
+	    }
+	}
+    }
+  return layer;
+}
+
+static Layer
+wide_layer(const unsigned int ntracks)
+{
+  // more bins than the flat array takes, (phi, z) packed in two words
+  Layer layer;
+  layer.name = "phi/z words";
+  layer.nkeys = 0;
+  for (unsigned int itrack = 0; itrack < ntracks; itrack++)
+    {
+      const unsigned int phibin = rand() % 20000;
+      unsigned int zbin = rand() % 10000;
+      for (int ihit = 0; ihit < 10; ihit++)
+	{
+	  layer.keys.push_back(PHG4CylinderCellIndex::key(phibin, zbin));
+	  if (rand() % 2)
+	    {
+	      zbin++;
+	    }
+	}
+    }
+  return layer;
+}
+
+int
+main()
+{
+  srand(2718);
+  vector<Layer> layers;
+  layers.push_back(cylinder_layer(256, 512, 500));
+  layers.push_back(cylinder_layer(2048, 4096, 2000)); // above max_dense, hash
+  layers.back().nkeys = 0;
+  layers.push_back(silicon_layer(3000));
+  layers.push_back(wide_layer(3000));
+  layers.push_back(cylinder_layer(64, 64, 50));
+
+  unsigned int maxkeys = 0;
+  for (unsigned int ilayer = 0; ilayer < layers.size(); ilayer++)
+    {
+      if (layers[ilayer].keys.size() > maxkeys)
+	{
+	  maxkeys = layers[ilayer].keys.size();
+	}
+    }
+  vector<PHG4CylinderCellv1> cells(maxkeys);
+
+  // same result as the map, new cells in the order of their first hit
+  PHG4CylinderCellIndex index;
+  for (int ievent = 0; ievent < 2; ievent++)
+    {
+      for (unsigned int ilayer = 0; ilayer < layers.size(); ilayer++)
+	{
+	  const Layer &layer = layers[ilayer];
+	  index.clear(layer.nkeys);
+	  map<keytype, PHG4CylinderCell *> reference;
+	  vector<keytype> order;
+	  for (unsigned int ikey = 0; ikey < layer.keys.size(); ikey++)
+	    {
+	      const keytype key = layer.keys[ikey];
+	      PHG4CylinderCell *&cell = index[key];
+	      PHG4CylinderCell *&refcell = reference[key];
+	      check((cell == NULL) == (refcell == NULL), layer.name + ": cell found in one lookup only");
+	      if (!refcell)
+		{
+		  refcell = &cells[order.size()];
+		  order.push_back(key);
+		}
+	      if (!cell)
+		{
+		  cell = refcell;
+		}
+	      check(cell == refcell, layer.name + ": different cell for the same key");
+	    }
+	  check(index.size() == reference.size(), layer.name + ": number of cells differs");
+	  unsigned int icell = 0;
+	  for (PHG4CylinderCellIndex::ConstIterator iter = index.begin(); iter != index.end() && icell < order.size(); ++iter, ++icell)
+	    {
+	      check(iter->first == order[icell] && iter->second == reference[order[icell]], layer.name + ": cells not in creation order");
+	    }
+	  for (int i = 0; i < 1000; i++)
+	    {
+	      const keytype key = layer.keys[rand() % layer.keys.size()] + rand() % 3;
+	      map<keytype, PHG4CylinderCell *>::const_iterator refiter = reference.find(key);
+	      check(index.find(key) == ((refiter == reference.end()) ? NULL : refiter->second), layer.name + ": find differs");
+	    }
+	}
+    }
+
+  // time both lookups on the same keys
+  const int nrepeat = 20;
+  clock_t start = clock();
+  unsigned long nmap = 0;
+  for (int irepeat = 0; irepeat < nrepeat; irepeat++)
+    {
+      for (unsigned int ilayer = 0; ilayer < layers.size(); ilayer++)
+	{
+	  map<keytype, PHG4CylinderCell *> reference;
+	  const vector<keytype> &keys = layers[ilayer].keys;
+	  for (unsigned int ikey = 0; ikey < keys.size(); ikey++)
+	    {
+	      PHG4CylinderCell *&cell = reference[keys[ikey]];
+	      if (!cell)
+		{
+		  cell = &cells[reference.size() - 1];
+		}
+	    }
+	  nmap += reference.size();
+	}
+    }
+  const double tmap = double(clock() - start) / CLOCKS_PER_SEC;
+
+  start = clock();
+  unsigned long nindex = 0;
+  for (int irepeat = 0; irepeat < nrepeat; irepeat++)
+    {
+      for (unsigned int ilayer = 0; ilayer < layers.size(); ilayer++)
+	{
+	  index.clear(layers[ilayer].nkeys);
+	  const vector<keytype> &keys = layers[ilayer].keys;
+	  for (unsigned int ikey = 0; ikey < keys.size(); ikey++)
+	    {
+	      PHG4CylinderCell *&cell = index[keys[ikey]];
+	      if (!cell)
+		{
+		  cell = &cells[index.size() - 1];
+		}
+	    }
+	  nindex += index.size();
+	}
+    }
+  const double tindex = double(clock() - start) / CLOCKS_PER_SEC;
+  check(nmap == nindex, "different number of cells in the timing loops");
+
+  if (nfail)
+    {
+      cout << "testPHG4CylinderCellIndex: " << nfail << " failures" << endl;
+      return 1;
+    }
+  cout << "testPHG4CylinderCellIndex: " << nindex << " cells found as with std::map, "
+       << "std::map " << tmap << " s, PHG4CylinderCellIndex " << tindex << " s" << endl;
+  return 0;
+}
@@ -10,6 +10,7 @@
 
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4TruthInfoContainer.h>
+#include <g4main/PHG4TruthInfoContainerFlat.h>
 #include <g4cemc/RawTowerContainer.h>
 
 #include <g4main/PHG4InEvent.h>
@@ -240,13 +241,20 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
   _vertex_map_new2old.clear();
   _particle_set.clear();
 
+  // DSTs written with PHG4TruthSubsystem::SetFlatTruth() only carry G4TruthInfoFlat
   PHG4TruthInfoContainer* truthInfoList = findNode::getClass<
       PHG4TruthInfoContainer>(topNode, "G4TruthInfo");
+  PHG4TruthInfoContainerFlat* flatTruth = NULL;
   if (!truthInfoList)
+    {
+      flatTruth = findNode::getClass<PHG4TruthInfoContainerFlat>(topNode,
+          "G4TruthInfoFlat");
+    }
+  if (!truthInfoList && !flatTruth)
     {
       if (_event < 2)
         cout
-            << "PHG4DSTReader::process_event - Error - can not find node G4TruthInfo. Quit processing!"
+            << "PHG4DSTReader::process_event - Error - can not find node G4TruthInfo or G4TruthInfoFlat. Quit processing!"
             << endl;
       return Fun4AllReturnCodes::DISCARDEVENT;
     }
@@ -483,18 +491,29 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
                   once = false;
                 }
 
-              for (particle_iter = truthInfoList->GetMap().begin();
-                  particle_iter != truthInfoList->GetMap().end();
-                  particle_iter++)
+              if (flatTruth)
                 {
+                  PHG4TruthInfoContainerFlat::ConstRange range =
+                      flatTruth->GetHitRange();
+                  for (PHG4TruthInfoContainerFlat::ConstIterator flat_iter =
+                      range.first; flat_iter != range.second; ++flat_iter)
+                    _particle_set.insert(flat_iter->first);
+                }
+              else
+                {
+                  for (particle_iter = truthInfoList->GetMap().begin();
+                      particle_iter != truthInfoList->GetMap().end();
+                      particle_iter++)
+                    {
 
-                  _particle_set.insert(particle_iter->first);
+                      _particle_set.insert(particle_iter->first);
 
-//                  PHG4Particle * part = particle_iter->second;
+//                      PHG4Particle * part = particle_iter->second;
 //
-//                  assert(part);
+//                      assert(part);
 //
-//                  add_particle(rec, part);
+//                      add_particle(rec, part);
+                    }
                 }
 
             } //          if (_load_all_particle)
@@ -531,18 +550,30 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
 //                  add_particle(rec, part);
 //                }
 
-              for (particle_iter = truthInfoList->GetMap().begin();
-                  particle_iter != truthInfoList->GetMap().end();
-                  particle_iter++)
+              if (flatTruth)
                 {
-                  if (particle_iter->second->get_parent_id()<=0)
-                    _particle_set.insert(particle_iter->first);
+                  PHG4TruthInfoContainerFlat::ConstRange range =
+                      flatTruth->GetHitRange();
+                  for (PHG4TruthInfoContainerFlat::ConstIterator flat_iter =
+                      range.first; flat_iter != range.second; ++flat_iter)
+                    if (flat_iter->second->get_parent_id() <= 0)
+                      _particle_set.insert(flat_iter->first);
+                }
+              else
+                {
+                  for (particle_iter = truthInfoList->GetMap().begin();
+                      particle_iter != truthInfoList->GetMap().end();
+                      particle_iter++)
+                    {
+                      if (particle_iter->second->get_parent_id()<=0)
+                        _particle_set.insert(particle_iter->first);
 
-//                  PHG4Particle * part = particle_iter->second;
+//                      PHG4Particle * part = particle_iter->second;
 //
-//                  assert(part);
+//                      assert(part);
 //
-//                  add_particle(rec, part);
+//                      add_particle(rec, part);
+                    }
                 }
 
             } //          if (_load_all_particle) else
@@ -550,8 +581,9 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
           for (PartSet_t::const_iterator i = _particle_set.begin();
               i != _particle_set.end(); i++)
             {
-              particle_iter = truthInfoList->GetMap().find(*i);
-              if (particle_iter == truthInfoList->GetMap().end())
+              PHG4Particle * part =
+                  flatTruth ? flatTruth->GetHit(*i) : truthInfoList->GetHit(*i);
+              if (!part)
                 {
 
                   cout
@@ -561,7 +593,6 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
                   continue;
                 }
 
-              PHG4Particle * part = particle_iter->second;
               add_particle(rec, part);
             } // for(PartSet_t::const_iterator i = _particle_set.begin();i!=_particle_set.end();i++)
 
@@ -578,9 +609,6 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
               once = false;
             }
 
-          const PHG4TruthInfoContainer::VtxMap & vmap =
-              truthInfoList->GetVtxMap();
-
           for (VtxMap_t::const_iterator i = _vertex_map_new2old.begin();
               i != _vertex_map_new2old.end(); i++)
             {
@@ -590,12 +618,12 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
 //              cout << "rec._cnt =" << rec._cnt << endl;
               assert(new_id == (int)rec._cnt);
 
-              PHG4TruthInfoContainer::VtxMap::const_iterator it_vmap =
-                  vmap.find(old_id);
+              PHG4VtxPoint * v =
+                  flatTruth ? flatTruth->GetVtx(old_id) : truthInfoList->GetVtx(old_id);
 
               new ((*(rec._arr.get()))[rec._cnt]) vertex_type();
 
-              if (it_vmap == vmap.end())
+              if (!v)
                 {
                   cout
                       << "PHG4DSTReader::process_event - ERROR - can not find vertex ID "
@@ -603,8 +631,6 @@ PHG4DSTReader::process_event(PHCompositeNode* topNode)
 
                   continue;
                 }
-              PHG4VtxPoint * v = it_vmap->second;
-              assert(v);
 
               if (Verbosity() >= 2)
                 cout << "PHG4DSTReader::process_event - saving vertex id "
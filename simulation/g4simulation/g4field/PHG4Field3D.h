@@ -45,7 +45,10 @@
 class PHG4Field3D : public G4MagneticField
 {
   typedef boost::tuple<float,float,float> trio;
-  
+
+  // PHG4FieldGrid copies the tables into its grid
+  friend class PHG4FieldGrid;
+
  public:
   
   PHG4Field3D(const std::string  &filename, int verb=0, const float magfield_rescale = 1.0);
@@ -0,0 +1,631 @@
+#include "PHG4FieldGrid.h"
+#include "PHG4Field2D.h"
+#include "PHG4Field3D.h"
+
+#include <Geant4/G4SystemOfUnits.hh>
+
+#include <TRandom3.h>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+// layout of the binary cache file: this header, zero padding up to
+// data_offset (page aligned), the grid values
+static const char cache_magic[8] = {'P', 'H', 'G', '4', 'F', 'G', 'R', 'D'};
+static const uint32_t cache_version = 2;
+
+struct PHG4FieldGridCacheHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t dim;
+  uint32_t nz;
+  uint32_t nr;
+  uint32_t nphi;
+  uint32_t ncomp;
+  float z0, dz, r0, dr, phi0, dphi, dphi_wrap, maxz, maxr, bmax;
+  //! scale factor included in the values
+  float rescale;
+  uint64_t source_size;
+  int64_t source_mtime;
+  uint64_t data_offset;
+  uint64_t data_size;
+  uint64_t checksum;
+  char source[512];
+};
+
+// FNV-1a over 32 bit words
+static uint64_t
+fnv1a(const uint32_t *words, const size_t nwords, uint64_t hash)
+{
+  for (size_t i = 0; i < nwords; i++)
+    {
+      hash ^= words[i];
+      hash *= 1099511628211ULL;
+    }
+  return hash;
+}
+
+// checksum of the header (with checksum 0) and the grid values
+static uint64_t
+grid_checksum(const PHG4FieldGridCacheHeader &header, const float *data, const size_t nfloats)
+{
+  // memcpy, an assignment need not copy the padding bytes
+  uint32_t words[sizeof(PHG4FieldGridCacheHeader) / sizeof(uint32_t)];
+  memcpy(words, &header, sizeof(words));
+  PHG4FieldGridCacheHeader *copy = reinterpret_cast<PHG4FieldGridCacheHeader *>(words);
+  copy->checksum = 0;
+  uint64_t hash = fnv1a(words, sizeof(words) / sizeof(uint32_t), 14695981039346656037ULL);
+  return fnv1a(reinterpret_cast<const uint32_t *>(data), nfloats, hash);
+}
+
+// positive grid step which is safe to divide by
+static bool
+valid_step(const float step)
+{
+  return std::isfinite(step) && step > 0 && std::isfinite(1. / step);
+}
+
+PHG4FieldGrid::PHG4FieldGrid(const string &filename, const int dim, const int verb, const float magfield_rescale, const bool use_cache):
+  dim_(dim),
+  nz_(0),
+  nr_(0),
+  nphi_(1),
+  z0_(0),
+  dz_(0),
+  inv_dz_(0),
+  r0_(0),
+  dr_(0),
+  inv_dr_(0),
+  phi0_(0),
+  dphi_(2 * M_PI),
+  inv_dphi_(0.5 / M_PI),
+  dphi_wrap_(2 * M_PI),
+  maxz_(0),
+  maxr_(0),
+  bmax_(0),
+  grid_rescale_(magfield_rescale),
+  rescale_(1),
+  field_(NULL),
+  mapped_(NULL),
+  mapped_size_(0),
+  verb_(verb)
+{
+  if (use_cache && read_cache(CacheFileName(filename), filename, dim, magfield_rescale))
+    {
+      return;
+    }
+  read_map(filename, dim, magfield_rescale);
+}
+
+PHG4FieldGrid::~PHG4FieldGrid()
+{
+  if (mapped_)
+    {
+      munmap(mapped_, mapped_size_);
+    }
+  else
+    {
+      free(field_);
+    }
+}
+
+void
+PHG4FieldGrid::read_map(const string &filename, const int dim, const float magfield_rescale)
+{
+  // the original map is the reference for the validation
+  G4MagneticField *reference = NULL;
+  switch (dim)
+    {
+    case 2:
+      {
+	PHG4Field2D *fieldmap = new PHG4Field2D(filename, verb_, magfield_rescale);
+	fill_from_map(*fieldmap);
+	reference = fieldmap;
+	break;
+      }
+    case 3:
+      {
+	PHG4Field3D *fieldmap = new PHG4Field3D(filename, verb_, magfield_rescale);
+	fill_from_map(*fieldmap);
+	reference = fieldmap;
+	break;
+      }
+    default:
+      cout << "PHG4FieldGrid: Invalid dimension " << dim
+	   << ", valid is 2 for 2D, 3 for 3D" << endl;
+      exit(1);
+    }
+  int nbad = Validate(*reference, 10000);
+  if (nbad > 0)
+    {
+      cout << "PHG4FieldGrid: the grid of " << filename << " differs from the original map at "
+	   << nbad << " points, exiting now" << endl;
+      exit(1);
+    }
+  delete reference;
+  return;
+}
+
+bool
+PHG4FieldGrid::read_cache(const string &cachefile, const string &sourcefile, const int dim, const float magfield_rescale)
+{
+  int fd = open(cachefile.c_str(), O_RDONLY);
+  if (fd < 0)
+    {
+      // no cache, not an error
+      return false;
+    }
+  struct stat cachestat;
+  struct stat sourcestat;
+  PHG4FieldGridCacheHeader header;
+  string problem;
+  if (fstat(fd, &cachestat) || read(fd, &header, sizeof(header)) != sizeof(header))
+    {
+      problem = "cannot read header";
+    }
+  else if (memcmp(header.magic, cache_magic, sizeof(cache_magic)) || header.version != cache_version)
+    {
+      problem = "not a field grid cache or wrong version";
+    }
+  else if (header.dim != static_cast<uint32_t>(dim) || header.ncomp != NCOMP)
+    {
+      problem = "grid dimension does not match";
+    }
+  else if (header.nz < 2 || header.nr < 2 || header.nphi < 1 || (dim == 2 && header.nphi != 1))
+    {
+      problem = "invalid number of grid points";
+    }
+  else if (!valid_step(header.dz) || !valid_step(header.dr) ||
+	   (header.nphi > 1 && (!valid_step(header.dphi) || !valid_step(header.dphi_wrap))))
+    {
+      problem = "invalid grid step";
+    }
+  else if (!std::isfinite(header.z0) || !std::isfinite(header.r0) || !std::isfinite(header.phi0) ||
+	   !std::isfinite(header.maxz) || !std::isfinite(header.maxr) || !std::isfinite(header.bmax))
+    {
+      problem = "invalid grid range";
+    }
+  else if (header.rescale == 0 || !std::isfinite(header.rescale))
+    {
+      problem = "invalid field rescale";
+    }
+  else if (stat(sourcefile.c_str(), &sourcestat) ||
+	   header.source_size != static_cast<uint64_t>(sourcestat.st_size) ||
+	   header.source_mtime != static_cast<int64_t>(sourcestat.st_mtime))
+    {
+      problem = "field map " + sourcefile + " changed since the cache was written";
+    }
+  else if (header.data_offset < sizeof(header) || header.data_offset % 16 ||
+	   header.data_offset > static_cast<uint64_t>(cachestat.st_size))
+    {
+      problem = "invalid data offset";
+    }
+  else
+    {
+      // grid points in the file, compared by division so the product of
+      // nonsense dimensions cannot overflow
+      const uint64_t npoints = (static_cast<uint64_t>(cachestat.st_size) - header.data_offset) / (NCOMP * sizeof(float));
+      if (header.nz > npoints || header.nr > npoints / header.nz || header.nphi > npoints / header.nz / header.nr ||
+	  header.data_size != static_cast<uint64_t>(header.nz) * header.nr * header.nphi * NCOMP * sizeof(float))
+	{
+	  problem = "file is truncated";
+	}
+    }
+  if (!problem.empty())
+    {
+      cout << "PHG4FieldGrid: ignoring cache " << cachefile << ": " << problem << endl;
+      close(fd);
+      return false;
+    }
+  mapped_size_ = header.data_offset + header.data_size;
+  mapped_ = mmap(NULL, mapped_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped_ == MAP_FAILED)
+    {
+      cout << "PHG4FieldGrid: ignoring cache " << cachefile << ": mmap failed" << endl;
+      mapped_ = NULL;
+      mapped_size_ = 0;
+      return false;
+    }
+  field_ = reinterpret_cast<float *>(static_cast<char *>(mapped_) + header.data_offset);
+  if (grid_checksum(header, field_, header.data_size / sizeof(float)) != header.checksum)
+    {
+      cout << "PHG4FieldGrid: ignoring cache " << cachefile << ": checksum mismatch" << endl;
+      munmap(mapped_, mapped_size_);
+      mapped_ = NULL;
+      mapped_size_ = 0;
+      field_ = NULL;
+      return false;
+    }
+  nz_ = header.nz;
+  nr_ = header.nr;
+  nphi_ = header.nphi;
+  z0_ = header.z0;
+  dz_ = header.dz;
+  inv_dz_ = 1. / dz_;
+  r0_ = header.r0;
+  dr_ = header.dr;
+  inv_dr_ = 1. / dr_;
+  phi0_ = header.phi0;
+  dphi_ = header.dphi;
+  inv_dphi_ = 1. / dphi_;
+  dphi_wrap_ = header.dphi_wrap;
+  maxz_ = header.maxz;
+  maxr_ = header.maxr;
+  bmax_ = header.bmax;
+  grid_rescale_ = header.rescale;
+  rescale_ = magfield_rescale / grid_rescale_;
+  if (verb_ > 0)
+    {
+      cout << "PHG4FieldGrid: using cached " << nz_ << " x " << nr_ << " x " << nphi_
+	   << " grid " << cachefile << " for " << sourcefile << endl;
+    }
+  return true;
+}
+
+int
+PHG4FieldGrid::WriteCache(const string &cachefile, const string &sourcefile) const
+{
+  struct stat sourcestat;
+  if (stat(sourcefile.c_str(), &sourcestat))
+    {
+      cout << "PHG4FieldGrid::WriteCache - cannot stat " << sourcefile << endl;
+      return -1;
+    }
+  PHG4FieldGridCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, cache_magic, sizeof(cache_magic));
+  header.version = cache_version;
+  header.dim = dim_;
+  header.nz = nz_;
+  header.nr = nr_;
+  header.nphi = nphi_;
+  header.ncomp = NCOMP;
+  header.z0 = z0_;
+  header.dz = dz_;
+  header.r0 = r0_;
+  header.dr = dr_;
+  header.phi0 = phi0_;
+  header.dphi = dphi_;
+  header.dphi_wrap = dphi_wrap_;
+  header.maxz = maxz_;
+  header.maxr = maxr_;
+  header.bmax = bmax_;
+  header.rescale = grid_rescale_;
+  header.source_size = sourcestat.st_size;
+  header.source_mtime = sourcestat.st_mtime;
+  // page aligned so the mapped grid is aligned for the SSE loads
+  header.data_offset = 4096;
+  header.data_size = static_cast<uint64_t>(nz_) * nr_ * nphi_ * NCOMP * sizeof(float);
+  strncpy(header.source, sourcefile.c_str(), sizeof(header.source) - 1);
+  header.checksum = grid_checksum(header, field_, header.data_size / sizeof(float));
+
+  ofstream fout(cachefile.c_str(), ios::binary | ios::trunc);
+  if (!fout)
+    {
+      cout << "PHG4FieldGrid::WriteCache - cannot open " << cachefile << endl;
+      return -1;
+    }
+  vector<char> padding(header.data_offset - sizeof(header), 0);
+  fout.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  fout.write(&padding[0], padding.size());
+  fout.write(reinterpret_cast<const char *>(field_), header.data_size);
+  fout.close();
+  if (!fout)
+    {
+      cout << "PHG4FieldGrid::WriteCache - error writing " << cachefile << endl;
+      return -1;
+    }
+  return 0;
+}
+
+bool
+PHG4FieldGrid::set_axis(const string &name, const vector<float> &values, float &first, float &step, float &inv_step) const
+{
+  if (values.size() < 2)
+    {
+      cout << "PHG4FieldGrid: need at least 2 " << name << " values, got " << values.size() << endl;
+      return false;
+    }
+  first = values.front();
+  step = (values.back() - values.front()) / (values.size() - 1);
+  inv_step = 1. / step;
+  for (unsigned int i = 0; i < values.size(); i++)
+    {
+      if (fabs(values[i] - (first + i * step)) > 1e-3 * step)
+	{
+	  cout << "PHG4FieldGrid: " << name << " values are not on a uniform grid, "
+	       << name << "[" << i << "] = " << values[i] << ", expected "
+	       << first + i * step << endl;
+	  return false;
+	}
+    }
+  return true;
+}
+
+void
+PHG4FieldGrid::allocate()
+{
+  void *mem = NULL;
+  // 16 byte alignment for the SSE loads of the grid points
+  if (posix_memalign(&mem, 16, nz_ * nr_ * nphi_ * NCOMP * sizeof(float)))
+    {
+      cout << "PHG4FieldGrid: could not allocate memory for "
+	   << nz_ << " x " << nr_ << " x " << nphi_ << " grid points, exiting now" << endl;
+      exit(1);
+    }
+  field_ = static_cast<float *>(mem);
+  return;
+}
+
+void
+PHG4FieldGrid::fill_from_map(const PHG4Field2D &fieldmap)
+{
+  if (!set_axis("z", fieldmap.z_map_, z0_, dz_, inv_dz_) ||
+      !set_axis("r", fieldmap.r_map_, r0_, dr_, inv_dr_))
+    {
+      cout << "PHG4FieldGrid: cannot use this field map, use PHG4Field2D instead, exiting now" << endl;
+      exit(1);
+    }
+  nz_ = fieldmap.z_map_.size();
+  nr_ = fieldmap.r_map_.size();
+  nphi_ = 1;
+  maxz_ = fieldmap.z_map_.back();
+  maxr_ = fieldmap.r_map_.back();
+  allocate();
+  for (unsigned int iz = 0; iz < nz_; iz++)
+    {
+      for (unsigned int ir = 0; ir < nr_; ir++)
+	{
+	  float *b = node(iz, ir, 0);
+	  b[0] = fieldmap.BFieldZ_[iz][ir];
+	  b[1] = fieldmap.BFieldR_[iz][ir];
+	  b[2] = 0;
+	  b[3] = 0;
+	  for (int i = 0; i < 2; i++)
+	    {
+	      bmax_ = max(bmax_, fabsf(b[i]));
+	    }
+	}
+    }
+  return;
+}
+
+void
+PHG4FieldGrid::fill_from_map(const PHG4Field3D &fieldmap)
+{
+  if (!set_axis("z", fieldmap.z_map_, z0_, dz_, inv_dz_) ||
+      !set_axis("r", fieldmap.r_map_, r0_, dr_, inv_dr_) ||
+      (fieldmap.phi_map_.size() > 1 && !set_axis("phi", fieldmap.phi_map_, phi0_, dphi_, inv_dphi_)))
+    {
+      cout << "PHG4FieldGrid: cannot use this field map, use PHG4Field3D instead, exiting now" << endl;
+      exit(1);
+    }
+  nz_ = fieldmap.z_map_.size();
+  nr_ = fieldmap.r_map_.size();
+  nphi_ = fieldmap.phi_map_.size();
+  maxz_ = fieldmap.z_map_.back();
+  maxr_ = fieldmap.r_map_.back();
+  phi0_ = fieldmap.phi_map_.front();
+  // the last phi bin interpolates to the first one
+  dphi_wrap_ = phi0_ + 2 * M_PI - fieldmap.phi_map_.back();
+  allocate();
+  for (unsigned int iz = 0; iz < nz_; iz++)
+    {
+      for (unsigned int ir = 0; ir < nr_; ir++)
+	{
+	  for (unsigned int iphi = 0; iphi < nphi_; iphi++)
+	    {
+	      float *b = node(iz, ir, iphi);
+	      b[0] = fieldmap.BFieldZ_[iz][ir][iphi];
+	      b[1] = fieldmap.BFieldR_[iz][ir][iphi];
+	      b[2] = fieldmap.BFieldPHI_[iz][ir][iphi];
+	      b[3] = 0;
+	      for (int i = 0; i < 3; i++)
+		{
+		  bmax_ = max(bmax_, fabsf(b[i]));
+		}
+	    }
+	}
+    }
+  return;
+}
+
+void PHG4FieldGrid::GetFieldValue(const double point[4], double *Bfield ) const
+{
+  double x = point[0];
+  double y = point[1];
+  double z = point[2];
+  double r = sqrt(x * x + y * y);
+  double phi = atan2(y, x);
+  if ( phi < 0 ) phi += 2 * M_PI;  // normalize phi to be over the range [0,2*pi]
+
+  double BFieldCyl[3];
+  double cylpoint[4] = { z, r, phi, 0 };
+  // take <z,r,phi> location and return a vector of <Bz, Br, Bphi>
+  GetFieldCyl( cylpoint, BFieldCyl );
+
+  double cosphi = cos(phi);
+  double sinphi = sin(phi);
+  // Bx = Br*cos(phi) - Bphi*sin(phi), By = Br*sin(phi) + Bphi*cos(phi)
+  Bfield[0] = cosphi * BFieldCyl[1] - sinphi * BFieldCyl[2];
+  Bfield[1] = sinphi * BFieldCyl[1] + cosphi * BFieldCyl[2];
+  Bfield[2] = BFieldCyl[0];
+  return;
+}
+
+void PHG4FieldGrid::GetFieldCyl( const double CylPoint[4], double *BfieldCyl ) const
+{
+  // same precision as PHG4Field2D/3D
+  float z = CylPoint[0];
+  float r = CylPoint[1];
+  float phi = CylPoint[2];
+
+  BfieldCyl[0] = 0.0;
+  BfieldCyl[1] = 0.0;
+  BfieldCyl[2] = 0.0;
+
+  // outside of the map (the last r value is outside like in the original maps)
+  if (z < z0_ || z > maxz_ || r < r0_ || r >= maxr_)
+    {
+      return;
+    }
+
+  float zpos = (z - z0_) * inv_dz_;
+  unsigned int iz = static_cast<unsigned int>(zpos);
+  if (iz > nz_ - 2)
+    {
+      iz = nz_ - 2; // z == maxz
+    }
+  float zweight = zpos - iz;
+
+  float rpos = (r - r0_) * inv_dr_;
+  unsigned int ir = static_cast<unsigned int>(rpos);
+  if (ir > nr_ - 2)
+    {
+      ir = nr_ - 2;
+    }
+  float rweight = rpos - ir;
+
+  const float *corner[8];
+  float weight[8];
+  corner[0] = node(iz, ir, 0);
+  corner[1] = node(iz, ir + 1, 0);
+  corner[2] = node(iz + 1, ir, 0);
+  corner[3] = node(iz + 1, ir + 1, 0);
+  weight[0] = (1 - zweight) * (1 - rweight);
+  weight[1] = (1 - zweight) * rweight;
+  weight[2] = zweight * (1 - rweight);
+  weight[3] = zweight * rweight;
+  int ncorners = 4;
+
+  if (nphi_ > 1)
+    {
+      float dphi = phi - phi0_;
+      if (dphi < 0)
+	{
+	  dphi += 2 * M_PI;
+	}
+      unsigned int iphi0 = static_cast<unsigned int>(dphi * inv_dphi_);
+      unsigned int iphi1 = iphi0 + 1;
+      float phiweight;
+      if (iphi0 >= nphi_ - 1)
+	{
+	  // between the last and the first phi value
+	  iphi0 = nphi_ - 1;
+	  iphi1 = 0;
+	  phiweight = min(1.f, (dphi - iphi0 * dphi_) / dphi_wrap_);
+	}
+      else
+	{
+	  phiweight = dphi * inv_dphi_ - iphi0;
+	}
+      int offset1 = (static_cast<int>(iphi1) - static_cast<int>(iphi0)) * NCOMP;
+      for (int i = 0; i < 4; i++)
+	{
+	  corner[i] += iphi0 * NCOMP;
+	  corner[i + 4] = corner[i] + offset1;
+	  weight[i + 4] = weight[i] * phiweight;
+	  weight[i] *= (1 - phiweight);
+	}
+      ncorners = 8;
+    }
+
+  float bcyl[NCOMP];
+#ifdef __SSE__
+  // all components of a grid point in one register
+  __m128 b = _mm_setzero_ps();
+  for (int i = 0; i < ncorners; i++)
+    {
+      b = _mm_add_ps(b, _mm_mul_ps(_mm_set1_ps(weight[i]), _mm_load_ps(corner[i])));
+    }
+  _mm_storeu_ps(bcyl, b);
+#else
+  for (int j = 0; j < NCOMP; j++)
+    {
+      bcyl[j] = 0;
+    }
+  for (int i = 0; i < ncorners; i++)
+    {
+      for (int j = 0; j < NCOMP; j++)
+	{
+	  bcyl[j] += weight[i] * corner[i][j];
+	}
+    }
+#endif
+  BfieldCyl[0] = bcyl[0] * rescale_;
+  BfieldCyl[1] = bcyl[1] * rescale_;
+  BfieldCyl[2] = bcyl[2] * rescale_;
+  return;
+}
+
+int
+PHG4FieldGrid::Validate(const G4MagneticField &reference, const int npoints, const double tolerance) const
+{
+  TRandom3 rnd(4357);
+  // stay away from the edges where the original maps do not interpolate
+  double zmin = z0_ + 1e-3 * dz_;
+  double zmax = maxz_ - 1e-3 * dz_;
+  double rmin = r0_ + 1e-3 * dr_;
+  double rmax = maxr_ - 1e-3 * dr_;
+  double phimin = (nphi_ > 1) ? phi0_ : 0;
+  double bscale = (bmax_ > 0) ? bmax_ : tesla;
+  double maxdiff = 0;
+  int nbad = 0;
+  for (int i = 0; i < npoints; i++)
+    {
+      double z = zmin + rnd.Rndm() * (zmax - zmin);
+      double r = rmin + rnd.Rndm() * (rmax - rmin);
+      double phi = phimin + rnd.Rndm() * (2 * M_PI - phimin);
+      double point[4] = {r * cos(phi), r * sin(phi), z, 0};
+      double bref[3];
+      double bgrid[3];
+      reference.GetFieldValue(point, bref);
+      GetFieldValue(point, bgrid);
+      bool bad = false;
+      for (int j = 0; j < 3; j++)
+	{
+	  double diff = fabs(bref[j] - bgrid[j]) / bscale;
+	  maxdiff = max(maxdiff, diff);
+	  if (diff > tolerance)
+	    {
+	      bad = true;
+	    }
+	}
+      if (bad)
+	{
+	  nbad++;
+	  if (verb_ > 1)
+	    {
+	      cout << "PHG4FieldGrid::Validate - mismatch at (z,r,phi) = (" << z / cm << ", "
+		   << r / cm << ", " << phi << "), B map: (" << bref[0] / tesla << ", "
+		   << bref[1] / tesla << ", " << bref[2] / tesla << ") T, B grid: ("
+		   << bgrid[0] / tesla << ", " << bgrid[1] / tesla << ", " << bgrid[2] / tesla
+		   << ") T" << endl;
+	    }
+	}
+    }
+  if (verb_ > 0)
+    {
+      cout << "PHG4FieldGrid::Validate - " << nz_ << " x " << nr_ << " x " << nphi_
+	   << " grid, largest difference to the original map at " << npoints
+	   << " points: " << maxdiff << " of " << bscale / tesla << " T" << endl;
+    }
+  return nbad;
+}
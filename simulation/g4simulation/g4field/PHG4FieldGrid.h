@@ -0,0 +1,108 @@
+#ifndef __PHG4FIELDGRID_H__
+#define __PHG4FIELDGRID_H__
+
+#include <Geant4/G4MagneticField.hh>
+
+#include <string>
+#include <vector>
+
+class PHG4Field2D;
+class PHG4Field3D;
+
+//! field map on a uniform (z, r, phi) grid in one contiguous array
+/*!
+  Reads the field map with PHG4Field2D (dim = 2) or PHG4Field3D (dim = 3)
+  and copies it into a single 16 byte aligned array with the components
+  Bz, Br, Bphi (plus one padding float) of a grid point next to each
+  other. Since the grid spacing is constant the cell of a point is
+  computed directly instead of searched for, the 4 (2D) or 8 (3D) corners
+  are interpolated with SSE instructions (all components at once).
+  After construction the grid is compared to the original map at random
+  points, it refuses maps which are not on a uniform grid.
+  The 2D maps are stored as 3D map with a single phi bin.
+
+  The grid can be saved in a binary cache file (phg4fieldgridcache
+  <map> <dim>, default name is CacheFileName(map)). If a valid cache for
+  the map exists it is mapped into memory instead of reading and sorting
+  the ROOT ntuple (no validation needed, header and grid have a checksum
+  and the grid dimensions and steps are range checked). The cache is only
+  used if size and modification time of the map match the ones stored in
+  the cache, otherwise the map is read from ROOT.
+*/
+class PHG4FieldGrid : public G4MagneticField
+{
+ public:
+
+  PHG4FieldGrid(const std::string &filename, const int dim, const int verb = 0, const float magfield_rescale = 1.0, const bool use_cache = true);
+  virtual ~PHG4FieldGrid();
+
+  void GetFieldValue( const double Point[4],    double *Bfield ) const;
+  void GetFieldCyl  ( const double CylPoint[4], double *Bfield ) const;
+
+  //! compare with the field of the reference at npoints random points
+  /*!
+    returns the number of points where a component differs by more
+    than tolerance (relative to the largest field value in the grid)
+  */
+  int Validate(const G4MagneticField &reference, const int npoints, const double tolerance = 1e-4) const;
+
+  void Verbosity(const int i) {verb_ = i;}
+
+  //! write the grid to a binary cache file for the map sourcefile, returns 0 on success
+  int WriteCache(const std::string &cachefile, const std::string &sourcefile) const;
+
+  //! default cache file name for a field map
+  static std::string CacheFileName(const std::string &filename) {return filename + ".grid";}
+
+ protected:
+
+  //! number of floats per grid point (Bz, Br, Bphi, padding)
+  static const int NCOMP = 4;
+
+  //! copy the tables of the original map into the grid
+  void fill_from_map(const PHG4Field2D &fieldmap);
+  void fill_from_map(const PHG4Field3D &fieldmap);
+
+  //! check that the axis values have a constant spacing and set the grid parameters
+  bool set_axis(const std::string &name, const std::vector<float> &values, float &first, float &step, float &inv_step) const;
+
+  void allocate();
+
+  //! read the original map with PHG4Field2D/3D and fill the grid
+  void read_map(const std::string &filename, const int dim, const float magfield_rescale);
+
+  //! map a cache file into memory, returns false if there is no valid cache
+  bool read_cache(const std::string &cachefile, const std::string &sourcefile, const int dim, const float magfield_rescale);
+
+  //! first value of the array for grid point (iz, ir, iphi)
+  const float *node(const unsigned int iz, const unsigned int ir, const unsigned int iphi) const
+  {return field_ + ((iz * nr_ + ir) * nphi_ + iphi) * NCOMP;}
+  float *node(const unsigned int iz, const unsigned int ir, const unsigned int iphi)
+  {return field_ + ((iz * nr_ + ir) * nphi_ + iphi) * NCOMP;}
+
+  //! dimension of the original map (2 or 3)
+  int dim_;
+  unsigned int nz_, nr_, nphi_;
+  float z0_, dz_, inv_dz_;
+  float r0_, dr_, inv_dr_;
+  float phi0_, dphi_, inv_dphi_;
+  //! distance between the last and the first phi bin (across 2 pi)
+  float dphi_wrap_;
+  float maxz_, maxr_;
+  //! largest field component in the grid, validation tolerance is relative to this
+  float bmax_;
+  //! scale factor which is included in the grid values
+  float grid_rescale_;
+  //! scale factor applied on lookup (cached grids are rescaled on the fly)
+  float rescale_;
+
+  //! grid values, iz is the slowest and the component the fastest index
+  float *field_;
+  //! memory mapped cache file (NULL if the grid was filled from the map)
+  void *mapped_;
+  size_t mapped_size_;
+  int verb_;
+
+};
+
+#endif // __PHG4FIELDGRID_H__
@@ -0,0 +1,32 @@
+// writes the binary cache of a field map for PHG4FieldGrid
+// usage: phg4fieldgridcache <field map root file> <dim 2|3> [<cache file>]
+
+#include "PHG4FieldGrid.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int
+main(int argc, char *argv[])
+{
+  if (argc < 3 || argc > 4)
+    {
+      cout << "usage: " << argv[0] << " <field map root file> <dim 2|3> [<cache file>]" << endl
+	   << "default cache file is <field map root file>.grid which is picked up by PHG4FieldGrid" << endl;
+      return 1;
+    }
+  string fieldmap = argv[1];
+  int dim = atoi(argv[2]);
+  string cachefile = (argc > 3) ? argv[3] : PHG4FieldGrid::CacheFileName(fieldmap);
+  // always from the root file (and validated), the cache is written without rescaling
+  PHG4FieldGrid grid(fieldmap, dim, 1, 1.0, false);
+  if (grid.WriteCache(cachefile, fieldmap))
+    {
+      return 1;
+    }
+  cout << "wrote " << cachefile << endl;
+  return 0;
+}
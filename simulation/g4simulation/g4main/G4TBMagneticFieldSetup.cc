@@ -36,6 +36,7 @@
 
 #include <g4field/PHG4Field2D.h>
 #include <g4field/PHG4Field3D.h>
+#include <g4field/PHG4FieldGrid.h>
 #include <g4field/PHG4FieldsPHENIX.h>
 
 #include <fun4all/Fun4AllServer.h>
@@ -100,7 +101,7 @@ G4TBMagneticFieldSetup::G4TBMagneticFieldSetup(const float magfield)
 
 /////////////////////////////////////////////////////////////////////////////////
 
-G4TBMagneticFieldSetup::G4TBMagneticFieldSetup(const string &fieldmapname, const int dim, const float magfield_rescale)
+G4TBMagneticFieldSetup::G4TBMagneticFieldSetup(const string &fieldmapname, const int dim, const float magfield_rescale, const bool grid)
   : verbosity(0),
     fChordFinder(0), 
     fStepper(0),
@@ -113,10 +114,24 @@ G4TBMagneticFieldSetup::G4TBMagneticFieldSetup(const string &fieldmapname, const
       fEMfield = new PHG4FieldsPHENIX(fieldmapname,magfield_rescale);
       break;
     case 2: 
-      fEMfield = new PHG4Field2D(fieldmapname,0,magfield_rescale);
+      if (grid)
+	{
+	  fEMfield = new PHG4FieldGrid(fieldmapname,dim,0,magfield_rescale);
+	}
+      else
+	{
+	  fEMfield = new PHG4Field2D(fieldmapname,0,magfield_rescale);
+	}
       break;
     case 3:
-      fEMfield = new PHG4Field3D(fieldmapname,0,magfield_rescale);
+      if (grid)
+	{
+	  fEMfield = new PHG4FieldGrid(fieldmapname,dim,0,magfield_rescale);
+	}
+      else
+	{
+	  fEMfield = new PHG4Field3D(fieldmapname,0,magfield_rescale);
+	}
       break;
     default:
       cout << "Invalid dimension, valid is 2 for 2D, 3 for 3D" << endl;
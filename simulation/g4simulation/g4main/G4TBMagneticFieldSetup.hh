@@ -55,7 +55,8 @@ class G4TBMagneticFieldSetup
 public:
 
   G4TBMagneticFieldSetup(const float magfield) ;
-  G4TBMagneticFieldSetup(const std::string &fieldmapfile, const int mapdim, const float magfield_rescale = 1.0) ;
+  //! grid: use PHG4FieldGrid for 2D and 3D maps
+  G4TBMagneticFieldSetup(const std::string &fieldmapfile, const int mapdim, const float magfield_rescale = 1.0, const bool grid = false) ;
 
   virtual ~G4TBMagneticFieldSetup() ;  
 
@@ -0,0 +1,179 @@
+#include "PHG4ActionInitialization.h"
+
+#ifdef G4MULTITHREADED
+
+#include "G4TBMagneticFieldSetup.hh"
+#include "PHG4PhenixSteppingAction.h"
+#include "PHG4PhenixTrackingAction.h"
+#include "PHG4PrimaryGeneratorAction.h"
+#include "PHG4SteppingAction.h"
+#include "PHG4Subsystem.h"
+#include "PHG4TrackingAction.h"
+
+#include <Geant4/G4AutoLock.hh>
+#include <Geant4/G4Event.hh>
+#include <Geant4/G4UserEventAction.hh>
+
+#include <boost/foreach.hpp>
+
+using namespace std;
+
+// serializes the access of the workers to the node tree, taken once per G4Event
+static G4Mutex worker_mutex = G4MUTEX_INITIALIZER;
+
+//! primary generator of a worker, takes the input event from the master generator
+class PHG4WorkerPrimaryGeneratorAction: public PHG4PrimaryGeneratorAction
+{
+ public:
+  PHG4WorkerPrimaryGeneratorAction(const PHG4PrimaryGeneratorAction *master):
+    master_(master)
+  {}
+
+  virtual ~PHG4WorkerPrimaryGeneratorAction() {}
+
+  void GeneratePrimaries(G4Event *anEvent)
+  {
+    // the master sets the input event and the number of sub events before BeamOn
+    SetInEvent(master_->GetInEvent());
+    SetNumberOfSubEvents(master_->GetNumberOfSubEvents());
+    PHG4PrimaryGeneratorAction::GeneratePrimaries(anEvent);
+  }
+
+ private:
+  const PHG4PrimaryGeneratorAction *master_;
+};
+
+//! connects the worker actions to the node tree and moves their output there
+class PHG4WorkerEventAction: public G4UserEventAction
+{
+ public:
+  PHG4WorkerEventAction(PHCompositeNode *topNode, const list<PHG4SteppingAction *> &actions,
+			const list<PHG4TrackingAction *> &trackingactions, G4TBMagneticFieldSetup *field):
+    topNode_(topNode),
+    actions_(actions),
+    trackingActions_(trackingactions),
+    field_(field)
+  {}
+
+  // the worker owns its actions and its field
+  virtual ~PHG4WorkerEventAction()
+  {
+    while (actions_.begin() != actions_.end())
+      {
+	delete actions_.back();
+	actions_.pop_back();
+      }
+    while (trackingActions_.begin() != trackingActions_.end())
+      {
+	delete trackingActions_.back();
+	trackingActions_.pop_back();
+      }
+    delete field_;
+  }
+
+  void BeginOfEventAction(const G4Event *)
+  {
+    if (actions_.empty())
+      {
+	return;
+      }
+    G4AutoLock lock(&worker_mutex);
+    BOOST_FOREACH(PHG4SteppingAction *action, actions_)
+      {
+	action->SetInterfacePointers(topNode_);
+      }
+  }
+
+  void EndOfEventAction(const G4Event *)
+  {
+    if (actions_.empty() && trackingActions_.empty())
+      {
+	return;
+      }
+    G4AutoLock lock(&worker_mutex);
+    BOOST_FOREACH(PHG4SteppingAction *action, actions_)
+      {
+	action->FlushWorkerOutput();
+      }
+    BOOST_FOREACH(PHG4TrackingAction *action, trackingActions_)
+      {
+	action->FlushWorkerOutput();
+      }
+  }
+
+ private:
+  PHCompositeNode *topNode_;
+  list<PHG4SteppingAction *> actions_;
+  list<PHG4TrackingAction *> trackingActions_;
+  G4TBMagneticFieldSetup *field_;
+};
+
+PHG4ActionInitialization::PHG4ActionInitialization( PHG4PrimaryGeneratorAction *generator,
+                                                    const list<PHG4Subsystem *> &subsystems, PHCompositeNode *topNode ):
+  generatorAction_(generator),
+  subsystems_(subsystems),
+  topNode_(topNode),
+  fieldmapfile("NONE"),
+  mapdim(0),
+  magfield(0),
+  magfield_rescale(1.0),
+  fieldmap_grid(false)
+{}
+
+void
+PHG4ActionInitialization::SetField(const string &fmap, const int dim, const float tesla, const float rescale, const bool grid)
+{
+  fieldmapfile = fmap;
+  mapdim = dim;
+  magfield = tesla;
+  magfield_rescale = rescale;
+  fieldmap_grid = grid;
+}
+
+void
+PHG4ActionInitialization::Build() const
+{
+  // the field manager is thread local, every worker needs its own field
+  G4TBMagneticFieldSetup *field = NULL;
+  {
+    // the field map reading is not thread safe (ROOT i/o)
+    G4AutoLock lock(&worker_mutex);
+    if (fieldmapfile != "NONE")
+      {
+	field = new G4TBMagneticFieldSetup(fieldmapfile, mapdim, magfield_rescale, fieldmap_grid);
+      }
+    else
+      {
+	field = new G4TBMagneticFieldSetup(magfield * magfield_rescale);
+      }
+  }
+
+  PHG4PhenixSteppingAction *steppingAction = new PHG4PhenixSteppingAction();
+  PHG4PhenixTrackingAction *trackingAction = new PHG4PhenixTrackingAction();
+  list<PHG4SteppingAction *> worker_actions;
+  list<PHG4TrackingAction *> worker_trackingactions;
+  // PHG4Reco::InitRun made sure all subsystems with stepping or tracking actions support this
+  BOOST_FOREACH(PHG4Subsystem * g4sub, subsystems_)
+    {
+      if (g4sub->GetSteppingAction())
+	{
+	  PHG4SteppingAction *action = g4sub->CreateWorkerSteppingAction();
+	  steppingAction->AddAction(action);
+	  worker_actions.push_back(action);
+	}
+      if (g4sub->GetTrackingAction())
+	{
+	  // truth of a worker goes into its own buffer, no locking per track
+	  PHG4TrackingAction *action = g4sub->CreateWorkerTrackingAction();
+	  trackingAction->AddAction(action);
+	  worker_trackingactions.push_back(action);
+	}
+    }
+
+  SetUserAction(new PHG4WorkerPrimaryGeneratorAction(generatorAction_));
+  SetUserAction(steppingAction);
+  SetUserAction(trackingAction);
+  SetUserAction(new PHG4WorkerEventAction(topNode_, worker_actions, worker_trackingactions, field));
+}
+
+#endif // G4MULTITHREADED
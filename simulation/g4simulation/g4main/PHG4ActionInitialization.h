@@ -0,0 +1,66 @@
+#ifndef PHG4ActionInitialization_h
+#define PHG4ActionInitialization_h
+
+#include <Geant4/G4Types.hh>
+
+// the worker thread setup is only needed (and possible) with a multi threaded G4
+#ifdef G4MULTITHREADED
+
+#include <Geant4/G4VUserActionInitialization.hh>
+
+#include <list>
+#include <string>
+
+class PHCompositeNode;
+class PHG4PrimaryGeneratorAction;
+class PHG4Subsystem;
+
+//! builds the user actions of the G4 worker threads for multi threaded running
+/*!
+  The geometry and the physics tables are shared by all workers. Every worker gets
+  - its own primary generator which picks its share of the input event
+  - its own stepping actions, created by the subsystems (PHG4Subsystem::CreateWorkerSteppingAction)
+    which keep their hits in thread local buffers. These are moved to the node tree at the end
+    of each G4Event (PHG4SteppingAction::FlushWorkerOutput)
+  - its own tracking actions (PHG4Subsystem::CreateWorkerTrackingAction), the truth
+    of a worker is kept in its own buffer and moved with the hits
+  - its own magnetic field setup (the G4 field manager is thread local)
+  The node tree is only locked for moving the output, once per G4Event.
+  The event actions of the master are run once per input event by PHG4Reco after all
+  G4Events are done.
+  PHG4Reco refuses multi threaded running if a subsystem cannot provide worker actions.
+*/
+class PHG4ActionInitialization: public G4VUserActionInitialization
+{
+ public:
+
+  PHG4ActionInitialization( PHG4PrimaryGeneratorAction *generator,
+                            const std::list<PHG4Subsystem *> &subsystems, PHCompositeNode *topNode );
+
+  virtual ~PHG4ActionInitialization() {}
+
+  //! nothing to do for the master, its actions are called by PHG4Reco
+  virtual void BuildForMaster() const {}
+
+  //! create the actions of a worker thread
+  virtual void Build() const;
+
+  //! magnetic field settings, needed to replicate the field on the workers
+  void SetField(const std::string &fmap, const int dim, const float tesla, const float rescale, const bool grid);
+
+ private:
+
+  PHG4PrimaryGeneratorAction *generatorAction_;
+  std::list<PHG4Subsystem *> subsystems_;
+  PHCompositeNode *topNode_;
+
+  std::string fieldmapfile;
+  int mapdim;
+  float magfield;
+  float magfield_rescale;
+  bool fieldmap_grid;
+};
+
+#endif // G4MULTITHREADED
+
+#endif
@@ -0,0 +1,166 @@
+#include "PHG4CellAccumulator.h"
+
+using namespace std;
+
+void
+PHG4CellAccumulator::Reset()
+{
+  cells.clear();
+  tracks.clear();
+  cell_index.clear();
+  track_index.clear();
+  step_edep = 0;
+  return;
+}
+
+void
+PHG4CellAccumulator::add(const unsigned int layer, const unsigned int cellkey, const int trkid, const double edep, const double light_yield)
+{
+  const unsigned int icell = cell_index.find_or_insert((static_cast<keytype>(layer) << 32) | cellkey, cells.size());
+  if (icell == cells.size())
+    {
+      Cell cell;
+      cell.layer = layer;
+      cell.key = cellkey;
+      cell.edep = 0;
+      cell.light_yield = 0;
+      cells.push_back(cell);
+    }
+  Cell &cell = cells[icell];
+  cell.edep += edep;
+  cell.light_yield += light_yield;
+
+  const unsigned int itrack = track_index.find_or_insert((static_cast<keytype>(icell) << 32) | static_cast<unsigned int>(trkid), tracks.size());
+  if (itrack == tracks.size())
+    {
+      TrackEdep track;
+      track.cell = icell;
+      track.trkid = trkid;
+      track.edep = 0;
+      tracks.push_back(track);
+    }
+  tracks[itrack].edep += edep;
+  return;
+}
+
+void
+PHG4CellAccumulator::RemapTracks(const map<int, int> &newids)
+{
+  if (newids.empty())
+    {
+      return;
+    }
+  vector<TrackEdep> oldtracks;
+  oldtracks.swap(tracks);
+  track_index.clear();
+  for (vector<TrackEdep>::const_iterator iter = oldtracks.begin(); iter != oldtracks.end(); ++iter)
+    {
+      map<int, int>::const_iterator newid = newids.find(iter->trkid);
+      const int trkid = (newid == newids.end()) ? iter->trkid : newid->second;
+      const unsigned int itrack = track_index.find_or_insert((static_cast<keytype>(iter->cell) << 32) | static_cast<unsigned int>(trkid), tracks.size());
+      if (itrack == tracks.size())
+	{
+	  tracks.push_back(*iter);
+	  tracks.back().trkid = trkid;
+	}
+      else
+	{
+	  tracks[itrack].edep += iter->edep;
+	}
+    }
+  return;
+}
+
+double
+PHG4CellAccumulator::get_edep() const
+{
+  double esum = 0;
+  for (ConstIterator citer = cells.begin(); citer != cells.end(); ++citer)
+    {
+      esum += citer->edep;
+    }
+  return esum;
+}
+
+void
+PHG4CellAccumulator::identify(ostream& os) const
+{
+  os << "PHG4CellAccumulator: " << size() << " cells, "
+     << tracks.size() << " track contributions, total edep: " << get_edep()
+     << ", edep of the steps: " << step_edep << endl;
+}
+
+unsigned int
+PHG4CellAccumulator::Index::slot(const keytype key) const
+{
+  // fibonacci hashing, the packed keys are far from random
+  return static_cast<unsigned int>((key * 0x9E3779B97F4A7C15ULL) >> (64 - bits));
+}
+
+void
+PHG4CellAccumulator::Index::rehash(const unsigned int size)
+{
+  vector<keytype> oldkeys;
+  vector<unsigned int> oldvalues;
+  for (vector<unsigned int>::const_iterator iter = used.begin(); iter != used.end(); ++iter)
+    {
+      oldkeys.push_back(keys[*iter]);
+      oldvalues.push_back(values[*iter]);
+    }
+  bits = 0;
+  while ((1U << bits) < size)
+    {
+      bits++;
+    }
+  keys.assign(1U << bits, 0);
+  values.assign(1U << bits, 0);
+  used.clear();
+  const unsigned int mask = (1U << bits) - 1;
+  for (unsigned int i = 0; i < oldkeys.size(); i++)
+    {
+      unsigned int s = slot(oldkeys[i]);
+      while (values[s])
+	{
+	  s = (s + 1) & mask;
+	}
+      keys[s] = oldkeys[i];
+      values[s] = oldvalues[i];
+      used.push_back(s);
+    }
+  return;
+}
+
+unsigned int
+PHG4CellAccumulator::Index::find_or_insert(const keytype key, const unsigned int size)
+{
+  // keep the load below 1/2
+  if (2 * (used.size() + 1) > values.size())
+    {
+      rehash((values.empty()) ? (1 << 10) : 2 * values.size());
+    }
+  const unsigned int mask = values.size() - 1;
+  unsigned int s = slot(key);
+  while (values[s])
+    {
+      if (keys[s] == key)
+	{
+	  return values[s] - 1;
+	}
+      s = (s + 1) & mask;
+    }
+  keys[s] = key;
+  values[s] = size + 1;
+  used.push_back(s);
+  return size;
+}
+
+void
+PHG4CellAccumulator::Index::clear()
+{
+  for (vector<unsigned int>::const_iterator iter = used.begin(); iter != used.end(); ++iter)
+    {
+      values[*iter] = 0;
+    }
+  used.clear();
+  return;
+}
@@ -0,0 +1,110 @@
+#ifndef PHG4CellAccumulator_H
+#define PHG4CellAccumulator_H
+
+#include <iostream>
+#include <map>
+#include <vector>
+
+//! energy deposits summed directly into cells by a stepping action
+/*!
+  Used instead of G4 hits when the hit level truth is not needed. The
+  stepping action adds the energy and light yield of every step to the
+  cell (identified by the same key the cell reco derives from the hits,
+  e.g. the scint_id for the full projective spacal), the cell reco module
+  converts the accumulated cells into the usual PHG4CylinderCellContainer.
+  The contributions are kept per G4 track id (in place of the g4hit id).
+  Lives on the node tree as PHDataNode (not written out), cleared by the
+  stepping action at the beginning of every event.
+
+  Cells and track contributions are flat lists in the order they were
+  first hit, found through open addressing hashes on (layer, cell key)
+  and (cell, track id). Reset only clears the used slots, the memory is
+  kept for the next event.
+*/
+class PHG4CellAccumulator
+{
+ public:
+
+  struct Cell
+  {
+    unsigned int layer;
+    unsigned int key;
+    double edep;
+    double light_yield;
+  };
+
+  //! energy deposit of one G4 track in one cell
+  struct TrackEdep
+  {
+    //! index of the cell in the cell list
+    unsigned int cell;
+    int trkid;
+    float edep;
+  };
+
+  typedef std::vector<Cell>::const_iterator ConstIterator;
+  typedef std::pair<ConstIterator, ConstIterator> ConstRange;
+  typedef std::vector<TrackEdep>::const_iterator TrackIterator;
+  typedef std::pair<TrackIterator, TrackIterator> TrackRange;
+
+  PHG4CellAccumulator(): step_edep(0) {}
+  virtual ~PHG4CellAccumulator() {}
+
+  void Reset();
+
+  //! add the deposit of one step
+  void add(const unsigned int layer, const unsigned int cellkey, const int trkid, const double edep, const double light_yield);
+
+  //! cells in the order they were first hit
+  ConstRange getCells() const {return std::make_pair(cells.begin(), cells.end());}
+  const Cell &getCell(const unsigned int i) const {return cells[i];}
+
+  //! track contributions of all cells
+  TrackRange getTracks() const {return std::make_pair(tracks.begin(), tracks.end());}
+
+  //! replace the track ids found in newids (old id -> new id), merges the
+  //! contributions which end up with the same track in a cell
+  void RemapTracks(const std::map<int, int> &newids);
+
+  //! energy the stepping action handed over, summed independently of the cells
+  void add_step_edep(const double e) {step_edep += e;}
+  double get_step_edep() const {return step_edep;}
+
+  //! total energy in all cells
+  double get_edep() const;
+
+  unsigned int size() const {return cells.size();}
+
+  void identify(std::ostream& os = std::cout) const;
+
+ protected:
+
+  typedef unsigned long long keytype;
+
+  //! open addressing hash from a packed key to a list index
+  class Index
+  {
+  public:
+    Index(): bits(0) {}
+    //! list index of key, size if the key is new (the caller appends it)
+    unsigned int find_or_insert(const keytype key, const unsigned int size);
+    void clear();
+  protected:
+    unsigned int slot(const keytype key) const;
+    void rehash(const unsigned int size);
+    // power of 2 size, linear probing
+    std::vector<keytype> keys;
+    // list index + 1 per slot, 0 is empty
+    std::vector<unsigned int> values;
+    std::vector<unsigned int> used;
+    unsigned int bits;
+  };
+
+  std::vector<Cell> cells;
+  std::vector<TrackEdep> tracks;
+  Index cell_index;
+  Index track_index;
+  double step_edep;
+};
+
+#endif
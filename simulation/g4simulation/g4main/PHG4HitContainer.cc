@@ -1,35 +1,58 @@
 #include "PHG4HitContainer.h"
 #include "PHG4Hit.h"
-#include "PHG4Hitv1.h"
+#include "PHG4Hitv2.h"
 #include "PHG4HitDefs.h"
 
 #include <phool/phool.h>
 
+#include <algorithm>
 #include <cstdlib>
 
 using namespace std;
 
-PHG4HitContainer::PHG4HitContainer()
+// sort criteria for the hit array, only the key matters
+static bool
+entry_less(const PHG4HitContainer::Entry &lhs, const PHG4HitContainer::Entry &rhs)
+{
+  return lhs.first < rhs.first;
+}
+
+static bool
+entry_key_less(const PHG4HitContainer::Entry &lhs, const PHG4HitDefs::keytype key)
+{
+  return lhs.first < key;
+}
+
+static bool
+key_entry_less(const PHG4HitDefs::keytype key, const PHG4HitContainer::Entry &rhs)
+{
+  return key < rhs.first;
+}
+
+PHG4HitContainer::PHG4HitContainer():
+  nsorted(0)
 {
 }
 
 void
 PHG4HitContainer::Reset()
 {
-   while(hitmap.begin() != hitmap.end())
-     {
-       delete hitmap.begin()->second;
-       hitmap.erase(hitmap.begin());
-     }
+  for (Iterator iter = hitmap.begin(); iter != hitmap.end(); ++iter)
+    {
+      delete iter->second;
+    }
+  hitmap.clear();
+  nsorted = 0;
+  maxhitid.clear();
   return;
 }
 
 void
 PHG4HitContainer::identify(ostream& os) const
 {
-   ConstIterator iter;
+   ConstRange hitrange = getHits();
    os << "Number of hits: " << size() << endl;
-   for (iter = hitmap.begin(); iter != hitmap.end(); ++iter)
+   for (ConstIterator iter = hitrange.first; iter != hitrange.second; ++iter)
      {
        os << "hit key 0x" << hex << iter->first << dec << endl;
        (iter->second)->identify();
@@ -43,26 +66,90 @@ PHG4HitContainer::identify(ostream& os) const
   return;
 }
 
+void
+PHG4HitContainer::Sort() const
+{
+  // version 1 files have no nsorted, their hits are sorted anyway
+  if (nsorted > hitmap.size())
+    {
+      nsorted = 0;
+    }
+  if (nsorted == hitmap.size())
+    {
+      return;
+    }
+  Vector::iterator middle = hitmap.begin() + nsorted;
+  sort(middle, hitmap.end(), entry_less);
+  inplace_merge(hitmap.begin(), middle, hitmap.end(), entry_less);
+  nsorted = hitmap.size();
+  return;
+}
+
+PHG4HitContainer::Iterator
+PHG4HitContainer::append(const PHG4HitDefs::keytype key, PHG4Hit *newhit)
+{
+  PHG4HitDefs::keytype detidlong = key >> PHG4HitDefs::hit_idbits;
+  unsigned int detid = detidlong;
+  PHG4HitDefs::keytype hitid = key - (detidlong << PHG4HitDefs::hit_idbits);
+  // fills the bookkeeping of this layer from the existing hits if needed
+  if (getmaxkey(detid) < hitid)
+    {
+      maxhitid[detid] = hitid;
+    }
+  // appending in increasing key order keeps the array sorted
+  if (nsorted == hitmap.size() && (hitmap.empty() || hitmap.back().first < key))
+    {
+      nsorted++;
+    }
+  hitmap.push_back(make_pair(key, newhit));
+  return hitmap.end() - 1;
+}
+
+PHG4HitContainer::Iterator
+PHG4HitContainer::find(const PHG4HitDefs::keytype key)
+{
+  if (hitmap.size() > nsorted + max_unsorted)
+    {
+      Sort();
+    }
+  Iterator middle = hitmap.begin() + nsorted;
+  Iterator iter = lower_bound(hitmap.begin(), middle, key, entry_key_less);
+  if (iter != middle && iter->first == key)
+    {
+      return iter;
+    }
+  for (iter = middle; iter != hitmap.end(); ++iter)
+    {
+      if (iter->first == key)
+        {
+          return iter;
+        }
+    }
+  return hitmap.end();
+}
+
 PHG4HitDefs::keytype
 PHG4HitContainer::getmaxkey(const unsigned int detid)
 {
-  ConstRange miter = getHits(detid);
-  // first handle 2 special cases where there is no hit in the current layer
-  // no hits in this layer and higher layers (lower layers can contain hits)
-    if (miter.first == hitmap.end())
+  map<unsigned int, PHG4HitDefs::keytype>::const_iterator maxiter = maxhitid.find(detid);
+  if (maxiter != maxhitid.end())
     {
-      return 0;
+      return maxiter->second;
     }
-  // no hits in this layer - but hits in higher layers
-  if (miter.first == miter.second)
+  // first hit of this layer since the last reset or hits read from file,
+  // look at the sorted array once
+  PHG4HitDefs::keytype iret = 0;
+  ConstRange miter = getHits(detid);
+  // no hits in this layer
+  if (miter.first != miter.second)
     {
-      return  0;
+      PHG4HitDefs::keytype detidlong = detid;
+      PHG4HitDefs::keytype shiftval = detidlong << PHG4HitDefs::hit_idbits;
+      ConstIterator lastlayerentry = miter.second;
+      --lastlayerentry;
+      iret = lastlayerentry->first - shiftval; // subtract layer mask
     }
-  PHG4HitDefs::keytype detidlong = detid;
-  PHG4HitDefs::keytype shiftval = detidlong << PHG4HitDefs::hit_idbits;
-  ConstIterator lastlayerentry = miter.second;
-  --lastlayerentry;
-  PHG4HitDefs::keytype iret = lastlayerentry->first - shiftval; // subtract layer mask
+  maxhitid[detid] = iret;
   return iret;
 }
 
@@ -77,22 +164,11 @@ PHG4HitContainer::genkey(const unsigned int detid)
     }
   PHG4HitDefs::keytype detidlong = detid;
   PHG4HitDefs::keytype shiftval = detidlong << PHG4HitDefs::hit_idbits;
-  //  cout << "max index: " << (detminmax->second)->first << endl;
-  // after removing hits with no energy deposition, we have holes
-  // in our hit ranges. This construct will get us the last hit in
-  // a layer and return it's hit id. Adding 1 will put us at the end of this layer
+  // the highest hit id of the layer is bookkept, hits removed with no
+  // energy deposition do not lower it. Adding 1 gives an unused id
   PHG4HitDefs::keytype hitid = getmaxkey(detid);
   hitid++;
   PHG4HitDefs::keytype newkey = hitid | shiftval;
-  if (hitmap.find(newkey) != hitmap.end())
-    {
-      cout << PHWHERE << " duplicate key: 0x" 
-           << hex << newkey << dec 
-	   << " for detector " << detid 
-	   << " hitmap.size: " << hitmap.size()
-	   << " hitid: " << hitid << " exiting now" << endl;
-            exit(1);
-    }
   return newkey;
 }
 
@@ -100,26 +176,27 @@ PHG4HitContainer::ConstIterator
 PHG4HitContainer::AddHit(PHG4Hit *newhit)
 {
   PHG4HitDefs::keytype key = newhit->get_hit_id();
-  if (hitmap.find(key) != hitmap.end())
+  Iterator iter = find(key);
+  if (iter != hitmap.end())
     {
       cout << "hit with id  0x" << hex << key << dec << " exists already" << endl;
-      return hitmap.find(key);
+      return iter;
     }
   PHG4HitDefs::keytype detidlong = key >>  PHG4HitDefs::hit_idbits;
   unsigned int detid = detidlong;
   layers.insert(detid);
-  hitmap[key] = newhit;
-  return hitmap.find(key);
+  return append(key, newhit);
 }
 
 PHG4HitContainer::ConstIterator
 PHG4HitContainer::AddHit(const unsigned int detid, PHG4Hit *newhit)
 {
+  // genkey hands out ids above all existing ones in this layer,
+  // no need to check for duplicates
   PHG4HitDefs::keytype key = genkey(detid);
   layers.insert(detid);
   newhit->set_hit_id(key);
-  hitmap[key] = newhit;
-  return hitmap.find(key);
+  return append(key, newhit);
 }
 
 PHG4HitContainer::ConstRange PHG4HitContainer::getHits(const unsigned int detid) const
@@ -129,67 +206,77 @@ PHG4HitContainer::ConstRange PHG4HitContainer::getHits(const unsigned int detid)
       cout << " detector id too large: " << detid << endl;
       exit(1);
     }
+  Sort();
   PHG4HitDefs::keytype detidlong = detid;
   PHG4HitDefs::keytype keylow = detidlong << PHG4HitDefs::hit_idbits;
   PHG4HitDefs::keytype keyup = ((detidlong + 1) << PHG4HitDefs::hit_idbits) -1 ;
+  const Vector &sorted_hits = hitmap;
   ConstRange retpair;
-  retpair.first = hitmap.lower_bound(keylow);
-  retpair.second = hitmap.upper_bound(keyup);
+  retpair.first = lower_bound(sorted_hits.begin(), sorted_hits.end(), keylow, entry_key_less);
+  retpair.second = upper_bound(retpair.first, sorted_hits.end(), keyup, key_entry_less);
   return retpair;
 }
 
 PHG4HitContainer::ConstRange PHG4HitContainer::getHits( void ) const
-{ return std::make_pair( hitmap.begin(), hitmap.end() ); }
+{
+  Sort();
+  const Vector &sorted_hits = hitmap;
+  return std::make_pair( sorted_hits.begin(), sorted_hits.end() );
+}
+
+PHG4HitContainer::Range PHG4HitContainer::getHits_Modify( void )
+{
+  Sort();
+  return std::make_pair( hitmap.begin(), hitmap.end() );
+}
 
 
 PHG4HitContainer::Iterator PHG4HitContainer::findOrAddHit(PHG4HitDefs::keytype key)
 {
-  PHG4HitContainer::Iterator it = hitmap.find(key);
+  Iterator it = find(key);
   if(it == hitmap.end())
   {
-    hitmap[key] = new PHG4Hitv1();
-    it = hitmap.find(key);
-    PHG4Hit* mhit = it->second;
+    PHG4Hit* mhit = new PHG4Hitv2();
     mhit->set_hit_id(key);
     mhit->set_edep(0.);
     layers.insert(mhit->get_layer()); // add layer to our set of layers
+    it = append(key, mhit);
   }
   return it;
 }
 
 PHG4Hit* PHG4HitContainer::findHit(PHG4HitDefs::keytype key)
 {
-  PHG4HitContainer::ConstIterator it = hitmap.find(key);
+  Iterator it = find(key);
   if(it != hitmap.end())
     {
       return it->second;
     }
-    
+
   return NULL;
 }
 
 void
 PHG4HitContainer::RemoveZeroEDep()
 {
-  //  unsigned int hitsbef = hitmap.size();
-  Iterator itr = hitmap.begin();
-  Iterator last = hitmap.end();
-  for (; itr != last; )
+  // compact the array in place, this keeps the order of the remaining hits
+  Iterator keep = hitmap.begin();
+  unsigned int nsorted_keep = 0;
+  for (Iterator itr = hitmap.begin(); itr != hitmap.end(); ++itr)
     {
-      PHG4Hit *hit = itr->second;
-      if (hit->get_edep() == 0)
+      if (itr->second->get_edep() == 0)
         {
-          delete hit;
-          hitmap.erase(itr++);
-        }
-      else
-        {
-          ++itr;
+          delete itr->second;
+          continue;
         }
+      if (itr - hitmap.begin() < (int) nsorted)
+	{
+	  nsorted_keep++;
+	}
+      *keep = *itr;
+      ++keep;
     }
-//   unsigned int hitsafter = hitmap.size();
-//   cout << "hist before: " << hitsbef
-//        << ", hits after: " << hitsafter << endl;
+  hitmap.erase(keep, hitmap.end());
+  nsorted = nsorted_keep;
   return;
 }
-
@@ -6,15 +6,30 @@
 #include <phool/PHObject.h>
 #include <map>
 #include <set>
+#include <utility>
+#include <vector>
 class PHG4Hit;
 
+//! hit container which keeps its hits in one array sorted by key
+/*!
+  The hits are stored in a vector of (key, hit) pairs. The layer is in
+  the upper bits of the key, so the hits of a layer form a contiguous
+  block once the array is sorted and getHits(detid) finds this block by
+  binary search. New hits are appended. The array is sorted on the first
+  read, typically once at the end of the event, by merging the unsorted
+  tail into the sorted part. Lookups by key (findHit(), findOrAddHit())
+  scan at most max_unsorted unsorted hits and merge a longer tail first.
+  The iterators behave like the map iterators of version 1 (->first is
+  the key, ->second the hit) but adding a hit invalidates them.
+*/
 class PHG4HitContainer: public PHObject
 {
 
   public:
-  typedef std::map<PHG4HitDefs::keytype, PHG4Hit *> Map;
-  typedef Map::iterator Iterator;
-  typedef Map::const_iterator ConstIterator;
+  typedef std::pair<PHG4HitDefs::keytype, PHG4Hit *> Entry;
+  typedef std::vector<Entry> Vector;
+  typedef Vector::iterator Iterator;
+  typedef Vector::const_iterator ConstIterator;
   typedef std::pair<Iterator, Iterator> Range;
   typedef std::pair<ConstIterator, ConstIterator> ConstRange;
   typedef std::set<unsigned int>::const_iterator LayerIter;
@@ -43,6 +58,9 @@ class PHG4HitContainer: public PHObject
   //! return all hist
   ConstRange getHits( void ) const;
 
+  //! return all hits for modification (e.g. replacing them by a different hit version)
+  Range getHits_Modify( void );
+
   unsigned int size( void ) const
   { return hitmap.size(); }
   unsigned int num_layers(void) const
@@ -53,11 +71,26 @@ class PHG4HitContainer: public PHObject
   void RemoveZeroEDep();
   PHG4HitDefs::keytype getmaxkey(const unsigned int detid);
 
+  //! sort the hits which were added since the last sort into the array
+  void Sort() const;
+
  protected:
-  Map hitmap;
+  Iterator append(const PHG4HitDefs::keytype key, PHG4Hit *newhit);
+  Iterator find(const PHG4HitDefs::keytype key);
+
+  //! longest unsorted tail find() scans instead of sorting
+  static const unsigned int max_unsorted = 16;
+
+  // same name as the std::map of version 1 so ROOT converts old files,
+  // mutable since the hits get sorted on first read access
+  mutable Vector hitmap;
+  //! number of entries at the beginning of hitmap which are sorted
+  mutable unsigned int nsorted;
   std::set<unsigned int> layers; // layers is not reset since layers must not change event by event
+  //! highest hit id per layer (not written out, filled from the hits on first use)
+  std::map<unsigned int, PHG4HitDefs::keytype> maxhitid; //!
 
-  ClassDef(PHG4HitContainer,1)
+  ClassDef(PHG4HitContainer,2)
 };
 
 #endif
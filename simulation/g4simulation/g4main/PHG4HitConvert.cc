@@ -0,0 +1,155 @@
+#include "PHG4HitConvert.h"
+#include "PHG4Hit.h"
+#include "PHG4HitContainer.h"
+#include "PHG4Hitv1.h"
+#include "PHG4Hitv2.h"
+
+#include <fun4all/Fun4AllReturnCodes.h>
+#include <phool/getClass.h>
+#include <phool/PHTimer.h>
+
+#include <climits>
+#include <iostream>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+// node of the std::map holding the properties of PHG4Hitv1: the value
+// plus parent, left, right pointers and the color of the tree
+static const size_t map_node_bytes = 4 * sizeof(void *) + sizeof(pair<const uint8_t, uint32_t>);
+
+PHG4HitConvert::PHG4HitConvert(const string &name):
+  SubsysReco(name),
+  benchmark(false),
+  nhits(0),
+  nprops(0),
+  v1_timer(NULL),
+  v2_timer(NULL)
+{}
+
+PHG4HitConvert::~PHG4HitConvert()
+{
+  delete v1_timer;
+  delete v2_timer;
+}
+
+int
+PHG4HitConvert::Init(PHCompositeNode *topNode)
+{
+  if (benchmark)
+    {
+      v1_timer = new PHTimer("PHG4Hitv1 fill");
+      v2_timer = new PHTimer("PHG4Hitv2 fill");
+    }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int
+PHG4HitConvert::process_event(PHCompositeNode *topNode)
+{
+  for (set<string>::const_iterator iter = nodes.begin(); iter != nodes.end(); ++iter)
+    {
+      PHG4HitContainer *hits = findNode::getClass<PHG4HitContainer>(topNode, iter->c_str());
+      if (!hits)
+	{
+	  if (verbosity > 0)
+	    {
+	      cout << Name() << ": could not find node " << *iter << endl;
+	    }
+	  continue;
+	}
+      PHG4HitContainer::Range range = hits->getHits_Modify();
+      vector<PHG4Hit *> oldhits;
+      for (PHG4HitContainer::Iterator hititer = range.first; hititer != range.second; ++hititer)
+	{
+	  if (dynamic_cast<PHG4Hitv1 *>(hititer->second))
+	    {
+	      oldhits.push_back(hititer->second);
+	    }
+	}
+      if (oldhits.empty())
+	{
+	  continue;
+	}
+      nhits += oldhits.size();
+
+      if (benchmark)
+	{
+	  for (vector<PHG4Hit *>::const_iterator hititer = oldhits.begin(); hititer != oldhits.end(); ++hititer)
+	    {
+	      for (unsigned char ic = 0; ic < UCHAR_MAX; ic++)
+		{
+		  if ((*hititer)->has_property(static_cast<PHG4Hit::PROPERTY>(ic)))
+		    {
+		      nprops++;
+		    }
+		}
+	    }
+	  // time the filling of the same hits as PHG4Hitv1
+	  vector<PHG4Hit *> v1hits;
+	  v1hits.reserve(oldhits.size());
+	  v1_timer->restart();
+	  for (vector<PHG4Hit *>::const_iterator hititer = oldhits.begin(); hititer != oldhits.end(); ++hititer)
+	    {
+	      PHG4Hit *hit = new PHG4Hitv1();
+	      hit->Copy(**hititer);
+	      v1hits.push_back(hit);
+	    }
+	  v1_timer->stop();
+	  for (vector<PHG4Hit *>::const_iterator hititer = v1hits.begin(); hititer != v1hits.end(); ++hititer)
+	    {
+	      delete *hititer;
+	    }
+	}
+
+      vector<PHG4Hit *> newhits;
+      newhits.reserve(oldhits.size());
+      if (benchmark)
+	{
+	  v2_timer->restart();
+	}
+      for (vector<PHG4Hit *>::const_iterator hititer = oldhits.begin(); hititer != oldhits.end(); ++hititer)
+	{
+	  newhits.push_back(new PHG4Hitv2(**hititer));
+	}
+      if (benchmark)
+	{
+	  v2_timer->stop();
+	}
+
+      // the hits were collected in map order
+      vector<PHG4Hit *>::const_iterator newiter = newhits.begin();
+      for (PHG4HitContainer::Iterator hititer = range.first; hititer != range.second; ++hititer)
+	{
+	  if (dynamic_cast<PHG4Hitv1 *>(hititer->second))
+	    {
+	      delete hititer->second;
+	      hititer->second = *newiter;
+	      ++newiter;
+	    }
+	}
+    }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+int
+PHG4HitConvert::End(PHCompositeNode *topNode)
+{
+  if (verbosity > 0)
+    {
+      cout << Name() << ": converted " << nhits << " hits" << endl;
+    }
+  if (benchmark && nhits > 0)
+    {
+      cout << Name() << ": " << (double) nprops / nhits << " properties per hit (bytes counted from the hit sizes, measured fill time)" << endl;
+      // the hits are all the same size, a PHG4Hitv1 adds the map nodes
+      const double v1_bytes = sizeof(PHG4Hitv1) + (double) nprops / nhits * map_node_bytes;
+      const double v2_bytes = sizeof(PHG4Hitv2);
+      cout << "PHG4Hitv1: " << v1_bytes << " bytes/hit, fill "
+	   << v1_timer->get_accumulated_time() * 1000. / nhits << " us/hit" << endl;
+      cout << "PHG4Hitv2: " << v2_bytes << " bytes/hit, fill "
+	   << v2_timer->get_accumulated_time() * 1000. / nhits << " us/hit" << endl;
+    }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
@@ -0,0 +1,44 @@
+#ifndef __PHG4HITCONVERT_H__
+#define __PHG4HITCONVERT_H__
+
+#include <fun4all/SubsysReco.h>
+
+#include <set>
+#include <string>
+
+class PHTimer;
+
+//! replaces the PHG4Hitv1 hits in the given hit nodes by compact PHG4Hitv2 hits
+/*!
+  Meant for reading old DSTs, the converted containers are written out with
+  PHG4Hitv2 hits. With SetBenchmark() the memory of the hits of both
+  versions (object size plus the property map nodes of PHG4Hitv1) and the
+  time to fill them is measured on the converted hits and printed at the
+  end of the run.
+*/
+class PHG4HitConvert : public SubsysReco
+{
+ public:
+  PHG4HitConvert(const std::string &name="PHG4HITCONVERT");
+  virtual ~PHG4HitConvert();
+
+  int Init(PHCompositeNode *topNode);
+  int process_event(PHCompositeNode *topNode);
+  int End(PHCompositeNode *topNode);
+
+  //! hit node to convert (e.g. G4HIT_CEMC), can be called multiple times
+  void AddNode(const std::string &name) {nodes.insert(name);}
+
+  //! measure memory and fill time of PHG4Hitv1 and PHG4Hitv2
+  void SetBenchmark(const bool b = true) {benchmark = b;}
+
+ protected:
+  std::set<std::string> nodes;
+  bool benchmark;
+  unsigned long long nhits;
+  unsigned long long nprops;
+  PHTimer *v1_timer;
+  PHTimer *v2_timer;
+};
+
+#endif
@@ -3,16 +3,21 @@
 // first classes with streamers
 #pragma link C++ class PHG4Hit+;
 #pragma link C++ class PHG4Hitv1+;
+#pragma link C++ class PHG4Hitv2+;
 #pragma link C++ class PHG4HitEval+;
 #pragma link C++ class PHG4HitContainer+;
 #pragma link C++ class PHG4Particle+;
 #pragma link C++ class PHG4Particlev1+;
 #pragma link C++ class PHG4Particlev2+;
 #pragma link C++ class PHG4TruthInfoContainer+;
+#pragma link C++ class std::pair<int, PHG4Particle*>+;
+#pragma link C++ class std::pair<int, PHG4VtxPoint*>+;
+#pragma link C++ class PHG4TruthInfoContainerFlat+;
 #pragma link C++ class PHG4VtxPoint+;
 #pragma link C++ class PHG4VtxPointv1+;
 
 // now classes we want to see on the cmd line
+#pragma link C++ class PHG4HitConvert-!;
 #pragma link C++ class PHG4HitReadBack-!;
 #pragma link C++ namespace PHG4HitDefs-!;
 
@@ -0,0 +1,247 @@
+#include "PHG4Hitv2.h"
+#include "PHG4HitDefs.h"
+
+#include <phool/phool.h>
+
+#include <cstdlib>
+
+using namespace std;
+
+ClassImp(PHG4Hitv2)
+
+PHG4Hitv2::PHG4Hitv2():
+ hitid(ULONG_LONG_MAX),
+ trackid(INT_MIN),
+ edep(NAN),
+ prop_mask(0)
+{
+  for (int i = 0; i<2;i++)
+    {
+      set_x(i,NAN);
+      set_y(i,NAN);
+      set_z(i,NAN);
+      set_t(i,NAN);
+    }
+  for (int i = 0; i < slot_MAX_NUMBER; i++)
+    {
+      properties[i] = 0;
+    }
+}
+
+PHG4Hitv2::PHG4Hitv2(PHG4Hit const &g4hit):
+  prop_mask(0)
+{
+  for (int i = 0; i < slot_MAX_NUMBER; i++)
+    {
+      properties[i] = 0;
+    }
+  Copy(g4hit);
+  // PHG4Hitv1 keeps the ladder z index in the ladder phi index property,
+  // take the value it reports
+  if (!is_set(slot_ladder_z_index) && g4hit.get_ladder_z_index() != INT_MIN)
+    {
+      set_ladder_z_index(g4hit.get_ladder_z_index());
+    }
+}
+
+int
+PHG4Hitv2::get_slot(const PROPERTY prop_id)
+{
+  switch (prop_id)
+    {
+    case prop_eion:
+      return slot_eion;
+    case prop_light_yield:
+      return slot_light_yield;
+    case prop_px_0:
+      return slot_px_0;
+    case prop_px_1:
+      return slot_px_1;
+    case prop_py_0:
+      return slot_py_0;
+    case prop_py_1:
+      return slot_py_1;
+    case prop_pz_0:
+      return slot_pz_0;
+    case prop_pz_1:
+      return slot_pz_1;
+    case prop_path_length:
+      return slot_path_length;
+    case prop_layer:
+      return slot_layer;
+    case prop_scint_id:
+      return slot_scint_id;
+    case prop_strip_z_index:
+      return slot_strip_z_index;
+    case prop_strip_y_index:
+      return slot_strip_y_index;
+    case prop_ladder_z_index:
+      return slot_ladder_z_index;
+    case prop_ladder_phi_index:
+      return slot_ladder_phi_index;
+    case prop_index_i:
+      return slot_index_i;
+    case prop_index_j:
+      return slot_index_j;
+    case prop_index_k:
+      return slot_index_k;
+    case prop_index_l:
+      return slot_index_l;
+    default:
+      break;
+    }
+  return -1;
+}
+
+void
+PHG4Hitv2::print() const {
+  std::cout<<"New Hitv2  0x"<< hex << hitid
+	   << dec << "  on track "<<trackid<<" EDep "<<edep<<std::endl;
+  std::cout<<"Location: X "<<x[0]<<"/"<<x[1]<<"  Y "<<y[0]<<"/"<<y[1]<<"  Z "<<z[0]<<"/"<<z[1]<<std::endl;
+  std::cout<<"Time        "<<t[0]<<"/"<<t[1]<<std::endl;
+
+  for (unsigned char ic = 0; ic < UCHAR_MAX; ic++)
+    {
+      PROPERTY prop_id = static_cast<PROPERTY>(ic);
+      if (!has_property(prop_id))
+	{
+	  continue;
+	}
+      pair<const string, PROPERTY_TYPE> property_info = get_property_info(prop_id);
+      cout << "\t" << prop_id << ":\t" << property_info.first << " = \t";
+      switch(property_info.second)
+	{
+	case type_int:
+	  cout << get_property_int(prop_id);
+	  break;
+	case type_uint:
+	  cout << get_property_uint(prop_id);
+	  break;
+	case type_float:
+	  cout << get_property_float(prop_id);
+	  break;
+	default:
+	  cout << " unknown type ";
+	}
+      cout <<endl;
+    }
+}
+
+bool
+PHG4Hitv2::has_property(const PROPERTY prop_id) const
+{
+  int slot = get_slot(prop_id);
+  if (slot < 0)
+    {
+      return false;
+    }
+  return is_set(slot);
+}
+
+float
+PHG4Hitv2::get_property_float(const PROPERTY prop_id) const
+{
+  if (!check_property(prop_id,type_float))
+    {
+      pair<const string,PROPERTY_TYPE> property_info =get_property_info(prop_id);
+      cout << PHWHERE << " Property " << property_info.first << " with id "
+           << prop_id << " is of type " << get_property_type(property_info.second)
+	   << " not " << get_property_type(type_float) << endl;
+      exit(1);
+    }
+  return get_float(get_slot(prop_id));
+}
+
+int
+PHG4Hitv2::get_property_int(const PROPERTY prop_id) const
+{
+  if (!check_property(prop_id,type_int))
+    {
+      pair<const string,PROPERTY_TYPE> property_info =get_property_info(prop_id);
+      cout << PHWHERE << " Property " << property_info.first << " with id "
+           << prop_id << " is of type " << get_property_type(property_info.second)
+	   << " not " << get_property_type(type_int) << endl;
+      exit(1);
+    }
+  return get_int(get_slot(prop_id));
+}
+
+unsigned int
+PHG4Hitv2::get_property_uint(const PROPERTY prop_id) const
+{
+  if (!check_property(prop_id,type_uint))
+    {
+      pair<const string,PROPERTY_TYPE> property_info =get_property_info(prop_id);
+      cout << PHWHERE << " Property " << property_info.first << " with id "
+           << prop_id << " is of type " << get_property_type(property_info.second)
+	   << " not " << get_property_type(type_uint) << endl;
+      exit(1);
+    }
+  return get_uint(get_slot(prop_id));
+}
+
+void
+PHG4Hitv2::set_property(const PROPERTY prop_id, const float value)
+{
+  if (!check_property(prop_id,type_float))
+    {
+      pair<const string,PROPERTY_TYPE> property_info = get_property_info(prop_id);
+      cout << PHWHERE << " Property " << property_info.first << " with id "
+           << prop_id << " is of type " << get_property_type(property_info.second)
+	   << " not " << get_property_type(type_float) << endl;
+      exit(1);
+    }
+  set_slot(get_slot(prop_id), u_property(value).get_storage());
+}
+
+void
+PHG4Hitv2::set_property(const PROPERTY prop_id, const int value)
+{
+  if (!check_property(prop_id,type_int))
+    {
+      pair<const string,PROPERTY_TYPE> property_info = get_property_info(prop_id);
+      cout << PHWHERE << " Property " << property_info.first << " with id "
+           << prop_id << " is of type " << get_property_type(property_info.second)
+	   << " not " << get_property_type(type_int) << endl;
+      exit(1);
+    }
+  set_slot(get_slot(prop_id), u_property(value).get_storage());
+}
+
+void
+PHG4Hitv2::set_property(const PROPERTY prop_id, const unsigned int value)
+{
+  if (!check_property(prop_id,type_uint))
+    {
+      pair<const string,PROPERTY_TYPE> property_info = get_property_info(prop_id);
+      cout << PHWHERE << " Property " << property_info.first << " with id "
+           << prop_id << " is of type " << get_property_type(property_info.second)
+	   << " not " << get_property_type(type_uint) << endl;
+      exit(1);
+    }
+  set_slot(get_slot(prop_id), u_property(value).get_storage());
+}
+
+unsigned int
+PHG4Hitv2::get_property_nocheck(const PROPERTY prop_id) const
+{
+  int slot = get_slot(prop_id);
+  if (slot >= 0 && is_set(slot))
+    {
+      return properties[slot];
+    }
+  return UINT_MAX;
+}
+
+void
+PHG4Hitv2::set_property_nocheck(const PROPERTY prop_id, const unsigned int ui)
+{
+  int slot = get_slot(prop_id);
+  if (slot < 0)
+    {
+      cout << PHWHERE << " Property with id " << prop_id
+	   << " has no slot in PHG4Hitv2, dropping it" << endl;
+      return;
+    }
+  set_slot(slot, ui);
+}
@@ -0,0 +1,164 @@
+#ifndef PHG4Hitv2_H__
+#define PHG4Hitv2_H__
+
+#include "PHG4Hit.h"
+#include "PHG4HitDefs.h"
+
+#include <stdint.h>
+
+//! compact hit, the properties live in a fixed array inside the hit
+/*!
+  Same content as PHG4Hitv1 but every property has a fixed slot in a small
+  array (plus a bit mask telling which ones are set) instead of an entry
+  in a std::map. A hit is a single allocation and the named accessors
+  (get_light_yield() etc.) read their slot directly without lookup or
+  type check. PHG4Hitv1 hits (e.g. from old DSTs) are converted by the
+  copy constructor or in bulk by PHG4HitConvert.
+
+  Unlike PHG4Hitv1, which stores the ladder z index in the ladder phi
+  index property, the ladder z index has its own slot. Silicon tracker
+  hits simulated with PHG4Hitv2 therefore carry the real ladder z index
+  and their cells are found at the right ladder; old simulations had
+  ladder z = ladder phi. Converted PHG4Hitv1 hits keep the value v1
+  reports, so old DSTs give the same cells as before.
+*/
+class PHG4Hitv2 : public PHG4Hit
+{
+ public:
+  PHG4Hitv2();
+  explicit PHG4Hitv2(const PHG4Hit &g4hit);
+  // The indices here represent the entry and exit points of the particle
+  float get_x(const int i) const {return x[i];}
+  float get_y(const int i) const {return y[i];}
+  float get_z(const int i) const {return z[i];}
+  float get_t(const int i) const {return t[i];}
+  float get_edep() const {return edep;}
+  PHG4HitDefs::keytype get_hit_id() const {return hitid;}
+  int get_trkid() const {return trackid;}
+
+  void set_x(const int i, const float f) {x[i]=f;}
+  void set_y(const int i, const float f) {y[i]=f;}
+  void set_z(const int i, const float f) {z[i]=f;}
+  void set_t(const int i, const float f) {t[i]=f;}
+  void set_edep(const float f) {edep = f;}
+  void set_hit_id(const PHG4HitDefs::keytype i) {hitid=i;}
+  void set_trkid(const int i) {trackid=i;}
+
+  virtual void print() const;
+
+  bool  has_property(const PROPERTY prop_id) const;
+  float get_property_float(const PROPERTY prop_id) const;
+  int   get_property_int(const PROPERTY prop_id) const;
+  unsigned int   get_property_uint(const PROPERTY prop_id) const;
+  void  set_property(const PROPERTY prop_id, const float value);
+  void  set_property(const PROPERTY prop_id, const int value);
+  void  set_property(const PROPERTY prop_id, const unsigned int value);
+
+  virtual float get_px(const int i) const {return get_float(i ? slot_px_1 : slot_px_0);}
+  virtual float get_py(const int i) const {return get_float(i ? slot_py_1 : slot_py_0);}
+  virtual float get_pz(const int i) const {return get_float(i ? slot_pz_1 : slot_pz_0);}
+  virtual float get_eion() const          {return get_float(slot_eion);}
+  virtual float get_light_yield() const   {return get_float(slot_light_yield);}
+  virtual float get_path_length() const   {return get_float(slot_path_length);}
+  virtual unsigned int get_layer() const  {return get_uint(slot_layer);}
+  virtual int get_scint_id() const        {return get_int(slot_scint_id);}
+  virtual int get_strip_z_index() const   {return get_int(slot_strip_z_index);}
+  virtual int get_strip_y_index() const   {return get_int(slot_strip_y_index);}
+  virtual int get_ladder_z_index() const  {return get_int(slot_ladder_z_index);}
+  virtual int get_ladder_phi_index() const{return get_int(slot_ladder_phi_index);}
+  virtual int get_index_i() const {return get_int(slot_index_i);}
+  virtual int get_index_j() const {return get_int(slot_index_j);}
+  virtual int get_index_k() const {return get_int(slot_index_k);}
+  virtual int get_index_l() const {return get_int(slot_index_l);}
+
+  virtual void set_px(const int i, const float f) {set_slot(i ? slot_px_1 : slot_px_0, u_property(f).get_storage());}
+  virtual void set_py(const int i, const float f) {set_slot(i ? slot_py_1 : slot_py_0, u_property(f).get_storage());}
+  virtual void set_pz(const int i, const float f) {set_slot(i ? slot_pz_1 : slot_pz_0, u_property(f).get_storage());}
+  virtual void set_eion(const float f)            {set_slot(slot_eion, u_property(f).get_storage());}
+  virtual void set_light_yield(const float f)     {set_slot(slot_light_yield, u_property(f).get_storage());}
+  virtual void set_path_length(const float f)     {set_slot(slot_path_length, u_property(f).get_storage());}
+  virtual void set_layer(const unsigned int i)    {set_slot(slot_layer, u_property(i).get_storage());}
+  virtual void set_scint_id(const int i)          {set_slot(slot_scint_id, u_property(i).get_storage());}
+  virtual void set_strip_z_index(const int i)     {set_slot(slot_strip_z_index, u_property(i).get_storage());}
+  virtual void set_strip_y_index(const int i)     {set_slot(slot_strip_y_index, u_property(i).get_storage());}
+  virtual void set_ladder_z_index(const int i)    {set_slot(slot_ladder_z_index, u_property(i).get_storage());}
+  virtual void set_ladder_phi_index(const int i)  {set_slot(slot_ladder_phi_index, u_property(i).get_storage());}
+  virtual void set_index_i(const int i)  {set_slot(slot_index_i, u_property(i).get_storage());}
+  virtual void set_index_j(const int i)  {set_slot(slot_index_j, u_property(i).get_storage());}
+  virtual void set_index_k(const int i)  {set_slot(slot_index_k, u_property(i).get_storage());}
+  virtual void set_index_l(const int i)  {set_slot(slot_index_l, u_property(i).get_storage());}
+
+ protected:
+  unsigned int get_property_nocheck(const PROPERTY prop_id) const;
+  void set_property_nocheck(const PROPERTY prop_id,const unsigned int ui);
+
+  //! position of each property in the property array
+  enum SLOT
+  {
+    slot_eion = 0,
+    slot_light_yield,
+    slot_px_0,
+    slot_px_1,
+    slot_py_0,
+    slot_py_1,
+    slot_pz_0,
+    slot_pz_1,
+    slot_path_length,
+    slot_layer,
+    slot_scint_id,
+    slot_strip_z_index,
+    slot_strip_y_index,
+    slot_ladder_z_index,
+    slot_ladder_phi_index,
+    slot_index_i,
+    slot_index_j,
+    slot_index_k,
+    slot_index_l,
+    slot_MAX_NUMBER
+  };
+
+  //! slot of a property, -1 if this property has no slot
+  static int get_slot(const PROPERTY prop_id);
+
+  //! storage types for additional property
+  typedef uint32_t prop_storage_t;
+
+  //! convert between 32bit inputs and storage type prop_storage_t
+  union u_property{
+    float fdata;
+    int32_t idata;
+    uint32_t uidata;
+
+    u_property(int32_t in): idata(in) {}
+    u_property(uint32_t in): uidata(in) {}
+    u_property(float in): fdata(in) {}
+    u_property(): uidata(0) {}
+
+    prop_storage_t get_storage() const {return uidata;}
+  };
+
+  bool is_set(const int slot) const {return (prop_mask >> slot) & 0x1;}
+  void set_slot(const int slot, const prop_storage_t value) {properties[slot] = value; prop_mask |= (0x1U << slot);}
+  float get_float(const int slot) const {return is_set(slot) ? u_property(properties[slot]).fdata : NAN;}
+  int get_int(const int slot) const {return is_set(slot) ? u_property(properties[slot]).idata : INT_MIN;}
+  unsigned int get_uint(const int slot) const {return is_set(slot) ? u_property(properties[slot]).uidata : UINT_MAX;}
+
+  // Store both the entry and exit points of the particle
+  // Remember, particles do not always enter on the inner edge!
+  float x[2];
+  float y[2];
+  float z[2];
+  float t[2];
+  PHG4HitDefs::keytype hitid;
+  int trackid;
+  float edep;
+
+  //! bit i is set if slot i of properties contains a value
+  uint32_t prop_mask;
+  //! fixed storage for the additional properties
+  prop_storage_t properties[slot_MAX_NUMBER];
+
+  ClassDef(PHG4Hitv2,1)
+};
+
+#endif
@@ -1,5 +1,7 @@
 #include "PHG4InEventCompress.h"
 #include "PHG4InEvent.h"
+#include "PHG4InEventPacked.h"
+#include "PHG4InEventReadBack.h"
 #include "PHG4VtxPoint.h"
 #include "PHG4Particle.h"
 
@@ -12,17 +14,51 @@
 
 #include <phool/PHCompositeNode.h>
 #include <phool/PHIODataNode.h>
+#include <phool/PHTimer.h>
 #include <phool/phool.h>
 
+#include <TDirectory.h>
+#include <TMemFile.h>
+#include <TTree.h>
+
 #include <cstdlib>
 #include <iostream>
 #include <vector>
 
 using namespace std;
 
-PHG4InEventCompress::PHG4InEventCompress(const std::string &name): SubsysReco(name)
+PHG4InEventCompress::PHG4InEventCompress(const std::string &name):
+  SubsysReco(name),
+  vtxarray(NULL),
+  particlearray(NULL),
+  packedevent(NULL),
+  packed(false),
+  pos_precision(1e-4),
+  time_precision(1e-3),
+  mom_precision(1e-4),
+  benchmark(false),
+  nevents(0),
+  nparticles(0),
+  vararray_timer(NULL),
+  packed_timer(NULL),
+  benchmark_file(NULL),
+  benchmark_tree(NULL),
+  benchmark_vtxarray(NULL),
+  benchmark_particlearray(NULL),
+  benchmark_packed(NULL)
 {}
 
+PHG4InEventCompress::~PHG4InEventCompress()
+{
+  delete vararray_timer;
+  delete packed_timer;
+  // the file owns the tree
+  delete benchmark_file;
+  delete benchmark_vtxarray;
+  delete benchmark_particlearray;
+  delete benchmark_packed;
+}
+
 int
 PHG4InEventCompress::InitRun(PHCompositeNode *topNode)
 {
@@ -32,6 +68,34 @@ PHG4InEventCompress::InitRun(PHCompositeNode *topNode)
 
   PHIODataNode<PHObject> *PHObjectIONode;
 
+  if (benchmark)
+    {
+      vararray_timer = new PHTimer("VariableArray decoding");
+      packed_timer = new PHTimer("PHG4InEventPacked decoding");
+      benchmark_vtxarray = new VariableArray(varids::G4VTXV1);
+      benchmark_particlearray = new VariableArray(varids::G4PARTICLEV1);
+      benchmark_packed = new PHG4InEventPacked();
+      // same compression, buffer size and split level as the DST output
+      TDirectory *savedir = gDirectory;
+      benchmark_file = new TMemFile("PHG4InEventCompress_benchmark.root", "RECREATE");
+      benchmark_file->SetCompressionLevel(3);
+      benchmark_tree = new TTree("T", "generator record formats");
+      benchmark_tree->Branch("PHG4Vtx_VarArray", benchmark_vtxarray->ClassName(), &benchmark_vtxarray,
+			     benchmark_vtxarray->BufferSize(), benchmark_vtxarray->SplitLevel());
+      benchmark_tree->Branch("PHG4Particle_VarArray", benchmark_particlearray->ClassName(), &benchmark_particlearray,
+			     benchmark_particlearray->BufferSize(), benchmark_particlearray->SplitLevel());
+      benchmark_tree->Branch("PHG4INEVENT_PACKED", benchmark_packed->ClassName(), &benchmark_packed,
+			     benchmark_packed->BufferSize(), benchmark_packed->SplitLevel());
+      savedir->cd();
+    }
+  if (packed)
+    {
+      packedevent = new PHG4InEventPacked();
+      PHObjectIONode = new PHIODataNode<PHObject>(packedevent, "PHG4INEVENT_PACKED", "PHObject");
+      dstNode->addNode(PHObjectIONode);
+      return Fun4AllReturnCodes::EVENT_OK;
+    }
+
   vtxarray = new VariableArray(varids::G4VTXV1);
   PHObjectIONode = new PHIODataNode<PHObject>(vtxarray, "PHG4Vtx_VarArray", "PHObject");
   dstNode->addNode(PHObjectIONode);
@@ -53,8 +117,29 @@ PHG4InEventCompress::process_event(PHCompositeNode *topNode)
       return Fun4AllReturnCodes::EVENT_OK;
     }
 
+  if (benchmark)
+    {
+      run_benchmark(*inEvent);
+    }
+  if (packed)
+    {
+      if (packedevent->Pack(*inEvent, pos_precision, time_precision, mom_precision))
+	{
+	  cout << PHWHERE << " packing of PHG4INEVENT failed" << endl;
+	  exit(1);
+	}
+      return Fun4AllReturnCodes::EVENT_OK;
+    }
+  FillArrays(*inEvent, vtxarray, particlearray);
+  //  inEvent->identify();
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void
+PHG4InEventCompress::FillArrays(const PHG4InEvent &inEvent, VariableArray *vtxarr, VariableArray *particlearr)
+{
   map<int, PHG4VtxPoint *>::const_iterator vtxiter;
-  std::pair< std::map<int, PHG4VtxPoint *>::const_iterator, std::map<int, PHG4VtxPoint *>::const_iterator > vtxbegin_end = inEvent->GetVertices();
+  std::pair< std::map<int, PHG4VtxPoint *>::const_iterator, std::map<int, PHG4VtxPoint *>::const_iterator > vtxbegin_end = inEvent.GetVertices();
   vector<short> svtxvec;
   for (vtxiter = vtxbegin_end.first; vtxiter != vtxbegin_end.second; vtxiter++)
     {
@@ -69,9 +154,9 @@ PHG4InEventCompress::process_event(PHCompositeNode *topNode)
       svtxvec.push_back(VariableArrayUtils::FloatToShortBits((*vtxiter->second).get_z()));
       svtxvec.push_back(VariableArrayUtils::FloatToShortBits((*vtxiter->second).get_t()));
     }
-  vtxarray->set_val(svtxvec);
+  vtxarr->set_val(svtxvec);
 
-  pair<multimap<int, PHG4Particle *>::const_iterator, multimap<int, PHG4Particle *>::const_iterator > particlebegin_end = inEvent->GetParticles();
+  pair<multimap<int, PHG4Particle *>::const_iterator, multimap<int, PHG4Particle *>::const_iterator > particlebegin_end = inEvent.GetParticles();
   multimap<int,PHG4Particle *>::const_iterator particle_iter;
   vector<short> spartvec;
   for (particle_iter = particlebegin_end.first; particle_iter != particlebegin_end.second; particle_iter++)
@@ -93,13 +178,50 @@ PHG4InEventCompress::process_event(PHCompositeNode *topNode)
       spartvec.push_back(VariableArrayUtils::FloatToShortBits((*particle_iter->second).get_py()));
       spartvec.push_back(VariableArrayUtils::FloatToShortBits((*particle_iter->second).get_pz()));
     }
-  particlearray->set_val(spartvec);
-  //  inEvent->identify();
-  return Fun4AllReturnCodes::EVENT_OK;
+  particlearr->set_val(spartvec);
+  return;
+}
+
+void
+PHG4InEventCompress::run_benchmark(const PHG4InEvent &inEvent)
+{
+  FillArrays(inEvent, benchmark_vtxarray, benchmark_particlearray);
+  benchmark_packed->Pack(inEvent, pos_precision, time_precision, mom_precision);
+  benchmark_tree->Fill();
+  nevents++;
+  nparticles += benchmark_packed->get_nparticles();
+
+  PHG4InEvent decoded;
+  vararray_timer->restart();
+  PHG4InEventReadBack::FillFromArrays(benchmark_vtxarray, benchmark_particlearray, decoded);
+  vararray_timer->stop();
+  decoded.Reset();
+  packed_timer->restart();
+  benchmark_packed->Unpack(decoded);
+  packed_timer->stop();
+  return;
 }
 
 int
 PHG4InEventCompress::End(PHCompositeNode *topNode)
 {
+  if (benchmark && nevents > 0)
+    {
+      // compress the baskets still in memory
+      benchmark_tree->FlushBaskets();
+      const double vararray_bytes = benchmark_tree->GetBranch("PHG4Vtx_VarArray")->GetZipBytes("*") +
+	benchmark_tree->GetBranch("PHG4Particle_VarArray")->GetZipBytes("*");
+      const double vararray_totbytes = benchmark_tree->GetBranch("PHG4Vtx_VarArray")->GetTotBytes("*") +
+	benchmark_tree->GetBranch("PHG4Particle_VarArray")->GetTotBytes("*");
+      const double packed_bytes = benchmark_tree->GetBranch("PHG4INEVENT_PACKED")->GetZipBytes("*");
+      const double packed_totbytes = benchmark_tree->GetBranch("PHG4INEVENT_PACKED")->GetTotBytes("*");
+      cout << Name() << " generator record format comparison, " << nevents
+	   << " events, " << (double) nparticles / nevents << " particles/event"
+	   << " (ROOT compressed branch sizes, uncompressed in brackets)" << endl;
+      cout << "VariableArray:     " << vararray_bytes / nevents << " (" << vararray_totbytes / nevents
+	   << ") bytes/event, decoding " << vararray_timer->get_accumulated_time() / nevents << " ms/event" << endl;
+      cout << "PHG4InEventPacked: " << packed_bytes / nevents << " (" << packed_totbytes / nevents
+	   << ") bytes/event, decoding " << packed_timer->get_accumulated_time() / nevents << " ms/event" << endl;
+    }
   return Fun4AllReturnCodes::EVENT_OK;
 }
@@ -3,20 +3,57 @@
 
 #include <fun4all/SubsysReco.h>
 
+class PHG4InEvent;
+class PHG4InEventPacked;
+class PHTimer;
+class TFile;
+class TTree;
 class VariableArray;
 
 class PHG4InEventCompress: public SubsysReco
 {
  public:
   PHG4InEventCompress(const std::string &name = "PHG4InEventCompress");
-  virtual ~PHG4InEventCompress() {}
+  virtual ~PHG4InEventCompress();
   int InitRun(PHCompositeNode *topNode);
   int process_event(PHCompositeNode *topNode);
   int End(PHCompositeNode *topNode);
 
+  //! write the entropy coded PHG4InEventPacked (node PHG4INEVENT_PACKED) instead of the VariableArrays
+  void SetPacked(const bool b = true) {packed = b;}
+  //! precision of the packed vertex positions (cm), times (ns) and momenta (GeV)
+  void SetPackedPrecision(const float pos, const float time, const float mom)
+  {pos_precision = pos; time_precision = time; mom_precision = mom;}
+
+  //! compare size and decoding time of the packed and the VariableArray format, printed in End()
+  /*! both formats are written to a TTree in memory with the compression
+      of the DST output, the sizes are the compressed branch sizes */
+  void SetBenchmark(const bool b = true) {benchmark = b;}
+
+  //! fill the VariableArray format
+  static void FillArrays(const PHG4InEvent &inEvent, VariableArray *vtxarr, VariableArray *particlearr);
+
  protected:
+  void run_benchmark(const PHG4InEvent &inEvent);
+
   VariableArray *vtxarray;
   VariableArray *particlearray;
+  PHG4InEventPacked *packedevent;
+  bool packed;
+  float pos_precision;
+  float time_precision;
+  float mom_precision;
+
+  bool benchmark;
+  unsigned int nevents;
+  unsigned long long nparticles;
+  PHTimer *vararray_timer;
+  PHTimer *packed_timer;
+  TFile *benchmark_file;
+  TTree *benchmark_tree;
+  VariableArray *benchmark_vtxarray;
+  VariableArray *benchmark_particlearray;
+  PHG4InEventPacked *benchmark_packed;
 };
 
 #endif
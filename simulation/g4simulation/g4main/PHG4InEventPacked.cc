@@ -0,0 +1,491 @@
+#include "PHG4InEventPacked.h"
+#include "PHG4InEvent.h"
+#include "PHG4Particlev1.h"
+#include "PHG4VtxPoint.h"
+
+#include <phool/phool.h>
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+ClassImp(PHG4InEventPacked)
+
+// every field has its own set of probabilities
+enum PackedField
+{
+  field_count = 0,
+  field_vtxid,
+  field_x,
+  field_y,
+  field_z,
+  field_t,
+  field_vtxflag,
+  field_pid,
+  field_pidindex,
+  field_particleflag,
+  field_px,
+  field_py,
+  field_pz,
+  field_MAX_NUMBER
+};
+
+// separate probabilities for the first 3 bytes of a number and the rest
+static const int nbytecontexts = 4;
+static const int vtxflag_time = 0x1;
+static const int particleflag_embed = 0x1;
+// every coded byte costs at least 8 decisions with a probability below
+// 2017/2048 (> 0.17 bit), a valid buffer cannot hold more numbers than this per byte
+static const unsigned int max_numbers_per_byte = 64;
+
+// probabilities (11 bit) of the 8 bit decisions of a byte for every
+// field and byte position, adapted while coding
+class PackedModel
+{
+ public:
+  PackedModel()
+  {
+    for (unsigned int i = 0; i < sizeof(prob) / sizeof(prob[0][0][0]); i++)
+      {
+	(&prob[0][0][0])[i] = kProbInit;
+      }
+  }
+  uint16_t *get(const int field, const int ibyte)
+  {
+    return prob[field][min(ibyte, nbytecontexts - 1)];
+  }
+
+  static const int kNumBits = 11;
+  static const uint16_t kProbInit = 1 << (kNumBits - 1);
+  static const int kMoveBits = 5;
+  static const uint32_t kTop = 1 << 24;
+
+ protected:
+  uint16_t prob[field_MAX_NUMBER][nbytecontexts][256];
+};
+
+// carry-less binary range coder (LZMA style)
+class PackedEncoder
+{
+ public:
+  PackedEncoder(vector<unsigned char> &out):
+    low(0),
+    range(0xFFFFFFFF),
+    cache(0),
+    cachesize(1),
+    bytes(out)
+  {}
+
+  void encode_bit(uint16_t &prob, const int bit)
+  {
+    uint32_t bound = (range >> PackedModel::kNumBits) * prob;
+    if (bit)
+      {
+	low += bound;
+	range -= bound;
+	prob -= prob >> PackedModel::kMoveBits;
+      }
+    else
+      {
+	range = bound;
+	prob += ((1 << PackedModel::kNumBits) - prob) >> PackedModel::kMoveBits;
+      }
+    while (range < PackedModel::kTop)
+      {
+	range <<= 8;
+	shift_low();
+      }
+  }
+
+  void encode_byte(uint16_t *probs, const unsigned int byte)
+  {
+    unsigned int m = 1;
+    for (int i = 7; i >= 0; i--)
+      {
+	int bit = (byte >> i) & 0x1;
+	encode_bit(probs[m], bit);
+	m = (m << 1) | bit;
+      }
+  }
+
+  void flush()
+  {
+    for (int i = 0; i < 5; i++)
+      {
+	shift_low();
+      }
+  }
+
+ protected:
+  void shift_low()
+  {
+    if ((uint32_t) low < 0xFF000000U || (low >> 32) != 0)
+      {
+	unsigned char carry = low >> 32;
+	unsigned char temp = cache;
+	do
+	  {
+	    bytes.push_back(temp + carry);
+	    temp = 0xFF;
+	  }
+	while (--cachesize != 0);
+	cache = (low >> 24) & 0xFF;
+      }
+    cachesize++;
+    low = (low & 0x00FFFFFF) << 8;
+  }
+
+  uint64_t low;
+  uint32_t range;
+  unsigned char cache;
+  uint64_t cachesize;
+  vector<unsigned char> &bytes;
+};
+
+class PackedDecoder
+{
+ public:
+  PackedDecoder(const unsigned char *buf, const unsigned int n):
+    code(0),
+    range(0xFFFFFFFF),
+    buffer(buf),
+    nbytes(n),
+    pos(0),
+    overrun(false)
+  {
+    for (int i = 0; i < 5; i++)
+      {
+	code = (code << 8) | next_byte();
+      }
+  }
+
+  int decode_bit(uint16_t &prob)
+  {
+    uint32_t bound = (range >> PackedModel::kNumBits) * prob;
+    int bit;
+    if (code < bound)
+      {
+	range = bound;
+	prob += ((1 << PackedModel::kNumBits) - prob) >> PackedModel::kMoveBits;
+	bit = 0;
+      }
+    else
+      {
+	code -= bound;
+	range -= bound;
+	prob -= prob >> PackedModel::kMoveBits;
+	bit = 1;
+      }
+    while (range < PackedModel::kTop)
+      {
+	range <<= 8;
+	code = (code << 8) | next_byte();
+      }
+    return bit;
+  }
+
+  unsigned int decode_byte(uint16_t *probs)
+  {
+    unsigned int m = 1;
+    for (int i = 0; i < 8; i++)
+      {
+	m = (m << 1) | decode_bit(probs[m]);
+      }
+    return m - 0x100;
+  }
+
+  bool failed() const {return overrun;}
+
+ protected:
+  unsigned char next_byte()
+  {
+    if (pos < nbytes)
+      {
+	return buffer[pos++];
+      }
+    // the decoder reads ahead by the 4 bytes the encoder flushed, more means a broken buffer
+    if (++pos > nbytes + 4)
+      {
+	overrun = true;
+      }
+    return 0;
+  }
+
+  uint32_t code;
+  uint32_t range;
+  const unsigned char *buffer;
+  unsigned int nbytes;
+  unsigned int pos;
+  bool overrun;
+};
+
+// numbers are written as 7 bit groups, the high bit marks a following group
+static void
+write_uint(PackedEncoder &encoder, PackedModel &model, const int field, uint64_t val)
+{
+  int ibyte = 0;
+  while (val >= 0x80)
+    {
+      encoder.encode_byte(model.get(field, ibyte++), (val & 0x7F) | 0x80);
+      val >>= 7;
+    }
+  encoder.encode_byte(model.get(field, ibyte), val);
+}
+
+// zigzag coding keeps small negative numbers short
+static void
+write_int(PackedEncoder &encoder, PackedModel &model, const int field, const int64_t val)
+{
+  write_uint(encoder, model, field, (((uint64_t) val) << 1) ^ (uint64_t) (val >> 63));
+}
+
+static uint64_t
+read_uint(PackedDecoder &decoder, PackedModel &model, const int field)
+{
+  uint64_t val = 0;
+  for (int ibyte = 0; ibyte < 10; ibyte++)
+    {
+      unsigned int byte = decoder.decode_byte(model.get(field, ibyte));
+      val |= ((uint64_t) (byte & 0x7F)) << (7 * ibyte);
+      if (!(byte & 0x80))
+	{
+	  break;
+	}
+    }
+  return val;
+}
+
+static int64_t
+read_int(PackedDecoder &decoder, PackedModel &model, const int field)
+{
+  uint64_t val = read_uint(decoder, model, field);
+  return (int64_t) (val >> 1) ^ -((int64_t) (val & 0x1));
+}
+
+static int64_t
+quantize(const double val, const double precision)
+{
+  if (!isfinite(val))
+    {
+      return 0;
+    }
+  return (int64_t) floor(val / precision + 0.5);
+}
+
+static bool
+pid_count_greater(const pair<int, unsigned int> &lhs, const pair<int, unsigned int> &rhs)
+{
+  if (lhs.second != rhs.second)
+    {
+      return lhs.second > rhs.second;
+    }
+  return lhs.first < rhs.first;
+}
+
+PHG4InEventPacked::PHG4InEventPacked():
+  pos_precision(NAN),
+  time_precision(NAN),
+  mom_precision(NAN),
+  nvertices(0),
+  nparticles(0),
+  nbytes(0),
+  buffer(NULL)
+{}
+
+PHG4InEventPacked::~PHG4InEventPacked()
+{
+  Reset();
+}
+
+void
+PHG4InEventPacked::Reset()
+{
+  delete [] buffer;
+  buffer = NULL;
+  nbytes = 0;
+  nvertices = 0;
+  nparticles = 0;
+  return;
+}
+
+void
+PHG4InEventPacked::identify(ostream& os) const
+{
+  os << "PHG4InEventPacked: " << nvertices << " vertices, "
+     << nparticles << " particles in " << nbytes << " bytes" << endl;
+  os << "precision position: " << pos_precision << " cm, time: "
+     << time_precision << " ns, momentum: " << mom_precision << " GeV" << endl;
+  return;
+}
+
+int
+PHG4InEventPacked::Pack(const PHG4InEvent &inEvent, const float pos_prec, const float time_prec, const float mom_prec)
+{
+  Reset();
+  if (!(pos_prec > 0 && time_prec > 0 && mom_prec > 0))
+    {
+      cout << PHWHERE << " precisions must be positive" << endl;
+      return -1;
+    }
+  pos_precision = pos_prec;
+  time_precision = time_prec;
+  mom_precision = mom_prec;
+
+  // pdg code dictionary, the most frequent code gets index 0
+  pair<multimap<int, PHG4Particle *>::const_iterator, multimap<int, PHG4Particle *>::const_iterator> particles = inEvent.GetParticles();
+  map<int, unsigned int> pidcount;
+  for (multimap<int, PHG4Particle *>::const_iterator piter = particles.first; piter != particles.second; ++piter)
+    {
+      pidcount[piter->second->get_pid()]++;
+    }
+  vector<pair<int, unsigned int> > dictionary(pidcount.begin(), pidcount.end());
+  sort(dictionary.begin(), dictionary.end(), pid_count_greater);
+  map<int, unsigned int> pidindex;
+  for (unsigned int i = 0; i < dictionary.size(); i++)
+    {
+      pidindex[dictionary[i].first] = i;
+    }
+
+  PackedModel model;
+  vector<unsigned char> bytes;
+  PackedEncoder encoder(bytes);
+
+  write_uint(encoder, model, field_count, dictionary.size());
+  for (unsigned int i = 0; i < dictionary.size(); i++)
+    {
+      write_int(encoder, model, field_pid, dictionary[i].first);
+    }
+
+  // vertices in id order, each followed by its particles
+  pair<map<int, PHG4VtxPoint *>::const_iterator, map<int, PHG4VtxPoint *>::const_iterator> vertices = inEvent.GetVertices();
+  write_uint(encoder, model, field_count, distance(vertices.first, vertices.second));
+  int lastid = 0;
+  int64_t last[4] = {0};
+  for (map<int, PHG4VtxPoint *>::const_iterator viter = vertices.first; viter != vertices.second; ++viter)
+    {
+      const PHG4VtxPoint *vtx = viter->second;
+      write_int(encoder, model, field_vtxid, (int64_t) viter->first - lastid);
+      lastid = viter->first;
+      int flag = isfinite(vtx->get_t()) ? vtxflag_time : 0;
+      write_uint(encoder, model, field_vtxflag, flag);
+      int64_t q[4];
+      q[0] = quantize(vtx->get_x(), pos_precision);
+      q[1] = quantize(vtx->get_y(), pos_precision);
+      q[2] = quantize(vtx->get_z(), pos_precision);
+      q[3] = quantize(vtx->get_t(), time_precision);
+      write_int(encoder, model, field_x, q[0] - last[0]);
+      write_int(encoder, model, field_y, q[1] - last[1]);
+      write_int(encoder, model, field_z, q[2] - last[2]);
+      if (flag & vtxflag_time)
+	{
+	  write_int(encoder, model, field_t, q[3] - last[3]);
+	  last[3] = q[3];
+	}
+      copy(q, q + 3, last);
+      nvertices++;
+
+      pair<multimap<int, PHG4Particle *>::const_iterator, multimap<int, PHG4Particle *>::const_iterator> vtxparticles = inEvent.GetParticles(viter->first);
+      write_uint(encoder, model, field_count, distance(vtxparticles.first, vtxparticles.second));
+      for (multimap<int, PHG4Particle *>::const_iterator piter = vtxparticles.first; piter != vtxparticles.second; ++piter)
+	{
+	  PHG4Particle *particle = piter->second;
+	  write_uint(encoder, model, field_pidindex, pidindex[particle->get_pid()]);
+	  write_uint(encoder, model, field_particleflag, inEvent.isEmbeded(particle) ? particleflag_embed : 0);
+	  write_int(encoder, model, field_px, quantize(particle->get_px(), mom_precision));
+	  write_int(encoder, model, field_py, quantize(particle->get_py(), mom_precision));
+	  write_int(encoder, model, field_pz, quantize(particle->get_pz(), mom_precision));
+	  nparticles++;
+	}
+    }
+  encoder.flush();
+
+  nbytes = bytes.size();
+  buffer = new unsigned char[nbytes];
+  memcpy(buffer, &bytes[0], nbytes);
+  return 0;
+}
+
+int
+PHG4InEventPacked::Unpack(PHG4InEvent &inEvent) const
+{
+  if (!buffer)
+    {
+      return 0;
+    }
+  PackedModel model;
+  PackedDecoder decoder(buffer, nbytes);
+
+  // the dictionary size is read before anything else could catch a broken buffer
+  uint64_t ndict = read_uint(decoder, model, field_count);
+  if (ndict > nparticles || ndict > (uint64_t) max_numbers_per_byte * nbytes)
+    {
+      cout << PHWHERE << " corrupt packed generator record, pdg code dictionary of "
+	   << ndict << " entries for " << nparticles << " particles in "
+	   << nbytes << " bytes" << endl;
+      return -1;
+    }
+  vector<int> dictionary(ndict);
+  for (unsigned int i = 0; i < dictionary.size() && !decoder.failed(); i++)
+    {
+      dictionary[i] = read_int(decoder, model, field_pid);
+    }
+
+  uint64_t nvtx = read_uint(decoder, model, field_count);
+  int vtxid = 0;
+  int64_t q[4] = {0};
+  unsigned int nunpacked = 0;
+  for (uint64_t ivtx = 0; ivtx < nvtx && !decoder.failed(); ivtx++)
+    {
+      vtxid += read_int(decoder, model, field_vtxid);
+      int flag = read_uint(decoder, model, field_vtxflag);
+      q[0] += read_int(decoder, model, field_x);
+      q[1] += read_int(decoder, model, field_y);
+      q[2] += read_int(decoder, model, field_z);
+      double t = NAN;
+      if (flag & vtxflag_time)
+	{
+	  q[3] += read_int(decoder, model, field_t);
+	  t = q[3] * (double) time_precision;
+	}
+      inEvent.AddVtxHepMC(vtxid, q[0] * (double) pos_precision, q[1] * (double) pos_precision, q[2] * (double) pos_precision, t);
+
+      uint64_t npart = read_uint(decoder, model, field_count);
+      for (uint64_t ipart = 0; ipart < npart && !decoder.failed(); ipart++)
+	{
+	  uint64_t index = read_uint(decoder, model, field_pidindex);
+	  if (index >= dictionary.size())
+	    {
+	      cout << PHWHERE << " corrupt packed generator record, pdg code index "
+		   << index << " outside of the dictionary of " << dictionary.size()
+		   << " entries" << endl;
+	      return -1;
+	    }
+	  int pflag = read_uint(decoder, model, field_particleflag);
+	  PHG4Particle *particle = new PHG4Particlev1();
+	  particle->set_pid(dictionary[index]);
+	  particle->set_px(read_int(decoder, model, field_px) * (double) mom_precision);
+	  particle->set_py(read_int(decoder, model, field_py) * (double) mom_precision);
+	  particle->set_pz(read_int(decoder, model, field_pz) * (double) mom_precision);
+	  inEvent.AddParticle(vtxid, particle);
+	  if (pflag & particleflag_embed)
+	    {
+	      inEvent.AddEmbeddedParticle(particle);
+	    }
+	  nunpacked++;
+	}
+    }
+  if (decoder.failed() || nunpacked != nparticles)
+    {
+      cout << PHWHERE << " corrupt packed generator record, unpacked "
+	   << nunpacked << " of " << nparticles << " particles" << endl;
+      return -1;
+    }
+  return 0;
+}
@@ -0,0 +1,52 @@
+#ifndef PHG4INEVENTPACKED_H__
+#define PHG4INEVENTPACKED_H__
+
+#include <phool/PHObject.h>
+
+class PHG4InEvent;
+
+//! entropy coded copy of the PHG4InEvent generator record
+/*!
+  Pack() quantizes the vertex positions/times and the particle momenta
+  with the given precisions (cm, ns, GeV), the vertex ids and positions
+  are stored as differences to the previous vertex, the pdg codes as
+  index in a per event dictionary sorted by frequency. All numbers are
+  written as variable length integers and compressed with an adaptive
+  binary range coder which has its own probabilities for each field.
+  Unpack() adds the vertices (keeping their ids) and particles to a
+  PHG4InEvent. Written by PHG4InEventCompress::SetPacked(), read back by
+  PHG4InEventReadBack.
+*/
+class PHG4InEventPacked: public PHObject
+{
+ public:
+  PHG4InEventPacked();
+  virtual ~PHG4InEventPacked();
+
+  void identify(std::ostream& os = std::cout) const;
+  void Reset();
+  int isValid() const {return (nbytes > 0);}
+
+  //! replace the content by the packed inEvent, returns 0 on success
+  int Pack(const PHG4InEvent &inEvent, const float pos_prec, const float time_prec, const float mom_prec);
+
+  //! add the packed vertices and particles to inEvent, returns 0 on success
+  int Unpack(PHG4InEvent &inEvent) const;
+
+  unsigned int get_nbytes() const {return nbytes;}
+  unsigned int get_nvertices() const {return nvertices;}
+  unsigned int get_nparticles() const {return nparticles;}
+
+ protected:
+  float pos_precision;
+  float time_precision;
+  float mom_precision;
+  unsigned int nvertices;
+  unsigned int nparticles;
+  unsigned int nbytes;
+  unsigned char *buffer; //[nbytes]
+
+  ClassDef(PHG4InEventPacked,1)
+};
+
+#endif
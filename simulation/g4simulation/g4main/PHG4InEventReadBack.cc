@@ -1,5 +1,6 @@
 #include "PHG4InEventReadBack.h"
 #include "PHG4InEvent.h"
+#include "PHG4InEventPacked.h"
 #include "PHG4VtxPointv1.h"
 #include "PHG4Particlev1.h"
 #include "PHG4InEvent.h"
@@ -51,6 +52,17 @@ PHG4InEventReadBack::process_event(PHCompositeNode *topNode)
       cout << "no PHG4INEVENT node found" << endl;
       return Fun4AllReturnCodes::EVENT_OK;
     }
+  // entropy coded record written by PHG4InEventCompress::SetPacked()
+  PHG4InEventPacked *packedevent = findNode::getClass<PHG4InEventPacked>(topNode,"PHG4INEVENT_PACKED");
+  if (packedevent)
+    {
+      inEvent->Reset();
+      if (packedevent->Unpack(*inEvent))
+	{
+	  return Fun4AllReturnCodes::ABORTEVENT;
+	}
+      return Fun4AllReturnCodes::EVENT_OK;
+    }
   vtxarray = findNode::getClass<VariableArray>(topNode,"PHG4Vtx_VarArray");
   if (!vtxarray)
     {
@@ -65,26 +77,34 @@ PHG4InEventReadBack::process_event(PHCompositeNode *topNode)
       return Fun4AllReturnCodes::EVENT_OK;
     }
   inEvent->Reset();
-  unsigned int size = vtxarray->get_array_size();
-  const short int *sval = vtxarray->get_array();
-  PHG4VtxPointv1 vtx;
+  FillFromArrays(vtxarray, particlearray, *inEvent);
+  //  inEvent->identify();
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+void
+PHG4InEventReadBack::FillFromArrays(const VariableArray *vtxarr, const VariableArray *particlearr, PHG4InEvent &inEvent)
+{
+  unsigned int size = vtxarr->get_array_size();
+  const short int *sval = vtxarr->get_array();
+  // keep the vertex ids, the particles refer to them
   while(size > 0)
     {
       int vtxid = *sval++;
       size --;
-      vtx.set_x(VariableArrayUtils::ShortBitsToFloat(*sval++));
+      double x = VariableArrayUtils::ShortBitsToFloat(*sval++);
       size --;
-      vtx.set_y(VariableArrayUtils::ShortBitsToFloat(*sval++));
+      double y = VariableArrayUtils::ShortBitsToFloat(*sval++);
       size --;
-      vtx.set_z(VariableArrayUtils::ShortBitsToFloat(*sval++));
+      double z = VariableArrayUtils::ShortBitsToFloat(*sval++);
       size--;
-      vtx.set_t(VariableArrayUtils::ShortBitsToFloat(*sval++));
+      double t = VariableArrayUtils::ShortBitsToFloat(*sval++);
       size--;
-      inEvent->AddVtx(vtxid,vtx);
+      inEvent.AddVtxHepMC(vtxid, x, y, z, t);
      }
 
-  size = particlearray->get_array_size();
-  sval = particlearray->get_array();
+  size = particlearr->get_array_size();
+  sval = particlearr->get_array();
   while(size > 0)
     {
       PHG4Particle *particle = new PHG4Particlev1();
@@ -98,10 +118,9 @@ PHG4InEventReadBack::process_event(PHCompositeNode *topNode)
       size --;
       particle->set_pz(VariableArrayUtils::ShortBitsToFloat(*sval++));
       size --;
-      inEvent->AddParticle(vtxid, particle);
+      inEvent.AddParticle(vtxid, particle);
     }
-  //  inEvent->identify();
-  return Fun4AllReturnCodes::EVENT_OK;
+  return;
 }
 
 int
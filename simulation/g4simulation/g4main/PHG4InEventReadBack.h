@@ -3,6 +3,7 @@
 
 #include <fun4all/SubsysReco.h>
 
+class PHG4InEvent;
 class VariableArray;
 
 class PHG4InEventReadBack: public SubsysReco
@@ -14,6 +15,9 @@ class PHG4InEventReadBack: public SubsysReco
   int process_event(PHCompositeNode *topNode);
   int End(PHCompositeNode *topNode);
 
+  //! add the content of the VariableArray format to inEvent
+  static void FillFromArrays(const VariableArray *vtxarr, const VariableArray *particlearr, PHG4InEvent &inEvent);
+
  protected:
   VariableArray *vtxarray;
   VariableArray *particlearray;
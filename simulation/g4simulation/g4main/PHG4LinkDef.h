@@ -7,6 +7,7 @@
 #pragma link C++ class PHG4HeadReco-!;
 #pragma link C++ class PHG4InEvent+;
 #pragma link C++ class PHG4InEventCompress-!;
+#pragma link C++ class PHG4InEventPacked+;
 #pragma link C++ class PHG4InEventReadBack-!;
 #pragma link C++ class PHG4InputFilter-!;
 #pragma link C++ class PHG4ParticleGun-!;
@@ -14,9 +15,12 @@
 #pragma link C++ class PHG4ParticleGeneratorBase-!;
 #pragma link C++ class PHG4ParticleGeneratorVectorMeson-!;
 #pragma link C++ class PHG4ParticleGeneratorD0-!;
+#pragma link C++ class PHG4ProfilerSubsystem-!;
 #pragma link C++ class PHG4Reco-!;
 #pragma link C++ class PHG4SimpleEventGenerator-!;
 #pragma link C++ class PHG4Subsystem-!;
+#pragma link C++ class PHG4TrackKillPolicy-!;
+#pragma link C++ class PHG4TruthPruningPolicy-!;
 #pragma link C++ class PHG4TruthSubsystem-!;
 //#pragma link C++ class PHG4UIsession-!;
 #pragma link C++ class ReadEICFiles-!;
@@ -0,0 +1,350 @@
+#include "PHG4OverlapChecker.h"
+
+#include <Geant4/G4AffineTransform.hh>
+#include <Geant4/G4LogicalVolume.hh>
+#include <Geant4/G4SystemOfUnits.hh>
+#include <Geant4/G4VPhysicalVolume.hh>
+#include <Geant4/G4VSolid.hh>
+
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+using namespace std;
+using namespace SeamStress;
+
+PHG4OverlapChecker::PHG4OverlapChecker(const int res, const unsigned int n, const double tol):
+  resolution(res),
+  nthreads((n > 0) ? n : 1),
+  tolerance(tol),
+  verbosity(0),
+  nskipped(0),
+  nreplicas(0),
+  vssp(NULL),
+  pins(NULL),
+  thread_tot(0)
+{}
+
+PHG4OverlapChecker::~PHG4OverlapChecker()
+{
+  for (unsigned int i = 0; i < vss.size(); i++)
+    {
+      vss[i].stop();
+    }
+  delete pins;
+  delete vssp;
+}
+
+bool
+PHG4OverlapChecker::ReadCache(const string &filename)
+{
+  ifstream in(filename.c_str());
+  if (!in.is_open())
+    {
+      return false;
+    }
+  unsigned long long key;
+  while (in >> hex >> key)
+    {
+      clean_keys[key] = true;
+    }
+  if (verbosity > 0)
+    {
+      cout << "PHG4OverlapChecker: " << clean_keys.size() << " clean volumes in " << filename << endl;
+    }
+  return true;
+}
+
+bool
+PHG4OverlapChecker::WriteCache(const string &filename) const
+{
+  ofstream out(filename.c_str());
+  if (!out.is_open())
+    {
+      cout << "PHG4OverlapChecker: cannot write " << filename << endl;
+      return false;
+    }
+  for (map<unsigned long long, bool>::const_iterator iter = clean_keys.begin(); iter != clean_keys.end(); ++iter)
+    {
+      if (iter->second)
+	{
+	  out << hex << iter->first << endl;
+	}
+    }
+  return true;
+}
+
+unsigned long long
+PHG4OverlapChecker::hash(const string &s, unsigned long long h)
+{
+  // 64 bit FNV-1a
+  for (string::const_iterator iter = s.begin(); iter != s.end(); ++iter)
+    {
+      h ^= (unsigned char) *iter;
+      h *= 1099511628211ULL;
+    }
+  return h;
+}
+
+string
+PHG4OverlapChecker::describe(const G4VPhysicalVolume *volume)
+{
+  ostringstream os;
+  os << setprecision(17);
+  volume->GetLogicalVolume()->GetSolid()->StreamInfo(os);
+  const G4RotationMatrix *rot = volume->GetRotation();
+  if (rot)
+    {
+      os << rot->xx() << " " << rot->xy() << " " << rot->xz() << " "
+	 << rot->yx() << " " << rot->yy() << " " << rot->yz() << " "
+	 << rot->zx() << " " << rot->zy() << " " << rot->zz() << endl;
+    }
+  os << volume->GetTranslation() << endl;
+  return os.str();
+}
+
+void
+PHG4OverlapChecker::add_jobs(G4LogicalVolume *mother)
+{
+  // one surface point of every daughter for the "sibling fully inside" test
+  vector<G4ThreeVector> &sibling_points = mother_points[mother];
+  ostringstream config;
+  config << setprecision(17) << resolution << " " << tolerance << endl;
+  mother->GetSolid()->StreamInfo(config);
+  const int ndaughters = mother->GetNoDaughters();
+  for (int i = 0; i < ndaughters; i++)
+    {
+      G4VPhysicalVolume *daughter = mother->GetDaughter(i);
+      if (daughter->IsReplicated())
+	{
+	  sibling_points.push_back(G4ThreeVector());
+	  continue;
+	}
+      config << describe(daughter);
+      G4AffineTransform td(daughter->GetRotation(), daughter->GetTranslation());
+      sibling_points.push_back(td.TransformPoint(daughter->GetLogicalVolume()->GetSolid()->GetPointOnSurface()));
+    }
+  const unsigned long long mother_key = hash(config.str());
+
+  for (int i = 0; i < ndaughters; i++)
+    {
+      G4VPhysicalVolume *daughter = mother->GetDaughter(i);
+      if (daughter->IsReplicated())
+	{
+	  nreplicas++;
+	  continue;
+	}
+      ostringstream self;
+      self << i << endl << describe(daughter);
+      unsigned long long key = hash(self.str(), mother_key);
+      if (clean_keys.find(key) != clean_keys.end())
+	{
+	  nskipped++;
+	  continue;
+	}
+      jobs.push_back(Job());
+      Job &job = jobs.back();
+      job.volume = daughter;
+      job.mother = mother;
+      job.key = key;
+      job.sibling_points = &sibling_points;
+      G4VSolid *solid = daughter->GetLogicalVolume()->GetSolid();
+      G4AffineTransform tm(daughter->GetRotation(), daughter->GetTranslation());
+      job.points.reserve(resolution);
+      for (int n = 0; n < resolution; n++)
+	{
+	  job.points.push_back(tm.TransformPoint(solid->GetPointOnSurface()));
+	}
+    }
+  return;
+}
+
+void
+PHG4OverlapChecker::check(Job &job) const
+{
+  // the solids are only queried (as in multi threaded G4 navigation), thread safe
+  G4VSolid *mothersolid = job.mother->GetSolid();
+  const int ndaughters = job.mother->GetNoDaughters();
+  double mother_depth = 0;
+  G4ThreeVector mother_point;
+  vector<double> depth(ndaughters, 0);
+  vector<G4ThreeVector> depth_point(ndaughters);
+  vector<G4AffineTransform> inverse(ndaughters);
+  for (int i = 0; i < ndaughters; i++)
+    {
+      G4VPhysicalVolume *daughter = job.mother->GetDaughter(i);
+      inverse[i] = G4AffineTransform(daughter->GetRotation(), daughter->GetTranslation()).Inverse();
+    }
+
+  for (vector<G4ThreeVector>::const_iterator point = job.points.begin(); point != job.points.end(); ++point)
+    {
+      if (mothersolid->Inside(*point) == kOutside)
+	{
+	  double d = mothersolid->DistanceToIn(*point);
+	  if (d > tolerance && d > mother_depth)
+	    {
+	      mother_depth = d;
+	      mother_point = *point;
+	    }
+	}
+      for (int i = 0; i < ndaughters; i++)
+	{
+	  G4VPhysicalVolume *daughter = job.mother->GetDaughter(i);
+	  if (daughter == job.volume || daughter->IsReplicated())
+	    {
+	      continue;
+	    }
+	  G4VSolid *solid = daughter->GetLogicalVolume()->GetSolid();
+	  G4ThreeVector local = inverse[i].TransformPoint(*point);
+	  if (solid->Inside(local) == kInside)
+	    {
+	      double d = solid->DistanceToOut(local);
+	      if (d > tolerance && d > depth[i])
+		{
+		  depth[i] = d;
+		  depth_point[i] = *point;
+		}
+	    }
+	}
+    }
+
+  G4AffineTransform self_inverse(job.volume->GetRotation(), job.volume->GetTranslation());
+  self_inverse.Invert();
+  G4VSolid *selfsolid = job.volume->GetLogicalVolume()->GetSolid();
+  ostringstream os;
+  if (mother_depth > 0)
+    {
+      os << job.volume->GetName() << " protrudes from its mother " << job.mother->GetName()
+	 << " by " << mother_depth / mm << " mm at " << mother_point;
+      job.overlaps.push_back(os.str());
+    }
+  for (int i = 0; i < ndaughters; i++)
+    {
+      G4VPhysicalVolume *daughter = job.mother->GetDaughter(i);
+      if (daughter == job.volume || daughter->IsReplicated())
+	{
+	  continue;
+	}
+      if (depth[i] > 0)
+	{
+	  os.str("");
+	  os << job.volume->GetName() << " overlaps with " << daughter->GetName()
+	     << " by " << depth[i] / mm << " mm at " << depth_point[i] << " (in " << job.mother->GetName() << ")";
+	  job.overlaps.push_back(os.str());
+	}
+      else if (selfsolid->Inside(self_inverse.TransformPoint((*job.sibling_points)[i])) == kInside)
+	{
+	  os.str("");
+	  os << daughter->GetName() << " is fully inside " << job.volume->GetName()
+	     << " (in " << job.mother->GetName() << ")";
+	  job.overlaps.push_back(os.str());
+	}
+    }
+  return;
+}
+
+void
+PHG4OverlapChecker::check_thread(void *arg)
+{
+  unsigned long int w = *((unsigned long int *) arg);
+  for (unsigned long int i = w; i < jobs.size(); i += thread_tot)
+    {
+      check(jobs[i]);
+    }
+  return;
+}
+
+int
+PHG4OverlapChecker::Check(G4VPhysicalVolume *world)
+{
+  jobs.clear();
+  mother_points.clear();
+  nskipped = 0;
+  nreplicas = 0;
+
+  // every logical volume once, the surface points need the G4 random engine (main thread)
+  set<G4LogicalVolume *> visited;
+  vector<G4LogicalVolume *> todo(1, world->GetLogicalVolume());
+  while (!todo.empty())
+    {
+      G4LogicalVolume *mother = todo.back();
+      todo.pop_back();
+      if (!visited.insert(mother).second)
+	{
+	  continue;
+	}
+      add_jobs(mother);
+      for (int i = 0; i < mother->GetNoDaughters(); i++)
+	{
+	  todo.push_back(mother->GetDaughter(i)->GetLogicalVolume());
+	}
+    }
+  if (verbosity > 0)
+    {
+      cout << "PHG4OverlapChecker: checking " << jobs.size() << " volumes with " << nthreads
+	   << " threads, " << nskipped << " unchanged volumes skipped" << endl;
+    }
+
+  if (nthreads > 1 && jobs.size() > 1)
+    {
+      if (!pins)
+	{
+	  Seamstress::init_vector(nthreads, vss);
+	  vssp = new vector<Seamstress*>();
+	  for (unsigned int i = 0; i < vss.size(); i++)
+	    {
+	      vssp->push_back(&(vss[i]));
+	    }
+	  pins = new Pincushion<PHG4OverlapChecker>(this, vssp);
+	}
+      thread_tot = (jobs.size() < nthreads) ? jobs.size() : nthreads;
+      pins->sewStraight(&PHG4OverlapChecker::check_thread, thread_tot);
+    }
+  else
+    {
+      for (unsigned int i = 0; i < jobs.size(); i++)
+	{
+	  check(jobs[i]);
+	}
+    }
+
+  int noverlaps = 0;
+  for (vector<Job>::const_iterator iter = jobs.begin(); iter != jobs.end(); ++iter)
+    {
+      if (iter->overlaps.empty())
+	{
+	  clean_keys[iter->key] = true;
+	}
+      else
+	{
+	  noverlaps++;
+	}
+    }
+  return noverlaps;
+}
+
+void
+PHG4OverlapChecker::Print(ostream &os) const
+{
+  int noverlaps = 0;
+  for (vector<Job>::const_iterator iter = jobs.begin(); iter != jobs.end(); ++iter)
+    {
+      for (vector<string>::const_iterator line = iter->overlaps.begin(); line != iter->overlaps.end(); ++line)
+	{
+	  os << "PHG4OverlapChecker: " << *line << endl;
+	}
+      if (!iter->overlaps.empty())
+	{
+	  noverlaps++;
+	}
+    }
+  os << "PHG4OverlapChecker: " << jobs.size() << " volumes checked with " << resolution
+     << " points, " << noverlaps << " with overlaps, " << nskipped << " unchanged volumes skipped";
+  if (nreplicas > 0)
+    {
+      os << ", " << nreplicas << " replicated/parameterised volumes not checked";
+    }
+  os << endl;
+  return;
+}
@@ -0,0 +1,91 @@
+#ifndef __PHG4OVERLAPCHECKER_H__
+#define __PHG4OVERLAPCHECKER_H__
+
+#include <Geant4/G4ThreeVector.hh>
+
+#include <Pincushion.h>
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+//! checks all placed volumes for overlaps after the geometry is constructed
+/*!
+  Same test as G4PVPlacement::CheckOverlaps(): resolution random points
+  on the surface of each placed volume must be inside its mother and
+  outside its siblings, and no sibling may be fully inside it. Every
+  logical volume is visited once, so a volume placed in many copies of
+  its mother is checked once. The surface points are generated in the
+  main thread (G4 random engine), the Inside() tests run on nthreads
+  Seamstress threads.
+  Each volume is keyed by a hash of its solid and transformation, its
+  mother's solid and all its siblings. Volumes which were found clean
+  before with the same key (ReadCache) are skipped, so after the first
+  run only the volumes of modified detectors are checked again.
+  Replicated and parameterised volumes are not checked (and ignored as
+  siblings).
+*/
+class PHG4OverlapChecker
+{
+ public:
+
+  PHG4OverlapChecker(const int resolution = 1000, const unsigned int nthreads = 1, const double tolerance = 0);
+  virtual ~PHG4OverlapChecker();
+
+  //! clean volumes of a previous check, returns false if the file cannot be read
+  bool ReadCache(const std::string &filename);
+
+  //! store the keys of all clean volumes
+  bool WriteCache(const std::string &filename) const;
+
+  //! check all volumes below world, returns the number of overlapping volumes
+  int Check(G4VPhysicalVolume *world);
+
+  //! summary of the last Check()
+  void Print(std::ostream &os = std::cout) const;
+
+  void Verbosity(const int i) {verbosity = i;}
+
+ protected:
+
+  struct Job
+  {
+    G4VPhysicalVolume *volume;
+    G4LogicalVolume *mother;
+    unsigned long long key;
+    //! surface points of the volume in the frame of the mother
+    std::vector<G4ThreeVector> points;
+    //! one surface point of each sibling in the frame of the mother (index of its daughter)
+    const std::vector<G4ThreeVector> *sibling_points;
+    std::vector<std::string> overlaps;
+  };
+
+  //! description of the solid and transformation of a daughter
+  static std::string describe(const G4VPhysicalVolume *volume);
+  static unsigned long long hash(const std::string &s, unsigned long long h = 14695981039346656037ULL);
+  void add_jobs(G4LogicalVolume *mother);
+  void check(Job &job) const;
+  void check_thread(void *arg);
+
+  int resolution;
+  unsigned int nthreads;
+  double tolerance;
+  int verbosity;
+
+  std::map<unsigned long long, bool> clean_keys;
+  std::vector<Job> jobs;
+  std::map<G4LogicalVolume *, std::vector<G4ThreeVector> > mother_points;
+  unsigned int nskipped;
+  unsigned int nreplicas;
+
+  std::vector<SeamStress::Seamstress> vss;
+  std::vector<SeamStress::Seamstress*> *vssp;
+  SeamStress::Pincushion<PHG4OverlapChecker> *pins;
+  unsigned long int thread_tot;
+};
+
+#endif
@@ -1,9 +1,11 @@
 #include "PHG4PhenixEventAction.h"
 #include "PHG4EventAction.h"
+#include "PHG4TrackKillPolicy.h"
 
 const int VERBOSE = 0;
 
 PHG4PhenixEventAction::PHG4PhenixEventAction() :
+  killPolicy_( 0 ),
   _timer( PHTimeServer::get()->insert_new( "PHG4PhenixEventAction" ) )
 {}
 
@@ -13,7 +15,9 @@ void PHG4PhenixEventAction::BeginOfEventAction( const G4Event* event )
   _timer.get()->restart();
 
   if ( VERBOSE ) std::cout << "PHG4PhenixEventAction::BeginOfEventAction" << std::endl;
-  
+
+  if ( killPolicy_ ) killPolicy_->BeginOfEvent();
+
   // loop over registered actions, and process
   for( ActionList::const_iterator iter = actions_.begin(); iter != actions_.end(); ++iter )
   {
@@ -10,6 +10,7 @@
 
 class G4Event;
 class PHG4EventAction;
+class PHG4TrackKillPolicy;
 class PHCompositeNode;
 
 class PHG4PhenixEventAction : public G4UserEventAction
@@ -25,6 +26,9 @@ class PHG4PhenixEventAction : public G4UserEventAction
   void AddAction( PHG4EventAction* action )
   { actions_.push_back( action ); }
 
+  //! kill rules, the dry run bookkeeping is reset at the beginning of the event (not owned)
+  void SetKillPolicy( PHG4TrackKillPolicy *policy ) { killPolicy_ = policy; }
+
   void BeginOfEventAction(const G4Event*);
 
   void EndOfEventAction(const G4Event*);
@@ -35,6 +39,8 @@ class PHG4PhenixEventAction : public G4UserEventAction
   typedef std::list<PHG4EventAction*> ActionList;
   ActionList actions_;
 
+  PHG4TrackKillPolicy *killPolicy_;
+
   //! module timer.
   PHTimeServer::timer _timer;
 };
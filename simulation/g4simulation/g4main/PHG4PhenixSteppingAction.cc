@@ -1,17 +1,63 @@
 #include "PHG4PhenixSteppingAction.h"
 #include "PHG4SteppingAction.h"
+#include "PHG4TrackKillPolicy.h"
+
+#include <Geant4/G4Step.hh>
+
+using namespace std;
 
 //_________________________________________________________________
 void PHG4PhenixSteppingAction::UserSteppingAction( const G4Step* aStep )
 {
-  // loop over registered actions, and process
+  G4VPhysicalVolume* volume = aStep->GetPreStepPoint()->GetTouchableHandle()->GetVolume();
+  const ActionVector &actions = GetVolumeActions(volume);
+
+  // loop over the actions registered for this volume, and process
   bool hit_was_used = false;
-  for( ActionList::const_iterator iter = actions_.begin(); iter != actions_.end(); ++iter )
+  for( ActionVector::const_iterator iter = actions.begin(); iter != actions.end(); ++iter )
   {
-    if(*iter)
+    hit_was_used |= (*iter)->UserSteppingAction( aStep, hit_was_used );
+  }
+
+  // the deposits of this step are recorded, the track can go now
+  if (killPolicy_)
+  {
+    killPolicy_->Apply(aStep);
+  }
+
+}
+
+//_________________________________________________________________
+const PHG4PhenixSteppingAction::ActionVector &
+PHG4PhenixSteppingAction::GetVolumeActions( G4VPhysicalVolume *volume )
+{
+  if (volume == last_volume_ && last_actions_)
     {
-      hit_was_used |= (*iter)->UserSteppingAction( aStep, hit_was_used );
+      return *last_actions_;
     }
-  }
+  VolumeMap::iterator iter = volume_actions_.find(volume);
+  if (iter == volume_actions_.end())
+    {
+      // first step in this volume, the geometry is complete by now
+      ActionVector actions;
+      for( ActionList::const_iterator aiter = actions_.begin(); aiter != actions_.end(); ++aiter )
+	{
+	  if ((*aiter)->HandlesVolume(volume))
+	    {
+	      actions.push_back(*aiter);
+	    }
+	}
+      iter = volume_actions_.insert(make_pair(volume, actions)).first;
+    }
+  last_volume_ = volume;
+  last_actions_ = &(iter->second);
+  return *last_actions_;
+}
 
+//_________________________________________________________________
+void PHG4PhenixSteppingAction::ClearVolumeTable()
+{
+  volume_actions_.clear();
+  last_volume_ = 0;
+  last_actions_ = 0;
 }
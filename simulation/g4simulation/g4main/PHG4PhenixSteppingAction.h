@@ -3,16 +3,23 @@
 
 #include <Geant4/G4UserSteppingAction.hh>
 #include <list>
+#include <map>
+#include <vector>
 
 class G4Step;
+class G4VPhysicalVolume;
 class PHG4SteppingAction;
+class PHG4TrackKillPolicy;
 class PHCompositeNode;
 
 class PHG4PhenixSteppingAction : public G4UserSteppingAction
 {
 
   public:
-  PHG4PhenixSteppingAction( void )
+  PHG4PhenixSteppingAction( void ):
+    last_volume_(0),
+    last_actions_(0),
+    killPolicy_(0)
   {}
 
   virtual ~PHG4PhenixSteppingAction()
@@ -24,17 +31,38 @@ class PHG4PhenixSteppingAction : public G4UserSteppingAction
     if (action)
       {
 	actions_.push_back( action );
+	ClearVolumeTable();
       }
   }
 
   virtual void UserSteppingAction(const G4Step*);
 
+  //! kill rules checked after the actions processed the step (not owned)
+  void SetKillPolicy(PHG4TrackKillPolicy *policy) {killPolicy_ = policy;}
+
   private:
 
+  //! actions to call for steps in this volume (in order of registration)
+  const std::vector<PHG4SteppingAction*> &GetVolumeActions(G4VPhysicalVolume *volume);
+
+  void ClearVolumeTable();
+
   //! list of subsystem specific stepping actions
   typedef std::list<PHG4SteppingAction*> ActionList;
   ActionList actions_;
 
+  //! dispatch table volume -> actions which handle this volume or
+  //! do not know (PHG4SteppingAction::HandlesVolume), filled on the first step in a volume
+  typedef std::vector<PHG4SteppingAction*> ActionVector;
+  typedef std::map<const G4VPhysicalVolume*, ActionVector> VolumeMap;
+  VolumeMap volume_actions_;
+
+  //! consecutive steps are mostly in the same volume, avoids the map lookup
+  const G4VPhysicalVolume *last_volume_;
+  const ActionVector *last_actions_;
+
+  PHG4TrackKillPolicy *killPolicy_;
+
 };
 
 
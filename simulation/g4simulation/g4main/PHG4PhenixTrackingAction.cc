@@ -1,5 +1,6 @@
 #include "PHG4PhenixTrackingAction.h"
 #include "PHG4TrackingAction.h"
+#include "PHG4TrackKillPolicy.h"
 
 #include <iostream>
 
@@ -8,6 +9,8 @@ PHG4PhenixTrackingAction::PreUserTrackingAction( const G4Track* track )
 {
 
   if ( Verbosity()>0 ) std::cout << "PHG4PhenixTrackingAction::PreUserTrackingAction" << std::endl;
+
+  if ( killPolicy_ ) killPolicy_->PreUserTrackingAction(track);
   
   // loop over registered actions, and process
   for( ActionList::const_iterator iter = actions_.begin(); iter != actions_.end(); ++iter )
@@ -9,11 +9,12 @@
 
 class G4Track;
 class PHG4TrackingAction;
+class PHG4TrackKillPolicy;
 
 class PHG4PhenixTrackingAction : public G4UserTrackingAction
 {
 public:
-  PHG4PhenixTrackingAction( void ) : verbosity_(0) {}
+  PHG4PhenixTrackingAction( void ) : verbosity_(0), killPolicy_(0) {}
 
   virtual ~PHG4PhenixTrackingAction() {}
 
@@ -24,6 +25,9 @@ public:
 
   virtual void PostUserTrackingAction(const G4Track*);
 
+  //! kill rules, follows the secondaries in dry runs (not owned)
+  void SetKillPolicy( PHG4TrackKillPolicy *policy ) { killPolicy_ = policy; }
+
   //! Get/Set verbosity level
   void Verbosity(int val) { verbosity_ = val; }
   int Verbosity() const { return verbosity_; }
@@ -34,6 +38,7 @@ private:
   typedef std::list<PHG4TrackingAction*> ActionList;
   ActionList actions_;
   int verbosity_;
+  PHG4TrackKillPolicy *killPolicy_;
 };
 
 
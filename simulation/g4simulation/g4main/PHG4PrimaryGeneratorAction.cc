@@ -30,6 +30,10 @@ PHG4PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   multimap<int, PHG4Particle *>::const_iterator particle_iter;
   std::pair< std::map<int, PHG4VtxPoint *>::const_iterator, std::map<int, PHG4VtxPoint *>::const_iterator > vtxbegin_end = inEvent->GetVertices();
 
+  // running counter of the input particles handed to G4, in multi threaded running
+  // this gives every primary its position in the input event even if the event is
+  // split into several G4Events which are processed on different worker threads
+  int user_track_id = 0;
   for (vtxiter = vtxbegin_end.first; vtxiter != vtxbegin_end.second; ++vtxiter)
     {
       //       cout << "vtx number: " << vtxiter->first << endl;
@@ -68,6 +72,12 @@ PHG4PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
                   continue;
                 }
             }
+          user_track_id++;
+          // multi threaded running: particles are distributed round robin over the sub events
+          if (nsubevents > 1 && ((user_track_id - 1) % nsubevents) != anEvent->GetEventID())
+            {
+              continue;
+            }
           G4PrimaryParticle* g4part = NULL;
           if (!(*particle_iter->second).get_pid()) // deal with geantinos which have pid=0
             {
@@ -110,7 +120,13 @@ PHG4PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
                                              (*particle_iter->second).get_py()*GeV,
                                              (*particle_iter->second).get_pz()*GeV);
             }
-          if (inEvent->isEmbeded(particle_iter->second))
+          if (nsubevents > 1)
+            {
+              // the truth of sub events takes the primary id from here
+              PHG4UserPrimaryParticleInformation *userdata = new PHG4UserPrimaryParticleInformation((inEvent->isEmbeded(particle_iter->second) ? 1 : 0), user_track_id);
+              g4part->SetUserInformation(userdata);
+            }
+          else if (inEvent->isEmbeded(particle_iter->second))
             {
               PHG4UserPrimaryParticleInformation *userdata = new PHG4UserPrimaryParticleInformation(1);
               g4part->SetUserInformation(userdata);
@@ -118,6 +134,12 @@ PHG4PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
           vertex->SetPrimary(g4part);
         }
       //      vertex->Print();
+      if (nsubevents > 1 && !vertex->GetNumberOfParticle())
+        {
+          // none of the particles of this vertex belong to this sub event
+          delete vertex;
+          continue;
+        }
       anEvent->AddPrimaryVertex(vertex);
     }
   return;
@@ -10,7 +10,7 @@ class PHG4PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 
   public:
     PHG4PrimaryGeneratorAction():
-      verbosity(0), inEvent(0)
+      verbosity(0), nsubevents(1), inEvent(0)
       {}
 
   virtual ~PHG4PrimaryGeneratorAction()
@@ -22,6 +22,19 @@ class PHG4PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
   void SetInEvent( PHG4InEvent* const inevt )
   { inEvent = inevt; }
 
+  PHG4InEvent* GetInEvent() const
+  { return inEvent; }
+
+  //! split the input event into n G4Events (multi threaded running)
+  /*!
+    particles are distributed round robin, G4Event i gets all particles
+    whose position in the input event modulo n equals i
+  */
+  void SetNumberOfSubEvents( const int n )
+  { nsubevents = (n > 0) ? n : 1; }
+  int GetNumberOfSubEvents() const
+  { return nsubevents; }
+
   //! Set/Get verbosity
   void Verbosity(const int val) { verbosity=val; }
   int Verbosity() const { return verbosity; }
@@ -30,6 +43,9 @@ class PHG4PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 
   int verbosity;
 
+  //! number of G4Events the input event is split into
+  int nsubevents;
+
   private:
 
   //! temporary pointer to input event on node tree
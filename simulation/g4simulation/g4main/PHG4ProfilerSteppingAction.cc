@@ -0,0 +1,248 @@
+#include "PHG4ProfilerSteppingAction.h"
+
+#include <Geant4/G4LogicalVolume.hh>
+#include <Geant4/G4ParticleDefinition.hh>
+#include <Geant4/G4Region.hh>
+#include <Geant4/G4Step.hh>
+#include <Geant4/G4SystemOfUnits.hh>
+#include <Geant4/G4Track.hh>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+  // one line of the report
+  struct ReportEntry
+  {
+    string name;
+    unsigned long nsteps;
+    unsigned long ntracks;
+    double time;
+  };
+
+  bool
+  report_order(const ReportEntry &lhs, const ReportEntry &rhs)
+  {
+    if (lhs.time != rhs.time)
+      {
+	return lhs.time > rhs.time;
+      }
+    return lhs.nsteps > rhs.nsteps;
+  }
+
+  void
+  print_table(ostream &os, const string &title, vector<ReportEntry> &entries,
+	      const unsigned long nsteps, const double time, const unsigned int nlines)
+  {
+    sort(entries.begin(), entries.end(), report_order);
+    os << "---" << title << " (" << entries.size() << ")---" << endl;
+    char line[256];
+    snprintf(line, sizeof(line), "%-40s %12s %7s %10s %10s %7s", "name", "steps", "%", "tracks", "wall (s)", "%");
+    os << line << endl;
+    for (unsigned int i = 0; i < entries.size() && i < nlines; i++)
+      {
+	snprintf(line, sizeof(line), "%-40s %12lu %7.2f %10lu %10.3f %7.2f",
+		 entries[i].name.substr(0, 40).c_str(),
+		 entries[i].nsteps, (nsteps > 0) ? 100. * entries[i].nsteps / nsteps : 0.,
+		 entries[i].ntracks,
+		 entries[i].time / 1000., (time > 0) ? 100. * entries[i].time / time : 0.);
+	os << line << endl;
+      }
+    return;
+  }
+}
+
+PHG4ProfilerSteppingAction::PHG4ProfilerSteppingAction( const unsigned int n ):
+  PHG4SteppingAction(0),
+  sampling((n > 0) ? n : 1),
+  nsteps(0),
+  nsamples(0),
+  timing(false),
+  timer("PHG4ProfilerSteppingAction"),
+  last_volume(NULL),
+  last_volume_counters(NULL),
+  last_particle(NULL),
+  last_particle_counter(NULL)
+{}
+
+int
+PHG4ProfilerSteppingAction::energy_bin(const double ekin)
+{
+  double edge = keV;
+  for (int i = 0; i < nebins - 1; i++)
+    {
+      if (ekin < edge)
+	{
+	  return i;
+	}
+      edge *= 10;
+    }
+  return nebins - 1;
+}
+
+PHG4ProfilerSteppingAction::VolumeCounters &
+PHG4ProfilerSteppingAction::volume_counters(const G4VPhysicalVolume *volume)
+{
+  if (volume == last_volume && last_volume_counters)
+    {
+      return *last_volume_counters;
+    }
+  map<const G4VPhysicalVolume*, VolumeCounters>::iterator iter = volume_cache.find(volume);
+  if (iter == volume_cache.end())
+    {
+      VolumeCounters counters;
+      const G4LogicalVolume *logvol = volume ? volume->GetLogicalVolume() : NULL;
+      counters.volume = &volumes[logvol];
+      counters.region = &regions[logvol ? logvol->GetRegion() : NULL];
+      iter = volume_cache.insert(make_pair(volume, counters)).first;
+    }
+  last_volume = volume;
+  last_volume_counters = &(iter->second);
+  return *last_volume_counters;
+}
+
+PHG4ProfilerSteppingAction::ParticleCounter &
+PHG4ProfilerSteppingAction::particle_counter(const G4ParticleDefinition *particle)
+{
+  if (particle != last_particle || !last_particle_counter)
+    {
+      last_particle = particle;
+      last_particle_counter = &particles[particle];
+    }
+  return *last_particle_counter;
+}
+
+void
+PHG4ProfilerSteppingAction::StopTiming()
+{
+  // a sample must not include the time between tracks or events
+  timing = false;
+  return;
+}
+
+bool
+PHG4ProfilerSteppingAction::UserSteppingAction( const G4Step* aStep, bool )
+{
+  double dt = 0;
+  if (timing)
+    {
+      timer.stop();
+      dt = timer.elapsed() * sampling;
+      timing = false;
+      nsamples++;
+    }
+
+  const G4StepPoint *prePoint = aStep->GetPreStepPoint();
+  VolumeCounters &vc = volume_counters(prePoint->GetTouchableHandle()->GetVolume());
+  ParticleCounter &pc = particle_counter(aStep->GetTrack()->GetParticleDefinition());
+  Counter &ec = pc.ebin[energy_bin(prePoint->GetKineticEnergy())];
+  vc.volume->nsteps++;
+  vc.region->nsteps++;
+  pc.total.nsteps++;
+  ec.nsteps++;
+  if (dt > 0)
+    {
+      vc.volume->time += dt;
+      vc.region->time += dt;
+      pc.total.time += dt;
+      ec.time += dt;
+    }
+
+  nsteps++;
+  if (nsteps % sampling == 0)
+    {
+      // the next step is timed
+      timing = true;
+      timer.restart();
+    }
+  return false;
+}
+
+void
+PHG4ProfilerSteppingAction::AddTrack( const G4Track *track )
+{
+  ParticleCounter &pc = particle_counter(track->GetParticleDefinition());
+  pc.total.ntracks++;
+  pc.ebin[energy_bin(track->GetKineticEnergy())].ntracks++;
+  // primaries have no volume before their first step
+  const G4VTouchable *touchable = track->GetTouchable();
+  if (touchable && touchable->GetVolume())
+    {
+      VolumeCounters &vc = volume_counters(touchable->GetVolume());
+      vc.volume->ntracks++;
+      vc.region->ntracks++;
+    }
+  return;
+}
+
+void
+PHG4ProfilerSteppingAction::Report( ostream &os, const unsigned int nlines ) const
+{
+  double time = 0;
+  for (map<const G4LogicalVolume*, Counter>::const_iterator iter = volumes.begin(); iter != volumes.end(); ++iter)
+    {
+      time += iter->second.time;
+    }
+  os << "PHG4ProfilerSteppingAction: " << nsteps << " steps, " << nsamples
+     << " timed (every " << sampling << "th), estimated wall-clock time in steps "
+     << time / 1000. << " s" << endl;
+
+  vector<ReportEntry> entries;
+  for (map<const G4LogicalVolume*, Counter>::const_iterator iter = volumes.begin(); iter != volumes.end(); ++iter)
+    {
+      ReportEntry entry;
+      entry.name = iter->first ? string(iter->first->GetName()) : string("(none)");
+      entry.nsteps = iter->second.nsteps;
+      entry.ntracks = iter->second.ntracks;
+      entry.time = iter->second.time;
+      entries.push_back(entry);
+    }
+  print_table(os, "logical volumes", entries, nsteps, time, nlines);
+
+  entries.clear();
+  for (map<const G4Region*, Counter>::const_iterator iter = regions.begin(); iter != regions.end(); ++iter)
+    {
+      ReportEntry entry;
+      entry.name = iter->first ? string(iter->first->GetName()) : string("(none)");
+      entry.nsteps = iter->second.nsteps;
+      entry.ntracks = iter->second.ntracks;
+      entry.time = iter->second.time;
+      entries.push_back(entry);
+    }
+  print_table(os, "regions", entries, nsteps, time, nlines);
+
+  // particles with their kinetic energy decades
+  const char *ebin_names[nebins] = {"<1keV", "1-10keV", "10-100keV", "0.1-1MeV", "1-10MeV", "10-100MeV",
+				    "0.1-1GeV", "1-10GeV", "10-100GeV", "0.1-1TeV", "1-10TeV", ">10TeV"};
+  entries.clear();
+  for (map<const G4ParticleDefinition*, ParticleCounter>::const_iterator iter = particles.begin(); iter != particles.end(); ++iter)
+    {
+      string name = iter->first ? string(iter->first->GetParticleName()) : string("(none)");
+      ReportEntry entry;
+      entry.name = name;
+      entry.nsteps = iter->second.total.nsteps;
+      entry.ntracks = iter->second.total.ntracks;
+      entry.time = iter->second.total.time;
+      entries.push_back(entry);
+      for (int i = 0; i < nebins; i++)
+	{
+	  const Counter &ec = iter->second.ebin[i];
+	  if (ec.nsteps == 0 && ec.ntracks == 0)
+	    {
+	      continue;
+	    }
+	  entry.name = name + " " + ebin_names[i];
+	  entry.nsteps = ec.nsteps;
+	  entry.ntracks = ec.ntracks;
+	  entry.time = ec.time;
+	  entries.push_back(entry);
+	}
+    }
+  print_table(os, "particles and kinetic energies", entries, nsteps, time, nlines);
+  return;
+}
@@ -0,0 +1,100 @@
+#ifndef PHG4ProfilerSteppingAction_h
+#define PHG4ProfilerSteppingAction_h
+
+#include "PHG4SteppingAction.h"
+
+#include <phool/PHTimer.h>
+
+#include <iostream>
+#include <map>
+
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4Region;
+class G4Track;
+
+//! counts steps, tracks and wall-clock time per logical volume, region and particle
+/*!
+  Every step is counted. The time is sampled: every sampling'th step the
+  time since the previous call is measured (G4 transport and physics of
+  this step plus the stepping actions of the previous one) and added,
+  multiplied by the sampling interval, to the counters of the step. The
+  particle counters are split into decades of the kinetic energy at the
+  beginning of the step. A sample still open when a new track or event
+  starts is dropped (StopTiming()). The time is wall-clock time (PHTimer),
+  it includes time the process was not running. Used by
+  PHG4ProfilerSubsystem.
+*/
+class PHG4ProfilerSteppingAction : public PHG4SteppingAction
+{
+
+  public:
+
+  PHG4ProfilerSteppingAction( const unsigned int sampling = 100 );
+
+  virtual ~PHG4ProfilerSteppingAction() {}
+
+  //! counts the step, never uses it
+  virtual bool UserSteppingAction(const G4Step*, bool);
+
+  //! count a new track in the volume and for the particle it is created with
+  void AddTrack(const G4Track *track);
+
+  //! drop the sample started in the last step (new track or event)
+  void StopTiming();
+
+  //! print the nlines volumes/regions/particles with the largest time
+  void Report(std::ostream &os = std::cout, const unsigned int nlines = 30) const;
+
+  void SetSamplingInterval(const unsigned int n) {sampling = (n > 0) ? n : 1;}
+
+  protected:
+
+  struct Counter
+  {
+    Counter(): nsteps(0), ntracks(0), time(0) {}
+    unsigned long nsteps;
+    unsigned long ntracks;
+    double time; // ms
+  };
+
+  //! kinetic energy decades, below 1 keV in the first and above 10 TeV in the last bin
+  static const int nebins = 12;
+
+  struct ParticleCounter
+  {
+    Counter total;
+    Counter ebin[nebins];
+  };
+
+  //! counters of the logical volume and region of a physical volume
+  struct VolumeCounters
+  {
+    Counter *volume;
+    Counter *region;
+  };
+
+  VolumeCounters &volume_counters(const G4VPhysicalVolume *volume);
+  ParticleCounter &particle_counter(const G4ParticleDefinition *particle);
+  static int energy_bin(const double ekin);
+
+  unsigned int sampling;
+  unsigned long nsteps;
+  unsigned long nsamples;
+  bool timing;
+  PHTimer timer;
+
+  std::map<const G4LogicalVolume*, Counter> volumes;
+  std::map<const G4Region*, Counter> regions;
+  std::map<const G4ParticleDefinition*, ParticleCounter> particles;
+
+  //! pointers into the maps above (the map nodes do not move)
+  std::map<const G4VPhysicalVolume*, VolumeCounters> volume_cache;
+  const G4VPhysicalVolume *last_volume;
+  VolumeCounters *last_volume_counters;
+  const G4ParticleDefinition *last_particle;
+  ParticleCounter *last_particle_counter;
+
+};
+
+#endif
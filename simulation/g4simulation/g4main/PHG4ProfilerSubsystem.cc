@@ -0,0 +1,79 @@
+#include "PHG4ProfilerSubsystem.h"
+#include "PHG4ProfilerSteppingAction.h"
+#include "PHG4ProfilerTrackingAction.h"
+
+#include <phool/phool.h>
+
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+//_______________________________________________________________________
+PHG4ProfilerSubsystem::PHG4ProfilerSubsystem( const string &name ):
+  PHG4Subsystem( name ),
+  steppingAction_( NULL ),
+  trackingAction_( NULL ),
+  sampling( 100 ),
+  nlines( 30 )
+{}
+
+//_______________________________________________________________________
+PHG4ProfilerSubsystem::~PHG4ProfilerSubsystem( void )
+{
+  delete trackingAction_;
+  delete steppingAction_;
+}
+
+//_______________________________________________________________________
+int PHG4ProfilerSubsystem::InitRun( PHCompositeNode* )
+{
+  steppingAction_ = new PHG4ProfilerSteppingAction(sampling);
+  trackingAction_ = new PHG4ProfilerTrackingAction(steppingAction_);
+  return 0;
+}
+
+//_______________________________________________________________________
+int PHG4ProfilerSubsystem::process_event( PHCompositeNode* )
+{
+  if (steppingAction_)
+    {
+      steppingAction_->StopTiming();
+    }
+  return 0;
+}
+
+//_______________________________________________________________________
+int PHG4ProfilerSubsystem::End( PHCompositeNode* )
+{
+  if (!steppingAction_)
+    {
+      return 0;
+    }
+  if (reportfile.empty())
+    {
+      steppingAction_->Report(cout, nlines);
+      return 0;
+    }
+  ofstream out(reportfile.c_str());
+  if (!out)
+    {
+      cout << PHWHERE << " cannot open " << reportfile << ", printing the report" << endl;
+      steppingAction_->Report(cout, nlines);
+      return 0;
+    }
+  steppingAction_->Report(out, nlines);
+  return 0;
+}
+
+//_______________________________________________________________________
+PHG4SteppingAction* PHG4ProfilerSubsystem::GetSteppingAction( void ) const
+{
+  return steppingAction_;
+}
+
+//_______________________________________________________________________
+PHG4TrackingAction* PHG4ProfilerSubsystem::GetTrackingAction( void ) const
+{
+  return trackingAction_;
+}
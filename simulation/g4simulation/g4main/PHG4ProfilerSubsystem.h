@@ -0,0 +1,61 @@
+#ifndef PHG4ProfilerSubsystem_h
+#define PHG4ProfilerSubsystem_h
+
+#include "PHG4Subsystem.h"
+#include <string>
+
+class PHG4ProfilerSteppingAction;
+class PHG4ProfilerTrackingAction;
+
+//! profiles where G4 spends its time
+/*!
+  Register with PHG4Reco like a detector, the stepping action counts the
+  steps and samples the wall-clock time per logical volume, region,
+  particle and kinetic energy (see PHG4ProfilerSteppingAction), the
+  tracking action counts the tracks. The report is printed at End(). Single threaded only
+*/
+class PHG4ProfilerSubsystem: public PHG4Subsystem
+{
+
+  public:
+
+  //! constructor
+  PHG4ProfilerSubsystem( const std::string &name = "PROFILER" );
+
+  //! destructor
+  virtual ~PHG4ProfilerSubsystem( void );
+
+  //! init
+  int InitRun(PHCompositeNode *);
+
+  //! no timing sample across events
+  int process_event(PHCompositeNode *);
+
+  //! print the report
+  int End(PHCompositeNode *);
+
+  //! accessors (reimplemented)
+  virtual PHG4SteppingAction* GetSteppingAction( void ) const;
+  virtual PHG4TrackingAction* GetTrackingAction( void ) const;
+
+  //! time every n'th step (default 100)
+  void SetSamplingInterval(const unsigned int n) {sampling = n;}
+
+  //! number of lines per table in the report (default 30)
+  void SetReportLength(const unsigned int n) {nlines = n;}
+
+  //! write the report into this file instead of stdout
+  void SetReportFile(const std::string &name) {reportfile = name;}
+
+  private:
+
+  PHG4ProfilerSteppingAction* steppingAction_;
+  PHG4ProfilerTrackingAction* trackingAction_;
+
+  unsigned int sampling;
+  unsigned int nlines;
+  std::string reportfile;
+
+};
+
+#endif
@@ -0,0 +1,15 @@
+#include "PHG4ProfilerTrackingAction.h"
+#include "PHG4ProfilerSteppingAction.h"
+
+//________________________________________________________
+PHG4ProfilerTrackingAction::PHG4ProfilerTrackingAction( PHG4ProfilerSteppingAction* steppingAction ):
+  steppingAction_( steppingAction )
+{}
+
+//________________________________________________________
+void PHG4ProfilerTrackingAction::PreUserTrackingAction( const G4Track* track )
+{
+  // the last step of the previous track is not timed
+  steppingAction_->StopTiming();
+  steppingAction_->AddTrack(track);
+}
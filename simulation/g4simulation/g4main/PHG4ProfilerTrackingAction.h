@@ -0,0 +1,32 @@
+#ifndef PHG4ProfilerTrackingAction_h
+#define PHG4ProfilerTrackingAction_h
+
+#include "PHG4TrackingAction.h"
+
+class PHG4ProfilerSteppingAction;
+
+//! counts the tracks for PHG4ProfilerSteppingAction
+class PHG4ProfilerTrackingAction : public PHG4TrackingAction
+{
+public:
+
+  //! constructor
+  PHG4ProfilerTrackingAction( PHG4ProfilerSteppingAction* );
+
+  //! destructor
+  virtual ~PHG4ProfilerTrackingAction() {}
+
+  //! tracking action
+  virtual void PreUserTrackingAction(const G4Track*);
+
+  //! no nodes needed
+  virtual void SetInterfacePointers( PHCompositeNode* ) {}
+
+private:
+
+  PHG4ProfilerSteppingAction *steppingAction_;
+
+};
+
+
+#endif
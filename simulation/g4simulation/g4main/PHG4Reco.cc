@@ -1,12 +1,18 @@
 #include "PHG4Reco.h"
 
+#include "PHG4ActionInitialization.h"
 #include "PHG4PrimaryGeneratorAction.h"
 #include "G4TBMagneticFieldSetup.hh"
 #include "PHG4PhenixDetector.h"
 #include "PHG4PhenixSteppingAction.h"
 #include "PHG4PhenixTrackingAction.h"
 #include "PHG4PhenixEventAction.h"
+#include "PHG4OverlapChecker.h"
+#include "PHG4ShowerLibraryFastSim.h"
+#include "PHG4TrackKillPolicy.h"
 #include "PHG4Subsystem.h"
+#include "PHG4SteppingAction.h"
+#include "PHG4TrackingAction.h"
 #include "PHG4InEvent.h"
 #include "PHG4Utils.h"
 #include "PHG4UIsession.h"
@@ -26,6 +32,9 @@
 #include <CLHEP/Random/Random.h>
 
 #include <Geant4/G4RunManager.hh>
+#ifdef G4MULTITHREADED
+#include <Geant4/G4MTRunManager.hh>
+#endif
 
 #include <Geant4/G4VisExecutive.hh>
 #include <Geant4/G4OpenGLImmediateX.hh>
@@ -77,12 +86,23 @@
 #include <Geant4/QGSP_BERT_HP.hh>
 #endif
 
+#include <Geant4/G4ProductionCuts.hh>
+#include <Geant4/G4Region.hh>
+#include <Geant4/G4RegionStore.hh>
+#include <Geant4/G4Navigator.hh>
+#include <Geant4/G4TransportationManager.hh>
+#include <Geant4/G4VUserPhysicsList.hh>
+
 #include <boost/foreach.hpp>
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
 
 using namespace std;
 
@@ -107,13 +127,21 @@ PHG4Reco::PHG4Reco( const string &name ) :
   steppingAction_(NULL),
   trackingAction_(NULL),
   generatorAction_(NULL),
+  actionInit_(NULL),
+  killPolicy_(NULL),
   visManager(NULL),
   _eta_coverage(1.0),
   mapdim(0),
   fieldmapfile("NONE"),
+  fieldmap_grid(false),
   worldshape("G4Tubs"),
   worldmaterial("G4_AIR"),
   physicslist("QGSP_BERT"),
+  nthreads(1),
+  mtrunmanager(false),
+  store_physics_tables(false),
+  overlapcheck_threads(0),
+  overlapcheck_resolution(1000),
   active_decayer_(true),
   active_force_decay_(false),
   force_decay_type_(kAll),
@@ -134,8 +162,22 @@ PHG4Reco::~PHG4Reco( void )
   delete gui_thread;
   delete field_;
   delete runManager_;
+  // the run manager owns the actions given to it, in multi threaded
+  // running the master actions are only used by us
+  if (mtrunmanager)
+    {
+      delete eventAction_;
+      delete steppingAction_;
+      delete trackingAction_;
+      delete generatorAction_;
+    }
   if (uisession_) delete uisession_;
   delete visManager;
+  BOOST_FOREACH(PHG4ShowerLibraryFastSim *fastsim, fastsims_)
+    {
+      delete fastsim;
+    }
+  delete killPolicy_;
 }
 
 //_________________________________________________________________
@@ -158,7 +200,27 @@ int PHG4Reco::Init( PHCompositeNode* topNode )
      uimanager->SetCoutDestination(uisession_);
   }
   
-  runManager_ = new G4RunManager();
+#ifdef G4MULTITHREADED
+  if (nthreads > 1)
+    {
+      if (verbosity > 0) cout << "PHG4Reco::Init - running G4 with " << nthreads << " threads" << endl;
+      G4MTRunManager *mtrunManager = new G4MTRunManager();
+      mtrunManager->SetNumberOfThreads(nthreads);
+      runManager_ = mtrunManager;
+      mtrunmanager = true;
+    }
+#else
+  if (nthreads > 1)
+    {
+      cout << "PHG4Reco::Init - G4 was built without multi threading, ignoring set_num_threads("
+           << nthreads << ")" << endl;
+      nthreads = 1;
+    }
+#endif
+  if (!runManager_)
+    {
+      runManager_ = new G4RunManager();
+    }
 
   DefineMaterials();
 
@@ -166,7 +228,7 @@ int PHG4Reco::Init( PHCompositeNode* topNode )
   if (verbosity > 1) cout << "PHG4Reco::Init - create magnetic field setup" << endl;
   if (fieldmapfile != "NONE")
     {
-      field_ = new G4TBMagneticFieldSetup(fieldmapfile, mapdim, magfield_rescale) ;
+      field_ = new G4TBMagneticFieldSetup(fieldmapfile, mapdim, magfield_rescale, fieldmap_grid) ;
       magfield = field_->get_magfield_at_000(2); // get the z coordinate at 0/0/0
       if (verbosity > 1)
 	{
@@ -272,6 +334,40 @@ PHG4Reco::InitRun( PHCompositeNode* topNode )
       reco->InitRun( topNode );
     }
 
+#ifdef G4MULTITHREADED
+  // every subsystem which records hits or truth needs worker actions,
+  // a partial simulation must not pass unnoticed
+  if (nthreads > 1)
+    {
+      string unsupported;
+      BOOST_FOREACH( PHG4Subsystem * g4sub, subsystems_)
+	{
+	  PHG4SteppingAction *stepping = g4sub->GetSteppingAction() ? g4sub->CreateWorkerSteppingAction() : NULL;
+	  PHG4TrackingAction *tracking = g4sub->GetTrackingAction() ? g4sub->CreateWorkerTrackingAction() : NULL;
+	  if ((g4sub->GetSteppingAction() && !stepping) || (g4sub->GetTrackingAction() && !tracking))
+	    {
+	      unsupported += " subsystem " + g4sub->Name();
+	    }
+	  delete stepping;
+	  delete tracking;
+	}
+      if (killPolicy_)
+	{
+	  unsupported += " track kill policy";
+	}
+      if (!fastsims_.empty())
+	{
+	  unsupported += " shower library fast simulation";
+	}
+      if (!unsupported.empty())
+	{
+	  cout << PHWHERE << " not supported in multi threaded running:" << unsupported
+	       << ", run with set_num_threads(1)" << endl;
+	  gSystem->Exit(1);
+	}
+    }
+#endif
+
   // create phenix detector, add subsystems, and register to GEANT
   if (verbosity > 1) cout << "PHG4Reco::Init - create detector" << endl;
   detector_ = new PHG4PhenixDetector();
@@ -304,7 +400,12 @@ PHG4Reco::InitRun( PHCompositeNode* topNode )
 	  eventAction_->AddAction(evtact);
 	}
     }
-  runManager_->SetUserAction(eventAction_ );
+  eventAction_->SetKillPolicy(killPolicy_);
+  // in multi threaded running the event actions are called by us once per input event
+  if (!mtrunmanager)
+    {
+      runManager_->SetUserAction(eventAction_ );
+    }
 
   // create main stepping action, add subsystems and register to GEANT
   steppingAction_ = new PHG4PhenixSteppingAction();
@@ -320,7 +421,43 @@ PHG4Reco::InitRun( PHCompositeNode* topNode )
 	  steppingAction_->AddAction( g4sub->GetSteppingAction() );
 	}
     }
-  runManager_->SetUserAction(steppingAction_ );
+  if (killPolicy_)
+    {
+      if (verbosity > 0)
+	{
+	  killPolicy_->Print();
+	}
+      steppingAction_->SetKillPolicy(killPolicy_);
+    }
+
+  // frozen shower fast simulation, uses the stepping action of its subsystem
+  BOOST_FOREACH(PHG4ShowerLibraryFastSim *fastsim, fastsims_)
+    {
+      PHG4SteppingAction *action = NULL;
+      BOOST_FOREACH( PHG4Subsystem * g4sub, subsystems_)
+	{
+	  if (g4sub->Name() == fastsim->GetSubsystemName())
+	    {
+	      action = g4sub->GetSteppingAction();
+	    }
+	}
+      if (!action)
+	{
+	  cout << PHWHERE << " no subsystem with stepping action named " << fastsim->GetSubsystemName()
+	       << " for the shower library" << endl;
+	  gSystem->Exit(1);
+	}
+      fastsim->Verbosity(verbosity);
+      if (fastsim->Init(action))
+	{
+	  gSystem->Exit(1);
+	}
+      steppingAction_->AddAction(fastsim);
+    }
+  if (!mtrunmanager)
+    {
+      runManager_->SetUserAction(steppingAction_ );
+    }
 
   // create main tracking action, add subsystems and register to GEANT
   trackingAction_ = new PHG4PhenixTrackingAction();
@@ -328,11 +465,34 @@ PHG4Reco::InitRun( PHCompositeNode* topNode )
     {
       trackingAction_->AddAction( g4sub->GetTrackingAction() );
     }
-  runManager_->SetUserAction(trackingAction_ );
+  trackingAction_->SetKillPolicy(killPolicy_);
+  if (!mtrunmanager)
+    {
+      runManager_->SetUserAction(trackingAction_ );
+    }
+#ifdef G4MULTITHREADED
+  else
+    {
+      actionInit_ = new PHG4ActionInitialization(generatorAction_, subsystems_, topNode);
+      actionInit_->SetField(fieldmapfile, mapdim, magfield, magfield_rescale, fieldmap_grid);
+      runManager_->SetUserInitialization(actionInit_);
+    }
+#endif
 
   // initialize
   runManager_->Initialize();
 
+  // production cut regions need the constructed geometry
+  if (killPolicy_)
+    {
+      killPolicy_->ApplyProductionCuts();
+    }
+
+  // the physics tables are built in the first BeamOn, the geometry (materials, regions) is known now
+  SetupPhysicsTableCache();
+
+  CheckOverlaps();
+
   // add cerenkov and optical photon processes
   // cout << endl << "Ignore the next message - we implemented this correctly" << endl;
   G4Cerenkov* theCerenkovProcess = new G4Cerenkov("Cerenkov");
@@ -482,8 +642,30 @@ int PHG4Reco::process_event( PHCompositeNode* topNode )
       cout << " PHG4Reco::process_event - " << "run one event :" << endl;
       ineve->identify();
     }
-  runManager_->BeamOn( 1 );
+  if (nthreads > 1)
+    {
+      // split the input event into G4Events which are distributed over the
+      // worker threads, the event actions run once after all of them are done
+      int nparticles = distance(ineve->GetParticles().first, ineve->GetParticles().second);
+      int nsubevents = min(nthreads, max(nparticles, 1));
+      generatorAction_->SetNumberOfSubEvents(nsubevents);
+      eventAction_->BeginOfEventAction(NULL);
+      runManager_->BeamOn( nsubevents );
+      eventAction_->EndOfEventAction(NULL);
+    }
+  else
+    {
+      runManager_->BeamOn( 1 );
+    }
+  BOOST_FOREACH(PHG4ShowerLibraryFastSim *fastsim, fastsims_)
+    {
+      fastsim->EndOfEvent();
+    }
   _timer.get()->stop();
+  if (store_physics_tables)
+    {
+      StorePhysicsTables();
+    }
 
   BOOST_FOREACH( PHG4Subsystem * g4sub, subsystems_)
     {
@@ -519,8 +701,20 @@ PHG4Reco::ResetEvent(PHCompositeNode *topNode)
 
 //_________________________________________________________________
 int
-PHG4Reco::End( PHCompositeNode* )
+PHG4Reco::End( PHCompositeNode* topNode )
 {
+  BOOST_FOREACH(SubsysReco * reco, subsystems_)
+    {
+      reco->End( topNode );
+    }
+  BOOST_FOREACH(PHG4ShowerLibraryFastSim *fastsim, fastsims_)
+    {
+      fastsim->End();
+    }
+  if (killPolicy_)
+    {
+      killPolicy_->PrintStatistics();
+    }
   return 0;
 }
 
@@ -554,13 +748,23 @@ PHG4Reco::setupInputEventNodeReader(PHCompositeNode *topNode)
       dstNode->addNode(newNode);
     }
   generatorAction_ = new PHG4PrimaryGeneratorAction();
-  runManager_->SetUserAction(generatorAction_ );
+  // in multi threaded running the workers have their own generators
+  // which get the input event from this one
+  if (!mtrunmanager)
+    {
+      runManager_->SetUserAction(generatorAction_ );
+    }
   return 0;
 }
 
 void
 PHG4Reco::setGeneratorAction(G4VUserPrimaryGeneratorAction *action)
 {
+  if (mtrunmanager)
+    {
+      cout << PHWHERE << " replacing the generator action is not supported in multi threaded running" << endl;
+      return;
+    }
   if (runManager_)
     {
       runManager_->SetUserAction(action);
@@ -576,6 +780,180 @@ PHG4Reco::set_rapidity_coverage(const double eta)
   PHG4Utils::SetPseudoRapidityCoverage(eta);
 }
 
+string
+PHG4Reco::PhysicsTableKey() const
+{
+  ostringstream config;
+  config << "G4 " << G4VERSION_NUMBER << endl;
+  config << "physics list " << physicslist << endl;
+  config << "decayer " << active_decayer_ << " " << active_force_decay_ << " " << force_decay_type_ << endl;
+  config << "default cut " << runManager_->GetUserPhysicsList()->GetDefaultCutValue() << endl;
+  const G4MaterialTable *materials = G4Material::GetMaterialTable();
+  for (G4MaterialTable::const_iterator iter = materials->begin(); iter != materials->end(); ++iter)
+    {
+      const G4Material *mat = *iter;
+      config << "material " << mat->GetName() << " " << mat->GetDensity() << " " << mat->GetIonisation()->GetMeanExcitationEnergy();
+      for (unsigned int i = 0; i < mat->GetNumberOfElements(); i++)
+	{
+	  config << " " << mat->GetElement(i)->GetName() << " " << mat->GetFractionVector()[i];
+	}
+      config << endl;
+    }
+  G4RegionStore *regions = G4RegionStore::GetInstance();
+  for (G4RegionStore::const_iterator iter = regions->begin(); iter != regions->end(); ++iter)
+    {
+      config << "region " << (*iter)->GetName();
+      if (G4ProductionCuts *cuts = (*iter)->GetProductionCuts())
+	{
+	  const vector<G4double> &cutvalues = cuts->GetProductionCuts();
+	  for (vector<G4double>::const_iterator citer = cutvalues.begin(); citer != cutvalues.end(); ++citer)
+	    {
+	      config << " " << *citer;
+	    }
+	}
+      config << endl;
+    }
+  // 64 bit FNV-1a
+  unsigned long long hash = 14695981039346656037ULL;
+  const string configstr = config.str();
+  for (string::const_iterator iter = configstr.begin(); iter != configstr.end(); ++iter)
+    {
+      hash ^= (unsigned char) *iter;
+      hash *= 1099511628211ULL;
+    }
+  ostringstream key;
+  key << physicslist << "_" << hex << hash;
+  return key.str();
+}
+
+void
+PHG4Reco::CheckOverlaps()
+{
+  if (overlapcheck_threads == 0)
+    {
+      return;
+    }
+  PHG4OverlapChecker checker(overlapcheck_resolution, overlapcheck_threads);
+  checker.Verbosity(verbosity);
+  if (!overlapcheck_cache.empty())
+    {
+      checker.ReadCache(overlapcheck_cache);
+    }
+  checker.Check(G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+  checker.Print();
+  if (!overlapcheck_cache.empty())
+    {
+      checker.WriteCache(overlapcheck_cache);
+    }
+  return;
+}
+
+void
+PHG4Reco::SetupPhysicsTableCache()
+{
+  if (physics_table_cache.empty())
+    {
+      return;
+    }
+  if (mtrunmanager)
+    {
+      cout << "PHG4Reco: the physics table cache is not supported in multi threaded running, ignoring it" << endl;
+      return;
+    }
+  boost::filesystem::path dir = boost::filesystem::path(physics_table_cache) / PhysicsTableKey();
+  physics_table_dir = dir.string();
+  G4VUserPhysicsList *physics = const_cast<G4VUserPhysicsList *>(runManager_->GetUserPhysicsList());
+  if (boost::filesystem::exists(dir / "complete"))
+    {
+      if (verbosity > 0)
+	{
+	  cout << "PHG4Reco: retrieving physics tables from " << physics_table_dir << endl;
+	}
+      // G4 builds the tables itself if the stored ones do not match
+      physics->SetPhysicsTableRetrieved(physics_table_dir);
+    }
+  else
+    {
+      if (verbosity > 0)
+	{
+	  cout << "PHG4Reco: storing physics tables in " << physics_table_dir << " after the first event" << endl;
+	}
+      store_physics_tables = true;
+    }
+  return;
+}
+
+void
+PHG4Reco::StorePhysicsTables()
+{
+  store_physics_tables = false;
+  // write into a job specific directory which is renamed when complete, so
+  // concurrent jobs never see partially written tables
+  ostringstream tmpname;
+  tmpname << physics_table_dir << ".tmp" << getpid();
+  boost::filesystem::path tmpdir(tmpname.str());
+  try
+    {
+      boost::filesystem::create_directories(tmpdir);
+    }
+  catch (const boost::filesystem::filesystem_error &e)
+    {
+      cout << PHWHERE << " cannot create " << tmpname.str() << ": " << e.what() << endl;
+      return;
+    }
+  G4VUserPhysicsList *physics = const_cast<G4VUserPhysicsList *>(runManager_->GetUserPhysicsList());
+  if (!physics->StorePhysicsTable(tmpname.str()))
+    {
+      cout << PHWHERE << " storing the physics tables in " << tmpname.str() << " failed" << endl;
+      boost::filesystem::remove_all(tmpdir);
+      return;
+    }
+  ofstream complete((tmpdir / "complete").string().c_str());
+  complete << physicslist << endl;
+  complete.close();
+  try
+    {
+      boost::filesystem::rename(tmpdir, physics_table_dir);
+    }
+  catch (const boost::filesystem::filesystem_error &)
+    {
+      // another job was faster
+      boost::filesystem::remove_all(tmpdir);
+      return;
+    }
+  if (verbosity > 0)
+    {
+      cout << "PHG4Reco: stored physics tables in " << physics_table_dir << endl;
+    }
+  return;
+}
+
+void
+PHG4Reco::SetTrackKillPolicy(PHG4TrackKillPolicy *policy)
+{
+  delete killPolicy_;
+  killPolicy_ = policy;
+  return;
+}
+
+void
+PHG4Reco::set_shower_library(const string &subsystem, const string &libraryfile, const double emin, const string &envelope)
+{
+  PHG4ShowerLibraryFastSim *fastsim = new PHG4ShowerLibraryFastSim(subsystem, libraryfile, envelope, false);
+  fastsim->SetEnergyThreshold(emin);
+  fastsims_.push_back(fastsim);
+  return;
+}
+
+void
+PHG4Reco::record_shower_library(const string &subsystem, const string &libraryfile, const double emin, const string &envelope)
+{
+  PHG4ShowerLibraryFastSim *fastsim = new PHG4ShowerLibraryFastSim(subsystem, libraryfile, envelope, true);
+  fastsim->SetEnergyThreshold(emin);
+  fastsims_.push_back(fastsim);
+  return;
+}
+
 void
 PHG4Reco::G4Seed(const unsigned int i)
 {
@@ -12,12 +12,15 @@
 // Forward declerations
 class PHCompositeNode;
 class G4RunManager;
+class PHG4ActionInitialization;
 class PHG4PrimaryGeneratorAction;
 class PHG4PhenixDetector;
 class PHG4PhenixEventAction;
 class PHG4PhenixSteppingAction;
 class PHG4PhenixTrackingAction;
 class PHG4Subsystem;
+class PHG4ShowerLibraryFastSim;
+class PHG4TrackKillPolicy;
 class PHG4EventGenerator;
 class G4TBMagneticFieldSetup;
 class G4VUserPrimaryGeneratorAction;
@@ -77,6 +80,10 @@ class PHG4Reco: public SubsysReco
   { fieldmapfile = fmap; mapdim = dim;}
 
   void set_field_rescale(const float rescale) {magfield_rescale = rescale;}
+
+  //! use PHG4FieldGrid (uniform grid, faster lookup) for 2D/3D field maps
+  //! which also picks up the binary cache of the map if it exists (see phg4fieldgridcache)
+  void set_field_map_grid(const bool b = true) {fieldmap_grid = b;}
   
   void set_decayer_active(bool b) {active_decayer_ = b;}
   void set_force_decay(EDecayType force_decay_type) {
@@ -97,8 +104,51 @@ class PHG4Reco: public SubsysReco
   void SetWorldMaterial(const std::string &s) {worldmaterial = s;}
   void SetPhysicsList(const std::string &s) {physicslist = s;}
 
+  //! cache the G4 physics tables in dir/<configuration key>
+  /*!
+  the key is a hash of the G4 version, physics list, decayer settings, materials
+  and production cuts. If tables for the key exist they are retrieved instead of
+  being built, otherwise they are stored after the first event. Single threaded only
+  */
+  void set_physics_table_cache(const std::string &dir) {physics_table_cache = dir;}
+
+  //! run G4 with n worker threads (needs a multi threaded G4 build)
+  /*!
+  every input event is split into up to n G4Events which are simulated
+  concurrently, the hits are merged into the node tree. All subsystems with
+  stepping or tracking actions have to implement PHG4Subsystem::CreateWorkerSteppingAction
+  and CreateWorkerTrackingAction, otherwise InitRun stops with an error (as it does for
+  the track kill policy and the shower library fast simulation)
+  */
+  void set_num_threads(const int n) {nthreads = n;}
+  int get_num_threads() const {return nthreads;}
+
   void set_rapidity_coverage(const double eta);
 
+  //! check all placed volumes for overlaps after the construction (PHG4OverlapChecker)
+  /*!
+    resolution surface points per volume, on nthreads threads. With a
+    cachefile the volumes found clean are stored and skipped in the
+    next job if their geometry did not change
+  */
+  void set_overlap_check(const unsigned int nthreads = 1, const std::string &cachefile = "", const int resolution = 1000)
+  {overlapcheck_threads = nthreads; overlapcheck_cache = cachefile; overlapcheck_resolution = resolution;}
+
+  //! kill rules for tracks which do not contribute to hits (PHG4TrackKillPolicy), takes ownership
+  //! single threaded only
+  void SetTrackKillPolicy(PHG4TrackKillPolicy *policy);
+
+  //! frozen shower fast simulation for a calorimeter (PHG4ShowerLibraryFastSim)
+  /*!
+  electrons and photons above emin (GeV) entering the envelope volume (default:
+  the volume named like the subsystem) are killed and a shower from the library
+  is deposited as hits of the subsystem. Not available in multi threaded running
+  */
+  void set_shower_library(const std::string &subsystem, const std::string &libraryfile, const double emin = 1., const std::string &envelope = "");
+
+  //! generate the shower library for set_shower_library() from the full simulation of single electrons/photons
+  void record_shower_library(const std::string &subsystem, const std::string &libraryfile, const double emin = 0.5, const std::string &envelope = "");
+
   int setupInputEventNodeReader(PHCompositeNode *);
 
   static void G4Seed(const unsigned int i);
@@ -114,6 +164,12 @@ class PHG4Reco: public SubsysReco
   
   int InitUImanager();
   void DefineMaterials();
+
+  //! hash of everything the physics tables depend on (after the geometry is constructed)
+  std::string PhysicsTableKey() const;
+  void SetupPhysicsTableCache();
+  void StorePhysicsTables();
+  void CheckOverlaps();
   float magfield;
   float magfield_rescale;
   double WorldSize[3];
@@ -142,19 +198,39 @@ class PHG4Reco: public SubsysReco
   //! event generator (read from PHG4INEVENT node)
   PHG4PrimaryGeneratorAction* generatorAction_;
 
+  //! creates the worker thread actions in multi threaded running
+  PHG4ActionInitialization* actionInit_;
+
   //! list of subsystems
   typedef std::list<PHG4Subsystem*> SubsystemList;
   SubsystemList subsystems_;
 
+  //! frozen shower fast simulations
+  std::list<PHG4ShowerLibraryFastSim*> fastsims_;
+
+  PHG4TrackKillPolicy *killPolicy_;
+
   // visualization
   G4VisManager* visManager;
 
   double _eta_coverage;
   int mapdim;
   std::string fieldmapfile;
+  bool fieldmap_grid;
   std::string worldshape;
   std::string worldmaterial;
   std::string physicslist;
+  int nthreads;
+  //! runManager_ is a G4MTRunManager, the user actions are set up by actionInit_
+  bool mtrunmanager;
+
+  std::string physics_table_cache;
+  std::string physics_table_dir;
+  bool store_physics_tables;
+
+  unsigned int overlapcheck_threads; // 0: no overlap check
+  std::string overlapcheck_cache;
+  int overlapcheck_resolution;
 
   // settings for the external Pythia6 decayer
   bool active_decayer_;     //< turn on/off decayer
@@ -0,0 +1,253 @@
+#include "PHG4ShowerLibrary.h"
+
+#include <phool/phool.h>
+
+#include <TFile.h>
+#include <TNtuple.h>
+
+#include <Geant4/Randomize.hh>
+
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+// the bin indices are packed into one key, 11 bits per axis
+static const int bin_offset = 1024;
+static const long bin_range = 2048;
+
+PHG4ShowerLibrary::PHG4ShowerLibrary()
+{
+  bin_width[0] = 0.5;
+  bin_width[1] = 0.05;
+  bin_width[2] = 0.1;
+}
+
+void
+PHG4ShowerLibrary::SetBinning(const double log2e_width, const double cosangle_width, const double eta_width)
+{
+  bin_width[0] = log2e_width;
+  bin_width[1] = cosangle_width;
+  bin_width[2] = eta_width;
+  // rebin the loaded showers
+  bins.clear();
+  resolved.clear();
+  for (unsigned int i = 0; i < showers.size(); i++)
+    {
+      int index[3];
+      get_bin(showers[i].e, showers[i].cosangle, showers[i].eta, index);
+      bins[bin_key(index)].push_back(i);
+    }
+  return;
+}
+
+void
+PHG4ShowerLibrary::get_bin(const double e, const double cosangle, const double eta, int index[3]) const
+{
+  double x[3];
+  x[0] = log(max(e, 1e-6)) / log(2.);
+  x[1] = cosangle;
+  x[2] = eta;
+  for (int i = 0; i < 3; i++)
+    {
+      index[i] = (int) floor(x[i] / bin_width[i]);
+      index[i] = max(-bin_offset, min(bin_offset - 1, index[i]));
+    }
+  return;
+}
+
+long
+PHG4ShowerLibrary::bin_key(const int index[3])
+{
+  return ((index[0] + bin_offset) * bin_range + index[1] + bin_offset) * bin_range + index[2] + bin_offset;
+}
+
+void
+PHG4ShowerLibrary::AddShower(const Shower &shower)
+{
+  showers.push_back(shower);
+  int index[3];
+  get_bin(shower.e, shower.cosangle, shower.eta, index);
+  bins[bin_key(index)].push_back(showers.size() - 1);
+  resolved.clear();
+  return;
+}
+
+long
+PHG4ShowerLibrary::closest_bin(const long key)
+{
+  map<long, long>::const_iterator iter = resolved.find(key);
+  if (iter != resolved.end())
+    {
+      return iter->second;
+    }
+  long index[3];
+  index[2] = key % bin_range;
+  index[1] = (key / bin_range) % bin_range;
+  index[0] = key / (bin_range * bin_range);
+  // distance in units of bins, the energy counts most since the
+  // showers are scaled to the requested energy
+  const double weight[3] = {4., 1., 1.};
+  long best = -1;
+  double bestdist = 0;
+  for (BinMap::const_iterator biter = bins.begin(); biter != bins.end(); ++biter)
+    {
+      long bindex[3];
+      bindex[2] = biter->first % bin_range;
+      bindex[1] = (biter->first / bin_range) % bin_range;
+      bindex[0] = biter->first / (bin_range * bin_range);
+      double dist = 0;
+      for (int i = 0; i < 3; i++)
+	{
+	  dist += weight[i] * (bindex[i] - index[i]) * (bindex[i] - index[i]);
+	}
+      if (best < 0 || dist < bestdist)
+	{
+	  best = biter->first;
+	  bestdist = dist;
+	}
+    }
+  resolved[key] = best;
+  return best;
+}
+
+const PHG4ShowerLibrary::Shower *
+PHG4ShowerLibrary::Sample(const double e, const double cosangle, const double eta)
+{
+  if (bins.empty())
+    {
+      return NULL;
+    }
+  int index[3];
+  get_bin(e, cosangle, eta, index);
+  long key = bin_key(index);
+  BinMap::const_iterator iter = bins.find(key);
+  if (iter == bins.end())
+    {
+      iter = bins.find(closest_bin(key));
+    }
+  const vector<unsigned int> &candidates = iter->second;
+  unsigned int pick = (unsigned int) (G4UniformRand() * candidates.size());
+  if (pick >= candidates.size())
+    {
+      pick = candidates.size() - 1;
+    }
+  return &showers[candidates[pick]];
+}
+
+int
+PHG4ShowerLibrary::Load(const string &filename)
+{
+  TFile *f = TFile::Open(filename.c_str());
+  if (!f || f->IsZombie())
+    {
+      cout << PHWHERE << " could not open shower library " << filename << endl;
+      delete f;
+      return -1;
+    }
+  TNtuple *nt = dynamic_cast<TNtuple *>(f->Get("showerlib"));
+  if (!nt)
+    {
+      cout << PHWHERE << " no showerlib ntuple in " << filename << endl;
+      delete f;
+      return -1;
+    }
+  Float_t shower, e, cosangle, eta, l, u, v, t, edep, light, active;
+  nt->SetBranchAddress("shower", &shower);
+  nt->SetBranchAddress("e", &e);
+  nt->SetBranchAddress("cosangle", &cosangle);
+  nt->SetBranchAddress("eta", &eta);
+  nt->SetBranchAddress("l", &l);
+  nt->SetBranchAddress("u", &u);
+  nt->SetBranchAddress("v", &v);
+  nt->SetBranchAddress("t", &t);
+  nt->SetBranchAddress("edep", &edep);
+  nt->SetBranchAddress("light", &light);
+  nt->SetBranchAddress("active", &active);
+  Shower current;
+  int currentid = -1;
+  for (Long64_t i = 0; i < nt->GetEntries(); i++)
+    {
+      nt->GetEntry(i);
+      if ((int) shower != currentid)
+	{
+	  if (currentid >= 0)
+	    {
+	      AddShower(current);
+	    }
+	  currentid = (int) shower;
+	  current.e = e;
+	  current.cosangle = cosangle;
+	  current.eta = eta;
+	  current.spots.clear();
+	}
+      Spot spot;
+      spot.l = l;
+      spot.u = u;
+      spot.v = v;
+      spot.t = t;
+      spot.edep = edep;
+      spot.light_yield = light;
+      spot.active = (active > 0);
+      current.spots.push_back(spot);
+    }
+  if (currentid >= 0)
+    {
+      AddShower(current);
+    }
+  delete f;
+  return 0;
+}
+
+int
+PHG4ShowerLibrary::Save(const string &filename) const
+{
+  TFile *f = TFile::Open(filename.c_str(), "RECREATE");
+  if (!f || f->IsZombie())
+    {
+      cout << PHWHERE << " could not create shower library " << filename << endl;
+      delete f;
+      return -1;
+    }
+  TNtuple *nt = new TNtuple("showerlib", "frozen showers", "shower:e:cosangle:eta:l:u:v:t:edep:light:active");
+  float row[11];
+  for (unsigned int i = 0; i < showers.size(); i++)
+    {
+      const Shower &shower = showers[i];
+      row[0] = i;
+      row[1] = shower.e;
+      row[2] = shower.cosangle;
+      row[3] = shower.eta;
+      for (vector<Spot>::const_iterator iter = shower.spots.begin(); iter != shower.spots.end(); ++iter)
+	{
+	  row[4] = iter->l;
+	  row[5] = iter->u;
+	  row[6] = iter->v;
+	  row[7] = iter->t;
+	  row[8] = iter->edep;
+	  row[9] = iter->light_yield;
+	  row[10] = iter->active ? 1 : 0;
+	  nt->Fill(row);
+	}
+    }
+  f->Write();
+  f->Close();
+  delete f;
+  return 0;
+}
+
+void
+PHG4ShowerLibrary::Print() const
+{
+  unsigned int nspots = 0;
+  for (vector<Shower>::const_iterator iter = showers.begin(); iter != showers.end(); ++iter)
+    {
+      nspots += iter->spots.size();
+    }
+  cout << "PHG4ShowerLibrary: " << showers.size() << " showers with "
+       << nspots << " spots in " << bins.size() << " bins" << endl;
+  cout << "bin width log2(E): " << bin_width[0]
+       << ", cos(angle): " << bin_width[1]
+       << ", eta: " << bin_width[2] << endl;
+  return;
+}
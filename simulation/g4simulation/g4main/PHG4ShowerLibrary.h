@@ -0,0 +1,82 @@
+#ifndef PHG4SHOWERLIBRARY_H__
+#define PHG4SHOWERLIBRARY_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+//! library of pre-generated ("frozen") electromagnetic showers
+/*!
+  Every shower is a list of energy deposits (spots) recorded with the full
+  simulation for an electron or photon entering the calorimeter. The spot
+  positions are relative to the entry point in a frame given by the
+  particle direction (l) and two transverse axes (u, v), see
+  PHG4ShowerLibraryFastSim. The showers are binned in log2 of the energy,
+  cosine of the incidence angle (between direction and inward surface
+  normal) and pseudorapidity of the entry point, Sample() returns a
+  random shower of the requested bin or of the closest non empty bin.
+  The library file is a TNtuple "showerlib" with one row per spot.
+*/
+class PHG4ShowerLibrary
+{
+ public:
+
+  struct Spot
+  {
+    float l; // cm along the direction
+    float u; // cm
+    float v; // cm
+    float t; // ns after the entry
+    float edep; // GeV
+    float light_yield; // GeV visible, only for active deposits
+    bool active; // deposited in the active (scintillator) material
+  };
+
+  struct Shower
+  {
+    float e; // GeV energy at the entry
+    float cosangle;
+    float eta;
+    std::vector<Spot> spots;
+  };
+
+  PHG4ShowerLibrary();
+  virtual ~PHG4ShowerLibrary() {}
+
+  //! bin widths in log2(E), cos(angle) and eta
+  void SetBinning(const double log2e_width, const double cosangle_width, const double eta_width);
+
+  //! read the showers from a root file, returns 0 on success
+  int Load(const std::string &filename);
+
+  //! write the showers to a root file, returns 0 on success
+  int Save(const std::string &filename) const;
+
+  //! add a shower (the library takes a copy)
+  void AddShower(const Shower &shower);
+
+  //! random shower of the bin closest to e, cosangle, eta, NULL if the library is empty
+  const Shower *Sample(const double e, const double cosangle, const double eta);
+
+  unsigned int size() const {return showers.size();}
+  unsigned int GetNumBins() const {return bins.size();}
+
+  void Print() const;
+
+ protected:
+
+  typedef std::map<long, std::vector<unsigned int> > BinMap;
+
+  void get_bin(const double e, const double cosangle, const double eta, int index[3]) const;
+  static long bin_key(const int index[3]);
+
+  //! key of the non empty bin closest to this key, resolved once per key
+  long closest_bin(const long key);
+
+  double bin_width[3];
+  std::vector<Shower> showers;
+  BinMap bins;
+  std::map<long, long> resolved;
+};
+
+#endif
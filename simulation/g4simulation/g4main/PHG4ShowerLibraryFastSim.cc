@@ -0,0 +1,374 @@
+#include "PHG4ShowerLibraryFastSim.h"
+#include "PHG4TrackUserInfoV1.h"
+
+#include <phool/phool.h>
+
+#include <Geant4/G4AffineTransform.hh>
+#include <Geant4/G4Gamma.hh>
+#include <Geant4/G4Electron.hh>
+#include <Geant4/G4LogicalVolume.hh>
+#include <Geant4/G4Navigator.hh>
+#include <Geant4/G4NavigationHistory.hh>
+#include <Geant4/G4PhysicalVolumeStore.hh>
+#include <Geant4/G4Positron.hh>
+#include <Geant4/G4Step.hh>
+#include <Geant4/G4SystemOfUnits.hh>
+#include <Geant4/G4TouchableHistory.hh>
+#include <Geant4/G4TransportationManager.hh>
+#include <Geant4/G4VSolid.hh>
+
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+PHG4ShowerLibraryFastSim::PHG4ShowerLibraryFastSim(const string &subsystem, const string &libraryfile, const string &envelopename, const bool record):
+  PHG4SteppingAction(0),
+  subsystem_name(subsystem),
+  library_file(libraryfile),
+  envelope_name(envelopename),
+  record_mode(record),
+  emin(1.),
+  spot_size(0.2),
+  detector_action(NULL),
+  library(NULL),
+  envelope(NULL),
+  navigator(NULL),
+  touchable(NULL),
+  shower_open(false),
+  entry_time(0),
+  nshowers(0),
+  nspots(0),
+  edep_lost(0)
+{
+  if (envelope_name.empty())
+    {
+      envelope_name = subsystem_name;
+    }
+}
+
+PHG4ShowerLibraryFastSim::~PHG4ShowerLibraryFastSim()
+{
+  delete library;
+  delete navigator;
+  delete touchable;
+}
+
+int
+PHG4ShowerLibraryFastSim::Init(PHG4SteppingAction *detaction)
+{
+  detector_action = detaction;
+  delete library;
+  library = new PHG4ShowerLibrary();
+  if (!record_mode)
+    {
+      if (library->Load(library_file))
+	{
+	  return -1;
+	}
+      if (library->size() == 0)
+	{
+	  cout << PHWHERE << " shower library " << library_file << " is empty" << endl;
+	  return -1;
+	}
+    }
+  if (verbosity > 0)
+    {
+      Print();
+    }
+  return 0;
+}
+
+G4VPhysicalVolume *
+PHG4ShowerLibraryFastSim::get_envelope()
+{
+  if (!envelope)
+    {
+      // some detectors have trailing new lines in their volume names
+      G4PhysicalVolumeStore *store = G4PhysicalVolumeStore::GetInstance();
+      for (G4PhysicalVolumeStore::const_iterator iter = store->begin(); iter != store->end(); ++iter)
+	{
+	  string name = (*iter)->GetName();
+	  name.erase(name.find_last_not_of(" \n") + 1);
+	  if (name == envelope_name)
+	    {
+	      envelope = *iter;
+	      break;
+	    }
+	}
+      if (!envelope)
+	{
+	  cout << PHWHERE << " envelope volume " << envelope_name
+	       << " of " << subsystem_name << " not found, exiting" << endl;
+	  exit(1);
+	}
+    }
+  return envelope;
+}
+
+int
+PHG4ShowerLibraryFastSim::deposit_type(G4VPhysicalVolume *volume)
+{
+  map<const G4VPhysicalVolume *, int>::const_iterator iter = volume_type.find(volume);
+  if (iter != volume_type.end())
+    {
+      return iter->second;
+    }
+  int type = detector_action->ShowerDepositType(volume);
+  volume_type[volume] = type;
+  return type;
+}
+
+int
+PHG4ShowerLibraryFastSim::HandlesVolume(G4VPhysicalVolume *volume)
+{
+  if (record_mode)
+    {
+      // needs the deposits inside as well
+      return 1;
+    }
+  // particles enter from outside, inside the calorimeter there is nothing to do
+  if (volume == get_envelope() || deposit_type(volume) >= 0)
+    {
+      return 0;
+    }
+  return 1;
+}
+
+bool
+PHG4ShowerLibraryFastSim::is_entering(const G4Step *step)
+{
+  const G4StepPoint *postPoint = step->GetPostStepPoint();
+  if (postPoint->GetStepStatus() != fGeomBoundary || postPoint->GetPhysicalVolume() != get_envelope())
+    {
+      return false;
+    }
+  const G4ParticleDefinition *def = step->GetTrack()->GetParticleDefinition();
+  if (def != G4Gamma::Definition() && def != G4Electron::Definition() && def != G4Positron::Definition())
+    {
+      return false;
+    }
+  return (postPoint->GetKineticEnergy() / GeV >= emin);
+}
+
+void
+PHG4ShowerLibraryFastSim::entry_frame(const G4StepPoint *point, const G4ThreeVector &dir, double &cosangle, G4ThreeVector &u, G4ThreeVector &v) const
+{
+  // inward normal of the envelope surface at the entry point
+  const G4AffineTransform &transform = point->GetTouchable()->GetHistory()->GetTopTransform();
+  G4ThreeVector localpos = transform.TransformPoint(point->GetPosition());
+  G4ThreeVector normal = point->GetPhysicalVolume()->GetLogicalVolume()->GetSolid()->SurfaceNormal(localpos);
+  normal = -transform.Inverse().TransformAxis(normal);
+  cosangle = dir.dot(normal);
+  u = dir.cross(normal);
+  if (u.mag2() < 1e-12)
+    {
+      // normal incidence, any transverse axis will do
+      u = dir.orthogonal();
+    }
+  u = u.unit();
+  v = dir.cross(u);
+  return;
+}
+
+bool
+PHG4ShowerLibraryFastSim::UserSteppingAction(const G4Step *step, bool)
+{
+  if (record_mode)
+    {
+      record_step(step);
+      return false;
+    }
+  if (!is_entering(step))
+    {
+      return false;
+    }
+  deposit_shower(step->GetTrack(), step->GetPostStepPoint());
+  return true;
+}
+
+void
+PHG4ShowerLibraryFastSim::deposit_shower(G4Track *track, const G4StepPoint *point)
+{
+  double ekin = point->GetKineticEnergy() / GeV;
+  G4ThreeVector dir = point->GetMomentumDirection();
+  G4ThreeVector pos = point->GetPosition();
+  double cosangle;
+  G4ThreeVector u, v;
+  entry_frame(point, dir, cosangle, u, v);
+
+  const PHG4ShowerLibrary::Shower *shower = library->Sample(ekin, cosangle, pos.eta());
+  if (!shower)
+    {
+      return;
+    }
+  track->SetTrackStatus(fStopAndKill);
+
+  int trkid = track->GetTrackID();
+  if (G4VUserTrackInformation *p = track->GetUserInformation())
+    {
+      if (PHG4TrackUserInfoV1 *pp = dynamic_cast<PHG4TrackUserInfoV1 *>(p))
+	{
+	  trkid += pp->GetTrackIdOffset();
+	  pp->SetKeep(1); // the shower deposits belong to this track
+	}
+    }
+
+  if (!navigator)
+    {
+      navigator = new G4Navigator();
+      navigator->SetWorldVolume(G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+      touchable = new G4TouchableHistory();
+    }
+
+  double scale = ekin / shower->e;
+  double t0 = point->GetGlobalTime() / nanosecond;
+  bool relative = false;
+  for (vector<PHG4ShowerLibrary::Spot>::const_iterator iter = shower->spots.begin(); iter != shower->spots.end(); ++iter)
+    {
+      G4ThreeVector spotpos = pos + (iter->l * dir + iter->u * u + iter->v * v) * cm;
+      // consecutive spots are close, the relative search is much faster
+      navigator->LocateGlobalPointAndUpdateTouchable(spotpos, touchable, relative);
+      relative = true;
+      G4VPhysicalVolume *volume = touchable->GetVolume();
+      if (!volume || deposit_type(volume) < 0 ||
+	  !detector_action->AddShowerDeposit(touchable, spotpos.x() / cm, spotpos.y() / cm, spotpos.z() / cm,
+					     t0 + iter->t, iter->edep * scale, iter->light_yield * scale, iter->active, trkid))
+	{
+	  // outside the calorimeter
+	  edep_lost += iter->edep * scale;
+	  continue;
+	}
+      nspots++;
+    }
+  nshowers++;
+  return;
+}
+
+void
+PHG4ShowerLibraryFastSim::record_step(const G4Step *step)
+{
+  if (!shower_open)
+    {
+      if (!is_entering(step))
+	{
+	  return;
+	}
+      const G4StepPoint *point = step->GetPostStepPoint();
+      entry_pos = point->GetPosition();
+      entry_dir = point->GetMomentumDirection();
+      entry_time = point->GetGlobalTime() / nanosecond;
+      double cosangle;
+      entry_frame(point, entry_dir, cosangle, entry_u, entry_v);
+      current_shower.e = point->GetKineticEnergy() / GeV;
+      current_shower.cosangle = cosangle;
+      current_shower.eta = entry_pos.eta();
+      current_shower.spots.clear();
+      spot_index.clear();
+      shower_open = true;
+      return;
+    }
+  double edep = step->GetTotalEnergyDeposit() / GeV;
+  if (edep <= 0)
+    {
+      return;
+    }
+  int type = deposit_type(step->GetPreStepPoint()->GetTouchableHandle()->GetVolume());
+  if (type < 0)
+    {
+      return;
+    }
+  G4ThreeVector pos = 0.5 * (step->GetPreStepPoint()->GetPosition() + step->GetPostStepPoint()->GetPosition()) - entry_pos;
+  double l = pos.dot(entry_dir) / cm;
+  double u = pos.dot(entry_u) / cm;
+  double v = pos.dot(entry_v) / cm;
+  double t = 0.5 * (step->GetPreStepPoint()->GetGlobalTime() + step->GetPostStepPoint()->GetGlobalTime()) / nanosecond - entry_time;
+  double light_yield = (type > 0) ? GetVisibleEnergyDeposition(step) : 0;
+
+  // merge deposits of the same material type within one cube
+  long cube[3];
+  cube[0] = (long) floor(l / spot_size);
+  cube[1] = (long) floor(u / spot_size);
+  cube[2] = (long) floor(v / spot_size);
+  long key = (((cube[0] + 4096) * 8192 + cube[1] + 4096) * 8192 + cube[2] + 4096) * 2 + (type > 0 ? 1 : 0);
+  map<long, unsigned int>::const_iterator iter = spot_index.find(key);
+  if (iter == spot_index.end())
+    {
+      PHG4ShowerLibrary::Spot spot;
+      spot.l = l;
+      spot.u = u;
+      spot.v = v;
+      spot.t = t;
+      spot.edep = edep;
+      spot.light_yield = light_yield;
+      spot.active = (type > 0);
+      spot_index[key] = current_shower.spots.size();
+      current_shower.spots.push_back(spot);
+      return;
+    }
+  // energy weighted position and time
+  PHG4ShowerLibrary::Spot &spot = current_shower.spots[iter->second];
+  double w = edep / (spot.edep + edep);
+  spot.l += w * (l - spot.l);
+  spot.u += w * (u - spot.u);
+  spot.v += w * (v - spot.v);
+  spot.t += w * (t - spot.t);
+  spot.edep += edep;
+  spot.light_yield += light_yield;
+  return;
+}
+
+void
+PHG4ShowerLibraryFastSim::EndOfEvent()
+{
+  if (shower_open)
+    {
+      if (!current_shower.spots.empty())
+	{
+	  library->AddShower(current_shower);
+	  nshowers++;
+	  nspots += current_shower.spots.size();
+	}
+      current_shower.spots.clear();
+      spot_index.clear();
+      shower_open = false;
+    }
+  return;
+}
+
+void
+PHG4ShowerLibraryFastSim::End()
+{
+  if (record_mode)
+    {
+      EndOfEvent();
+      library->Save(library_file);
+    }
+  Print();
+  return;
+}
+
+void
+PHG4ShowerLibraryFastSim::Print() const
+{
+  cout << "PHG4ShowerLibraryFastSim for " << subsystem_name
+       << " (envelope " << envelope_name << "), "
+       << (record_mode ? "recording " : "reading ") << library_file << endl;
+  cout << "electrons/photons above " << emin << " GeV";
+  if (record_mode)
+    {
+      cout << ", spot size " << spot_size << " cm" << endl;
+      cout << nshowers << " showers recorded with " << nspots << " spots" << endl;
+    }
+  else
+    {
+      cout << endl;
+      cout << nshowers << " showers deposited with " << nspots << " spots, "
+	   << edep_lost << " GeV outside the calorimeter" << endl;
+    }
+  if (library)
+    {
+      library->Print();
+    }
+  return;
+}
@@ -0,0 +1,110 @@
+#ifndef PHG4SHOWERLIBRARYFASTSIM_H__
+#define PHG4SHOWERLIBRARYFASTSIM_H__
+
+#include "PHG4SteppingAction.h"
+#include "PHG4ShowerLibrary.h"
+
+#include <Geant4/G4ThreeVector.hh>
+
+#include <map>
+#include <string>
+
+class G4Navigator;
+class G4StepPoint;
+class G4TouchableHistory;
+class G4Track;
+
+//! frozen shower fast simulation for one calorimeter
+/*!
+  Electrons and photons with a kinetic energy above the threshold which
+  enter the envelope volume of the calorimeter are killed, a shower of
+  the library (PHG4ShowerLibrary) is scaled to their energy and its spots
+  are deposited: each spot is located in the geometry and handed to the
+  stepping action of the calorimeter (PHG4SteppingAction::AddShowerDeposit)
+  which stores it as a regular G4 hit, so the cell and tower reconstruction
+  does not change.
+  In recording mode the particles are not killed, the deposits of the full
+  simulation in the volumes of the calorimeter are collected into spots
+  (merged in cubes of the spot size) and the library is written at the
+  end. This has to run on single particle events, the first electron or
+  photon entering the envelope in an event opens the shower.
+  Set up with PHG4Reco::set_shower_library()/record_shower_library().
+*/
+class PHG4ShowerLibraryFastSim: public PHG4SteppingAction
+{
+ public:
+
+  PHG4ShowerLibraryFastSim(const std::string &subsystem, const std::string &libraryfile, const std::string &envelope, const bool record);
+  virtual ~PHG4ShowerLibraryFastSim();
+
+  //! load the library (or prepare the recording), detaction is the stepping action of the calorimeter
+  int Init(PHG4SteppingAction *detaction);
+
+  //! closes the shower in recording mode
+  void EndOfEvent();
+
+  //! writes the library in recording mode, prints statistics
+  void End();
+
+  virtual bool UserSteppingAction(const G4Step *step, bool was_used);
+
+  //! the entering steps are taken in the volumes outside the calorimeter
+  virtual int HandlesVolume(G4VPhysicalVolume *volume);
+
+  //! minimum kinetic energy (GeV) of the electrons/photons which are replaced by showers
+  void SetEnergyThreshold(const double e) {emin = e;}
+
+  //! size (cm) of the cubes in which the deposits are merged into one spot when recording
+  void SetSpotSize(const double s) {spot_size = s;}
+
+  const std::string &GetSubsystemName() const {return subsystem_name;}
+  PHG4ShowerLibrary *GetLibrary() const {return library;}
+
+  void Print() const;
+
+ protected:
+
+  G4VPhysicalVolume *get_envelope();
+
+  //! ShowerDepositType of the calorimeter stepping action, cached per volume
+  int deposit_type(G4VPhysicalVolume *volume);
+
+  //! true if the step enters the envelope with an electron or photon above threshold
+  bool is_entering(const G4Step *step);
+
+  //! incidence angle and shower frame at the entry point
+  void entry_frame(const G4StepPoint *point, const G4ThreeVector &dir, double &cosangle, G4ThreeVector &u, G4ThreeVector &v) const;
+
+  void deposit_shower(G4Track *track, const G4StepPoint *point);
+  void record_step(const G4Step *step);
+
+  std::string subsystem_name;
+  std::string library_file;
+  std::string envelope_name;
+  bool record_mode;
+  double emin;
+  double spot_size;
+
+  PHG4SteppingAction *detector_action;
+  PHG4ShowerLibrary *library;
+  G4VPhysicalVolume *envelope;
+  std::map<const G4VPhysicalVolume *, int> volume_type;
+  G4Navigator *navigator;
+  G4TouchableHistory *touchable;
+
+  // shower which is recorded, spots are merged by cube
+  bool shower_open;
+  G4ThreeVector entry_pos;
+  G4ThreeVector entry_dir;
+  G4ThreeVector entry_u;
+  G4ThreeVector entry_v;
+  double entry_time;
+  PHG4ShowerLibrary::Shower current_shower;
+  std::map<long, unsigned int> spot_index;
+
+  unsigned long nshowers;
+  unsigned long nspots;
+  double edep_lost;
+};
+
+#endif
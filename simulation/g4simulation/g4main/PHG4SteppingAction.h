@@ -6,6 +6,8 @@
 #include <string>
 
 class G4Step;
+class G4VPhysicalVolume;
+class G4VTouchable;
 
 class PHG4SteppingAction
 {
@@ -28,6 +30,42 @@ class PHG4SteppingAction
 
   virtual void Verbosity(const int i) {verbosity = i;}
 
+  //! used by PHG4PhenixSteppingAction to dispatch steps by volume
+  /*!
+  returns 1 if steps in this volume are processed by this action, 0 if
+  UserSteppingAction would do nothing for steps in this volume (it is then not
+  called for them) and -1 if this is not known (the default, the action gets every step)
+  */
+  virtual int HandlesVolume(G4VPhysicalVolume *volume) {return -1;}
+
+  //! frozen shower fast simulation (PHG4ShowerLibraryFastSim)
+  /*!
+  returns 1 if energy deposited in this volume is visible (active material),
+  0 if it is deposited in passive material of this detector and -1 if the
+  volume does not belong to this detector (the default, no fast simulation)
+  */
+  virtual int ShowerDepositType(G4VPhysicalVolume *volume) {return -1;}
+
+  //! store a deposit of a frozen shower in the volume of touchable as hit
+  /*!
+  returns false if the deposit was not stored
+  \param x,y,z position in cm, t time in ns, edep and light_yield in GeV
+  \param active true if the deposit was recorded in the active material, it
+  is stored as active deposit in the readout unit (e.g. tower) containing
+  the point even if the point itself is located in the passive material
+  \param trkid track id (including offset) of the particle which was replaced by the shower
+  */
+  virtual bool AddShowerDeposit(const G4VTouchable *touchable, const double x, const double y, const double z,
+				const double t, const double edep, const double light_yield, const bool active, const int trkid)
+  {return false;}
+
+  //! get relevant nodes from top node passed as argument
+  virtual void SetInterfacePointers( PHCompositeNode* ) {return;}
+
+  //! multi threaded running: called at the end of every G4Event on the worker
+  //! thread (serialized), move the thread local output to the node tree
+  virtual void FlushWorkerOutput() {return;}
+
   //! get scintillation photon count. It require a custom set SCINTILLATIONYIELD property to work
   virtual double GetScintLightYield(const G4Step* step);
 
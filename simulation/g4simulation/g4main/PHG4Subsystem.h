@@ -44,6 +44,23 @@ overlapcheck(false)
   virtual PHG4TrackingAction* GetTrackingAction( void ) const
   { return 0; }
 
+  //! create a new stepping action for a G4 worker thread (multi threaded running)
+  /*!
+  the returned action is owned by the worker, it has to keep its hits in a thread local
+  buffer which is moved to the node tree in PHG4SteppingAction::FlushWorkerOutput.
+  If a subsystem with a stepping action does not implement this, PHG4Reco refuses to run multi threaded
+  */
+  virtual PHG4SteppingAction* CreateWorkerSteppingAction( void ) const
+  { return 0; }
+
+  //! create a new tracking action for a G4 worker thread (multi threaded running)
+  /*!
+  same as CreateWorkerSteppingAction for subsystems with a tracking action, the
+  output is moved to the node tree in PHG4TrackingAction::FlushWorkerOutput
+  */
+  virtual PHG4TrackingAction* CreateWorkerTrackingAction( void ) const
+  { return 0; }
+
   virtual void OverlapCheck(const bool chk = true) {overlapcheck = chk;}
     
  protected:
@@ -0,0 +1,254 @@
+#include "PHG4TrackKillPolicy.h"
+
+#include <Geant4/G4LogicalVolume.hh>
+#include <Geant4/G4PhysicalVolumeStore.hh>
+#include <Geant4/G4ProductionCuts.hh>
+#include <Geant4/G4Region.hh>
+#include <Geant4/G4Step.hh>
+#include <Geant4/G4SystemOfUnits.hh>
+#include <Geant4/G4Track.hh>
+
+#include <cmath>
+#include <iostream>
+#include <set>
+
+using namespace std;
+
+PHG4TrackKillPolicy::PHG4TrackKillPolicy():
+  dry_run(false),
+  last_volume(NULL),
+  last_rules(NULL)
+{}
+
+void
+PHG4TrackKillPolicy::KillBelow(const string &volume, const double emin, const int pdg)
+{
+  Rule rule;
+  rule.type = ENERGY;
+  rule.selector = volume;
+  rule.region = false;
+  rule.pdg = pdg;
+  rule.emin = emin;
+  rule.rmax = 0;
+  rule.zmax = 0;
+  rule.ntracks = 0;
+  rule.ekin = 0;
+  rule.nsteps = 0;
+  rules.push_back(rule);
+  volume_rule_map.clear();
+  last_volume = NULL;
+}
+
+void
+PHG4TrackKillPolicy::KillBelowInRegion(const string &region, const double emin, const int pdg)
+{
+  KillBelow(region, emin, pdg);
+  rules.back().region = true;
+}
+
+void
+PHG4TrackKillPolicy::SetKillRadius(const double r, const double z)
+{
+  for (vector<Rule>::iterator iter = rules.begin(); iter != rules.end(); ++iter)
+    {
+      if (iter->type == RADIUS)
+	{
+	  iter->rmax = r;
+	  iter->zmax = z;
+	  return;
+	}
+    }
+  KillBelow("", 0);
+  rules.back().type = RADIUS;
+  rules.back().rmax = r;
+  rules.back().zmax = z;
+}
+
+void
+PHG4TrackKillPolicy::SetProductionCut(const string &volume, const double cut)
+{
+  production_cuts.push_back(make_pair(volume, cut));
+}
+
+void
+PHG4TrackKillPolicy::ApplyProductionCuts()
+{
+  G4PhysicalVolumeStore *store = G4PhysicalVolumeStore::GetInstance();
+  for (vector<pair<string, double> >::const_iterator iter = production_cuts.begin(); iter != production_cuts.end(); ++iter)
+    {
+      G4Region *region = new G4Region("PHG4Cut_" + iter->first);
+      G4ProductionCuts *cuts = new G4ProductionCuts();
+      cuts->SetProductionCut(iter->second * cm);
+      region->SetProductionCuts(cuts);
+      set<G4LogicalVolume *> added;
+      for (G4PhysicalVolumeStore::const_iterator viter = store->begin(); viter != store->end(); ++viter)
+	{
+	  G4LogicalVolume *logvol = (*viter)->GetLogicalVolume();
+	  if ((*viter)->GetName().compare(0, iter->first.size(), iter->first) != 0 || logvol->IsRootRegion())
+	    {
+	      continue;
+	    }
+	  if (added.insert(logvol).second)
+	    {
+	      region->AddRootLogicalVolume(logvol);
+	    }
+	}
+      if (added.empty())
+	{
+	  cout << "PHG4TrackKillPolicy: no volumes starting with " << iter->first
+	       << " for the production cut" << endl;
+	}
+    }
+  return;
+}
+
+const vector<int> &
+PHG4TrackKillPolicy::volume_rules(G4VPhysicalVolume *volume)
+{
+  if (volume == last_volume && last_rules)
+    {
+      return *last_rules;
+    }
+  VolumeRuleMap::const_iterator iter = volume_rule_map.find(volume);
+  if (iter == volume_rule_map.end())
+    {
+      vector<int> matching;
+      const string &volname = volume->GetName();
+      G4Region *region = volume->GetLogicalVolume()->GetRegion();
+      const string regname = region ? string(region->GetName()) : string();
+      for (unsigned int i = 0; i < rules.size(); i++)
+	{
+	  const string &name = rules[i].region ? regname : volname;
+	  if (rules[i].region ? (name == rules[i].selector) : (name.compare(0, rules[i].selector.size(), rules[i].selector) == 0))
+	    {
+	      matching.push_back(i);
+	    }
+	}
+      iter = volume_rule_map.insert(make_pair(volume, matching)).first;
+    }
+  last_volume = volume;
+  last_rules = &(iter->second);
+  return *last_rules;
+}
+
+void
+PHG4TrackKillPolicy::kill(G4Track *track, const int rule)
+{
+  rules[rule].ntracks++;
+  rules[rule].ekin += track->GetKineticEnergy() / GeV;
+  if (dry_run)
+    {
+      doomed[track->GetTrackID()] = rule;
+    }
+  else
+    {
+      track->SetTrackStatus(fStopAndKill);
+    }
+  return;
+}
+
+bool
+PHG4TrackKillPolicy::Apply(const G4Step *step)
+{
+  G4Track *track = step->GetTrack();
+  if (dry_run && !doomed.empty())
+    {
+      map<int, int>::const_iterator iter = doomed.find(track->GetTrackID());
+      if (iter != doomed.end())
+	{
+	  rules[iter->second].nsteps++;
+	  return false;
+	}
+    }
+  const vector<int> &matching = volume_rules(step->GetPreStepPoint()->GetTouchableHandle()->GetVolume());
+  if (matching.empty())
+    {
+      return false;
+    }
+  double ekin = track->GetKineticEnergy() / GeV;
+  int pdg = track->GetParticleDefinition()->GetPDGEncoding();
+  for (vector<int>::const_iterator iter = matching.begin(); iter != matching.end(); ++iter)
+    {
+      const Rule &rule = rules[*iter];
+      if (rule.type == RADIUS)
+	{
+	  const G4ThreeVector &pos = step->GetPostStepPoint()->GetPosition();
+	  if ((rule.rmax > 0 && pos.perp() > rule.rmax * cm) ||
+	      (rule.zmax > 0 && fabs(pos.z()) > rule.zmax * cm))
+	    {
+	      kill(track, *iter);
+	      return !dry_run;
+	    }
+	}
+      else if ((rule.pdg == 0 || rule.pdg == pdg) && (rule.emin < 0 || ekin < rule.emin))
+	{
+	  kill(track, *iter);
+	  return !dry_run;
+	}
+    }
+  return false;
+}
+
+void
+PHG4TrackKillPolicy::PreUserTrackingAction(const G4Track *track)
+{
+  if (!dry_run)
+    {
+      return;
+    }
+  map<int, int>::const_iterator iter = doomed.find(track->GetParentID());
+  if (iter != doomed.end())
+    {
+      doomed[track->GetTrackID()] = iter->second;
+    }
+  return;
+}
+
+void
+PHG4TrackKillPolicy::Print() const
+{
+  cout << "PHG4TrackKillPolicy" << (dry_run ? " (dry run)" : "") << ":" << endl;
+  for (vector<Rule>::const_iterator iter = rules.begin(); iter != rules.end(); ++iter)
+    {
+      if (iter->type == RADIUS)
+	{
+	  cout << "kill all particles beyond r = " << iter->rmax << " cm, |z| = " << iter->zmax << " cm" << endl;
+	  continue;
+	}
+      cout << (iter->region ? "region " : "volume ") << iter->selector << (iter->region ? ": " : "*: ");
+      cout << "kill " << (iter->pdg ? "pdg " : "all particles");
+      if (iter->pdg)
+	{
+	  cout << iter->pdg;
+	}
+      if (iter->emin >= 0)
+	{
+	  cout << " below " << iter->emin << " GeV";
+	}
+      cout << endl;
+    }
+  for (vector<pair<string, double> >::const_iterator iter = production_cuts.begin(); iter != production_cuts.end(); ++iter)
+    {
+      cout << "volume " << iter->first << "*: production cut " << iter->second << " cm" << endl;
+    }
+  return;
+}
+
+void
+PHG4TrackKillPolicy::PrintStatistics() const
+{
+  cout << "PHG4TrackKillPolicy statistics" << (dry_run ? " (dry run, nothing killed)" : "") << ":" << endl;
+  for (unsigned int i = 0; i < rules.size(); i++)
+    {
+      const Rule &rule = rules[i];
+      cout << "rule " << i << " (" << ((rule.type == RADIUS) ? "radius" : rule.selector) << "): "
+	   << rule.ntracks << " tracks " << (dry_run ? "to kill" : "killed")
+	   << " with " << rule.ekin << " GeV";
+      if (dry_run)
+	{
+	  cout << ", " << rule.nsteps << " steps saved (including secondaries)";
+	}
+      cout << endl;
+    }
+  return;
+}
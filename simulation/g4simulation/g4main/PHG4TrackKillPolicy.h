@@ -0,0 +1,104 @@
+#ifndef __PHG4TRACKKILLPOLICY_H__
+#define __PHG4TRACKKILLPOLICY_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+class G4Step;
+class G4Track;
+class G4VPhysicalVolume;
+
+//! kills tracks which cannot contribute to any hit we use
+/*!
+  The rules select volumes by the beginning of the physical volume name
+  (the subsystems prefix their volumes with their name) or by G4Region:
+  - KillBelow(volume, emin, pdg): tracks with pdg (0: all particles) and a
+    kinetic energy below emin (GeV) are killed in these volumes
+    (KillNeutronsBelow() is the pdg 2112 shortcut, emin < 0 kills all)
+  - SetKillRadius(r, z): everything beyond radius r or |z| > z (cm) is killed
+  - SetProductionCut(volume, cut): production cut (range, cm) for the
+    logical volumes of these volumes, applied as G4Region by PHG4Reco
+  The rules are looked up once per physical volume and checked in
+  PHG4PhenixSteppingAction after the detectors processed the step.
+  With SetDryRun() nothing is killed, instead the steps of tracks which
+  would have been killed (and their secondaries) are counted for each
+  rule, so the saved CPU can be judged before using a rule.
+  Set with PHG4Reco::SetTrackKillPolicy(), single threaded only.
+*/
+class PHG4TrackKillPolicy
+{
+ public:
+
+  PHG4TrackKillPolicy();
+  virtual ~PHG4TrackKillPolicy() {}
+
+  //! kill tracks with pdg code pdg (0: all) below emin (GeV kinetic, < 0: all energies) in volumes whose name starts with volume
+  void KillBelow(const std::string &volume, const double emin, const int pdg = 0);
+
+  //! same for the volumes in the G4Region region
+  void KillBelowInRegion(const std::string &region, const double emin, const int pdg = 0);
+
+  void KillNeutronsBelow(const std::string &volume, const double emin) {KillBelow(volume, emin, 2112);}
+
+  //! kill all particles beyond this radius or |z| (cm), 0 disables
+  void SetKillRadius(const double r, const double z = 0);
+
+  //! production cut (cm) in the volumes whose name starts with volume
+  void SetProductionCut(const std::string &volume, const double cut);
+
+  //! count the steps the rules would save instead of killing
+  void SetDryRun(const bool b = true) {dry_run = b;}
+
+  //! create the G4Regions for the production cuts, after the geometry is constructed
+  void ApplyProductionCuts();
+
+  //! checks the rules after the step, returns true if the track was killed
+  bool Apply(const G4Step *step);
+
+  //! dry run: forget the tracks of the previous event
+  void BeginOfEvent() {doomed.clear();}
+
+  //! dry run: the secondaries of tracks which would have been killed are counted as well
+  void PreUserTrackingAction(const G4Track *track);
+
+  void Print() const;
+  void PrintStatistics() const;
+
+ protected:
+
+  enum RuleType {ENERGY, RADIUS};
+
+  struct Rule
+  {
+    RuleType type;
+    std::string selector;
+    bool region;
+    int pdg;
+    double emin;
+    double rmax;
+    double zmax;
+    // statistics
+    unsigned long ntracks;
+    double ekin;
+    unsigned long nsteps;
+  };
+
+  //! rules which apply in this volume
+  const std::vector<int> &volume_rules(G4VPhysicalVolume *volume);
+  void kill(G4Track *track, const int rule);
+
+  std::vector<Rule> rules;
+  std::vector<std::pair<std::string, double> > production_cuts;
+  bool dry_run;
+
+  typedef std::map<const G4VPhysicalVolume *, std::vector<int> > VolumeRuleMap;
+  VolumeRuleMap volume_rule_map;
+  const G4VPhysicalVolume *last_volume;
+  const std::vector<int> *last_rules;
+
+  //! dry run: track id -> rule which would have killed it
+  std::map<int, int> doomed;
+};
+
+#endif
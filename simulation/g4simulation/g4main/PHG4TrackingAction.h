@@ -23,6 +23,10 @@ public:
 
   virtual int ResetEvent(PHCompositeNode *) {return 0;}
 
+  //! multi threaded running: called at the end of every G4Event on the worker
+  //! thread (serialized), move the thread local output to the node tree
+  virtual void FlushWorkerOutput() {return;}
+
 };
 
 
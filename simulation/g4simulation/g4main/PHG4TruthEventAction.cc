@@ -5,8 +5,15 @@
 
 #include "PHG4VtxPoint.h"
 #include "PHG4TruthInfoContainer.h"
+#include "PHG4TruthPruningPolicy.h"
+#include "PHG4Hit.h"
+#include "PHG4HitContainer.h"
+#include "PHG4CellAccumulator.h"
 
 #include <phool/getClass.h>
+#include <phool/PHDataNode.h>
+#include <phool/PHNodeIterator.h>
+#include <phool/PHNodeOperation.h>
 
 #include <Geant4/G4Event.hh>
 #include <Geant4/G4TrajectoryContainer.hh>
@@ -17,13 +24,47 @@
 #include <Geant4/globals.hh>
 
 
+#include <boost/foreach.hpp>
+
 #include <map>
 
 using namespace std;
 
+// collects the hit containers and direct cell accumulators on the node tree
+class PHG4HitContainerCollector : public PHNodeOperation
+{
+ public:
+  vector<PHG4HitContainer *> containers;
+  vector<PHG4CellAccumulator *> accumulators;
+
+ protected:
+  void perform(PHNode *node)
+  {
+    if (node->getType() == "PHDataNode")
+      {
+	if (PHDataNode<PHG4CellAccumulator> *accnode = dynamic_cast<PHDataNode<PHG4CellAccumulator> *>(node))
+	  {
+	    accumulators.push_back(accnode->getData());
+	  }
+	return;
+      }
+    if (node->getType() != "PHIODataNode" || node->getObjectType() != "PHObject")
+      {
+	return;
+      }
+    PHObject *obj = ((PHDataNode<PHObject> *) node)->getData();
+    if (PHG4HitContainer *hits = dynamic_cast<PHG4HitContainer *>(obj))
+      {
+	containers.push_back(hits);
+      }
+  }
+};
+
 //___________________________________________________
 PHG4TruthEventAction::PHG4TruthEventAction( void ):
   truthInfoList_( 0 ),
+  topNode_( NULL ),
+  pruningPolicy_( NULL ),
   trackidoffset(0),
   parimarytrackidoffset(0),
   vertexid_(0)
@@ -44,6 +85,24 @@ void PHG4TruthEventAction::EndOfEventAction(const G4Event* evt)
       std::cout << "PHG4TruthEventAction::EndOfEventAction - unable to find G4TruthInfo node" << std::endl;
       return;
     }
+  if (pruningPolicy_)
+    {
+      if (pruningPolicy_->KeepOnlyPrimariesAndEntering())
+	{
+	  collapse_not_entering();
+	}
+      if (!collapsed_.empty())
+	{
+	  // the stored ancestors of collapsed tracks with hits are saved instead
+	  set<G4int> survivors;
+	  for (set<G4int>::const_iterator iter = writeList_.begin(); iter != writeList_.end(); ++iter)
+	    {
+	      survivors.insert(GetSurvivor(*iter));
+	    }
+	  writeList_.swap(survivors);
+	  repoint_hits();
+	}
+    }
   set<G4int> savelist;
   set<int> savevtxlist;
   set<G4int>::const_iterator write_iter;
@@ -194,6 +253,12 @@ void PHG4TruthEventAction::EndOfEventAction(const G4Event* evt)
 
   // loop over all input particles and fish out the ones which have the embed flag set
   // and store their geant track ids in truthinfo container
+  // in multi threaded running this is called once for all G4Events without
+  // a G4Event, the embedded ids are then recorded by the tracking action
+  if (!evt)
+    {
+      return;
+    }
   G4PrimaryVertex *pvtx = evt->GetPrimaryVertex();
   while (pvtx)
   {
@@ -218,6 +283,93 @@ void PHG4TruthEventAction::EndOfEventAction(const G4Event* evt)
   return;
 }
 
+//___________________________________________________
+int PHG4TruthEventAction::GetSurvivor(int trackid) const
+{
+  // the ancestor can have been collapsed itself at the end of the event
+  map<int, int>::const_iterator iter = collapsed_.find(trackid);
+  while (iter != collapsed_.end())
+    {
+      trackid = iter->second;
+      iter = collapsed_.find(trackid);
+    }
+  return trackid;
+}
+
+//___________________________________________________
+void PHG4TruthEventAction::MergeWorker(const PHG4TruthEventAction &worker)
+{
+  writeList_.insert(worker.writeList_.begin(), worker.writeList_.end());
+  collapsed_.insert(worker.collapsed_.begin(), worker.collapsed_.end());
+  entering_.insert(worker.entering_.begin(), worker.entering_.end());
+}
+
+//___________________________________________________
+void PHG4TruthEventAction::collapse_not_entering()
+{
+  // parents have smaller track ids than their children, they are handled first
+  PHG4TruthInfoContainer::Range truth_range = truthInfoList_->GetHitRange();
+  PHG4TruthInfoContainer::Iterator truthiter = truth_range.first;
+  while (truthiter != truth_range.second)
+    {
+      PHG4Particle *particle = truthiter->second;
+      int parentid = particle->get_parent_id();
+      // primaries and particles of an embedded event are kept
+      if (parentid == 0 || truthiter->first <= trackidoffset)
+	{
+	  ++truthiter;
+	  continue;
+	}
+      int survivor = GetSurvivor(parentid);
+      if (entering_.find(truthiter->first) == entering_.end())
+	{
+	  CollapseTrack(truthiter->first, survivor);
+	  truthInfoList_->delete_hit(truthiter++);
+	}
+      else
+	{
+	  particle->set_parent_id(survivor);
+	  ++truthiter;
+	}
+    }
+  return;
+}
+
+//___________________________________________________
+void PHG4TruthEventAction::repoint_hits()
+{
+  if (!topNode_)
+    {
+      return;
+    }
+  PHG4HitContainerCollector collector;
+  PHNodeIterator iter(topNode_);
+  iter.forEach(collector);
+  BOOST_FOREACH(PHG4HitContainer *hits, collector.containers)
+    {
+      PHG4HitContainer::ConstRange hit_range = hits->getHits();
+      for (PHG4HitContainer::ConstIterator hiter = hit_range.first; hiter != hit_range.second; ++hiter)
+	{
+	  int survivor = GetSurvivor(hiter->second->get_trkid());
+	  hiter->second->set_trkid(survivor);
+	}
+    }
+  if (!collector.accumulators.empty())
+    {
+      // the direct cells keep their energy per G4 track id instead of hits
+      map<int, int> survivors;
+      for (map<int, int>::const_iterator iter = collapsed_.begin(); iter != collapsed_.end(); ++iter)
+	{
+	  survivors[iter->first] = GetSurvivor(iter->first);
+	}
+      BOOST_FOREACH(PHG4CellAccumulator *cells, collector.accumulators)
+	{
+	  cells->RemapTracks(survivors);
+	}
+    }
+  return;
+}
+
 //___________________________________________________
 void PHG4TruthEventAction::AddTrackidToWritelist( const G4int trackid)
 {
@@ -235,6 +387,8 @@ void PHG4TruthEventAction::SetInterfacePointers( PHCompositeNode* topNode )
     {
       std::cout << "PHG4TruthEventAction::SetInterfacePointers - unable to find G4TruthInfo" << std::endl;
     }
+  // the hit nodes are searched at the end of the event (they might not exist yet)
+  topNode_ = topNode;
 
 }
 
@@ -253,5 +407,7 @@ PHG4TruthEventAction::ResetEvent(PHCompositeNode *)
 {
   writeList_.clear();
   vertexIdMap_.clear();
+  collapsed_.clear();
+  entering_.clear();
   return 0;
 }
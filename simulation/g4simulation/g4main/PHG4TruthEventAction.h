@@ -10,9 +10,11 @@
 
 #include <boost/bimap.hpp>
 
+#include <map>
 #include <set>
 
 class PHG4TruthInfoContainer;
+class PHG4TruthPruningPolicy;
 
 class PHG4TruthEventAction: public PHG4EventAction
 {
@@ -44,8 +46,30 @@ public:
 
 
   bimap_type::iterator AddVertex(G4ThreeVector& v);
-  
+
+  //! prune the truth with this policy (not owned)
+  void SetPruningPolicy(PHG4TruthPruningPolicy *policy) {pruningPolicy_ = policy;}
+  PHG4TruthPruningPolicy *GetPruningPolicy() const {return pruningPolicy_;}
+
+  //! trackid is not stored, its hits go to the stored ancestor ancestorid
+  void CollapseTrack(const int trackid, const int ancestorid) {collapsed_[trackid] = ancestorid;}
+
+  //! trackid entered a collapse volume (kept by KeepOnlyPrimariesAndEntering)
+  void AddEnteringTrack(const int trackid) {entering_.insert(trackid);}
+
+  //! closest stored ancestor of a collapsed track, trackid if it was not collapsed
+  int GetSurvivor(int trackid) const;
+
+  //! take over the track lists of the event action of a G4 worker thread
+  void MergeWorker(const PHG4TruthEventAction &worker);
+
  private:
+
+  //! collapse the secondaries which did not enter a collapse volume
+  void collapse_not_entering();
+
+  //! assign the hits and direct cell deposits of collapsed tracks to their stored ancestor
+  void repoint_hits();
   
   
   //! set of track ids to be written out
@@ -55,6 +79,13 @@ public:
   //! pointer to truth information container
   PHG4TruthInfoContainer* truthInfoList_;
 
+  PHCompositeNode *topNode_;
+
+  PHG4TruthPruningPolicy *pruningPolicy_;
+  //! collapsed track id -> stored ancestor (at the time of collapsing)
+  std::map<int, int> collapsed_;
+  std::set<int> entering_;
+
   int trackidoffset;
   int parimarytrackidoffset;
   
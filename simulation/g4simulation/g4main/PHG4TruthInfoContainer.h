@@ -75,6 +75,7 @@ class PHG4TruthInfoContainer: public PHObject
   const Map& GetMap() const { return hitmap; }
   const Map& GetPrimaryMap() const { return primary_particle_map; }
   const VtxMap& GetVtxMap() const { return vtxmap; }
+  const VtxMap& GetPrimaryVtxMap() const { return primary_vtxmap; }
 
   int maxtrkindex() const;
   int mintrkindex() const;
@@ -0,0 +1,384 @@
+#include "PHG4TruthInfoContainerFlat.h"
+#include "PHG4TruthInfoContainer.h"
+#include "PHG4Particlev2.h"
+#include "PHG4VtxPointv1.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// sort criteria for the id arrays, only the id matters
+template <class T>
+static bool
+entry_id_less(const pair<int, T *> &lhs, const int id)
+{
+  return lhs.first < id;
+}
+
+// index of id in the sorted array entries by binary search, -1 if not found
+template <class T>
+static int
+search_index(const vector<pair<int, T *> > &entries, const int id)
+{
+  typename vector<pair<int, T *> >::const_iterator iter = lower_bound(entries.begin(), entries.end(), id, entry_id_less<T>);
+  if (iter != entries.end() && iter->first == id)
+    {
+      return iter - entries.begin();
+    }
+  return -1;
+}
+
+// dense id -> index table, left empty if the ids are too sparse
+template <class T>
+static void
+fill_lookup(const vector<pair<int, T *> > &entries, vector<int> &lookup, int &offset)
+{
+  lookup.clear();
+  offset = 0;
+  if (entries.empty())
+    {
+      return;
+    }
+  long minid = entries.front().first;
+  long maxid = entries.back().first;
+  unsigned long span = maxid - minid + 1;
+  if (span > 8 * entries.size() + 1024)
+    {
+      return;
+    }
+  lookup.assign(span, -1);
+  for (unsigned int i = 0; i < entries.size(); i++)
+    {
+      lookup[entries[i].first - minid] = i;
+    }
+  offset = minid;
+  return;
+}
+
+template <class T>
+static int
+find_index(const vector<pair<int, T *> > &entries, const vector<int> &lookup, const int offset, const int id)
+{
+  if (!lookup.empty())
+    {
+      if (id < offset || id - offset >= (int) lookup.size())
+	{
+	  return -1;
+	}
+      int index = lookup[id - offset];
+      if (index < 0)
+	{
+	  return -1;
+	}
+      if (index < (int) entries.size() && entries[index].first == id)
+	{
+	  return index;
+	}
+    }
+  // no table (sparse ids) or a table which does not belong to this array
+  return search_index(entries, id);
+}
+
+// the PHG4Particlev2 constructor only copies the PHG4Particlev1 part
+static PHG4Particle *
+copy_particle(const PHG4Particle *in)
+{
+  PHG4Particle *particle = new PHG4Particlev2(in);
+  particle->set_track_id(in->get_track_id());
+  particle->set_vtx_id(in->get_vtx_id());
+  particle->set_parent_id(in->get_parent_id());
+  particle->set_primary_id(in->get_primary_id());
+  particle->set_e(in->get_e());
+  return particle;
+}
+
+PHG4TruthInfoContainerFlat::PHG4TruthInfoContainerFlat():
+  trk_lookup_offset(0),
+  vtx_lookup_offset(0),
+  lookup_nparticles(0),
+  lookup_nvertices(0)
+{}
+
+PHG4TruthInfoContainerFlat::~PHG4TruthInfoContainerFlat()
+{
+  Reset();
+}
+
+void
+PHG4TruthInfoContainerFlat::Reset()
+{
+  for (ConstIterator iter = particles.begin(); iter != particles.end(); ++iter)
+    {
+      delete iter->second;
+    }
+  particles.clear();
+  for (ConstIterator iter = primary_particles.begin(); iter != primary_particles.end(); ++iter)
+    {
+      delete iter->second;
+    }
+  primary_particles.clear();
+  for (ConstVtxIterator iter = vertices.begin(); iter != vertices.end(); ++iter)
+    {
+      delete iter->second;
+    }
+  vertices.clear();
+  for (ConstVtxIterator iter = primary_vertices.begin(); iter != primary_vertices.end(); ++iter)
+    {
+      delete iter->second;
+    }
+  primary_vertices.clear();
+  embedded_trkid.clear();
+  parent_index.clear();
+  vtx_index.clear();
+  primary_index.clear();
+  trk_lookup.clear();
+  trk_lookup_offset = 0;
+  vtx_lookup.clear();
+  vtx_lookup_offset = 0;
+  lookup_nparticles = 0;
+  lookup_nvertices = 0;
+  return;
+}
+
+void
+PHG4TruthInfoContainerFlat::identify(ostream& os) const
+{
+  os << "---particles----------------------------" << endl;
+  for (unsigned int i = 0; i < particles.size(); i++)
+    {
+      os << "particle id " << particles[i].first
+	 << ", parent index " << parent_index[i]
+	 << ", vtx index " << vtx_index[i]
+	 << ", primary index " << primary_index[i] << endl;
+      (particles[i].second)->identify();
+    }
+  os << "---vertices-----------------------------" << endl;
+  for (ConstVtxIterator iter = vertices.begin(); iter != vertices.end(); ++iter)
+    {
+      os << "vtx id: " << iter->first << endl;
+      (iter->second)->identify();
+    }
+  os << "---primary particles--------------------" << endl;
+  for (ConstIterator iter = primary_particles.begin(); iter != primary_particles.end(); ++iter)
+    {
+      os << "primary particle id " << iter->first << endl;
+      (iter->second)->identify();
+    }
+  os << "---primary vertices---------------------" << endl;
+  for (ConstVtxIterator iter = primary_vertices.begin(); iter != primary_vertices.end(); ++iter)
+    {
+      os << "vtx id: " << iter->first << endl;
+      (iter->second)->identify();
+    }
+  os << "---list of embeded tracks---------------" << endl;
+  for (set<int>::const_iterator iter = embedded_trkid.begin(); iter != embedded_trkid.end(); ++iter)
+    {
+      os << "embeded track ID " << *iter << endl;
+    }
+  return;
+}
+
+void
+PHG4TruthInfoContainerFlat::CopyFrom(const PHG4TruthInfoContainer &truth)
+{
+  Reset();
+  // the maps are sorted by id, so are the arrays
+  const PHG4TruthInfoContainer::Map &hitmap = truth.GetMap();
+  particles.reserve(hitmap.size());
+  for (PHG4TruthInfoContainer::ConstIterator iter = hitmap.begin(); iter != hitmap.end(); ++iter)
+    {
+      particles.push_back(make_pair(iter->first, copy_particle(iter->second)));
+    }
+  const PHG4TruthInfoContainer::Map &primarymap = truth.GetPrimaryMap();
+  primary_particles.reserve(primarymap.size());
+  for (PHG4TruthInfoContainer::ConstIterator iter = primarymap.begin(); iter != primarymap.end(); ++iter)
+    {
+      primary_particles.push_back(make_pair(iter->first, copy_particle(iter->second)));
+    }
+  const PHG4TruthInfoContainer::VtxMap &vtxmap = truth.GetVtxMap();
+  vertices.reserve(vtxmap.size());
+  for (PHG4TruthInfoContainer::ConstVtxIterator iter = vtxmap.begin(); iter != vtxmap.end(); ++iter)
+    {
+      vertices.push_back(make_pair(iter->first, new PHG4VtxPointv1(iter->second)));
+    }
+  const PHG4TruthInfoContainer::VtxMap &primaryvtxmap = truth.GetPrimaryVtxMap();
+  primary_vertices.reserve(primaryvtxmap.size());
+  for (PHG4TruthInfoContainer::ConstVtxIterator iter = primaryvtxmap.begin(); iter != primaryvtxmap.end(); ++iter)
+    {
+      primary_vertices.push_back(make_pair(iter->first, new PHG4VtxPointv1(iter->second)));
+    }
+  pair<set<int>::const_iterator, set<int>::const_iterator> embedded = truth.GetEmbeddedTrkIds();
+  embedded_trkid.insert(embedded.first, embedded.second);
+
+  // resolve the ids of parent, vertex and primary into array indices
+  parent_index.resize(particles.size());
+  vtx_index.resize(particles.size());
+  primary_index.resize(particles.size());
+  for (unsigned int i = 0; i < particles.size(); i++)
+    {
+      const PHG4Particle *particle = particles[i].second;
+      int parentid = particle->get_parent_id();
+      parent_index[i] = (parentid == 0) ? -1 : GetIndex(parentid);
+      vtx_index[i] = GetVtxIndex(particle->get_vtx_id());
+      primary_index[i] = search_index(primary_particles, particle->get_primary_id());
+    }
+  return;
+}
+
+void
+PHG4TruthInfoContainerFlat::build_lookup() const
+{
+  if (lookup_nparticles != particles.size())
+    {
+      fill_lookup(particles, trk_lookup, trk_lookup_offset);
+      lookup_nparticles = particles.size();
+    }
+  if (lookup_nvertices != vertices.size())
+    {
+      fill_lookup(vertices, vtx_lookup, vtx_lookup_offset);
+      lookup_nvertices = vertices.size();
+    }
+  return;
+}
+
+int
+PHG4TruthInfoContainerFlat::GetIndex(const int trackid) const
+{
+  build_lookup();
+  return find_index(particles, trk_lookup, trk_lookup_offset, trackid);
+}
+
+int
+PHG4TruthInfoContainerFlat::GetVtxIndex(const int vtxid) const
+{
+  build_lookup();
+  return find_index(vertices, vtx_lookup, vtx_lookup_offset, vtxid);
+}
+
+PHG4Particle*
+PHG4TruthInfoContainerFlat::GetHit(const int trackid) const
+{
+  int index = GetIndex(trackid);
+  if (index < 0)
+    {
+      return NULL;
+    }
+  return particles[index].second;
+}
+
+PHG4Particle*
+PHG4TruthInfoContainerFlat::GetPrimaryHit(const int trackid) const
+{
+  int index = search_index(primary_particles, trackid);
+  if (index < 0)
+    {
+      return NULL;
+    }
+  return primary_particles[index].second;
+}
+
+PHG4VtxPoint*
+PHG4TruthInfoContainerFlat::GetVtx(const int vtxid) const
+{
+  int index = GetVtxIndex(vtxid);
+  if (index < 0)
+    {
+      return NULL;
+    }
+  return vertices[index].second;
+}
+
+PHG4VtxPoint*
+PHG4TruthInfoContainerFlat::GetPrimaryVtx(const int vtxid) const
+{
+  int index = search_index(primary_vertices, vtxid);
+  if (index < 0)
+    {
+      return NULL;
+    }
+  return primary_vertices[index].second;
+}
+
+PHG4Particle*
+PHG4TruthInfoContainerFlat::GetPrimaryParticle(const int trackid) const
+{
+  int index = GetIndex(trackid);
+  if (index < 0 || primary_index[index] < 0)
+    {
+      return NULL;
+    }
+  return primary_particles[primary_index[index]].second;
+}
+
+bool
+PHG4TruthInfoContainerFlat::IsAncestor(const int ancestorid, const int trackid) const
+{
+  int index = GetIndex(trackid);
+  while (index >= 0)
+    {
+      if (particles[index].first == ancestorid)
+	{
+	  return true;
+	}
+      index = parent_index[index];
+    }
+  return false;
+}
+
+void
+PHG4TruthInfoContainerFlat::GetAncestors(const int trackid, vector<int> &ancestors) const
+{
+  ancestors.clear();
+  int index = GetIndex(trackid);
+  if (index < 0)
+    {
+      return;
+    }
+  index = parent_index[index];
+  while (index >= 0)
+    {
+      ancestors.push_back(particles[index].first);
+      index = parent_index[index];
+    }
+  return;
+}
+
+int
+PHG4TruthInfoContainerFlat::maxtrkindex() const
+{
+  int key = 0;
+  if (!particles.empty())
+    {
+      key = particles.back().first;
+    }
+  if (key < 0)
+    {
+      key = 0;
+    }
+  return key;
+}
+
+int
+PHG4TruthInfoContainerFlat::mintrkindex() const
+{
+  int key = 0;
+  if (!particles.empty())
+    {
+      key = particles.front().first;
+    }
+  if (key > 0)
+    {
+      key = 0;
+    }
+  return key;
+}
+
+int
+PHG4TruthInfoContainerFlat::isEmbeded(const int trackid) const
+{
+  if (embedded_trkid.find(trackid) != embedded_trkid.end())
+    {
+      return true;
+    }
+  return false;
+}
@@ -0,0 +1,128 @@
+#ifndef __PHG4TRUTHINFOCONTAINERFLAT_H__
+#define __PHG4TRUTHINFOCONTAINERFLAT_H__
+
+#include <phool/PHObject.h>
+
+#include <set>
+#include <utility>
+#include <vector>
+
+class PHG4Particle;
+class PHG4TruthInfoContainer;
+class PHG4VtxPoint;
+
+//! truth record in arrays with precomputed ancestry
+/*!
+  Copy of the PHG4TruthInfoContainer content made at the end of the event
+  (PHG4TruthSubsystem::SetFlatTruth()), it is then the only truth record
+  written to the DST. Particles and vertices are kept in
+  vectors of (id, object) pairs sorted by id, for every particle the array
+  index of its parent, of its vertex and of its primary particle is
+  computed once when the record is filled. Walking up the ancestry
+  (IsAncestor(), GetAncestors(), GetPrimaryParticle()) then only follows
+  array indices instead of looking up every parent id in a map.
+  id -> index lookups use a dense table indexed by id - min id which is
+  built on first use (not written out, rebuilt after reading a DST).
+  GetHitRange() and GetVtxRange() return const iterators with the same
+  ->first (id) and ->second (object) access as the map based container,
+  lookups by id go through GetHit() and GetVtx() (map find() does not
+  exist here). PHG4DSTReader reads this record when the DST has no
+  G4TruthInfo node.
+*/
+class PHG4TruthInfoContainerFlat: public PHObject
+{
+  public:
+  typedef std::pair<int, PHG4Particle *> Entry;
+  typedef std::vector<Entry> Vector;
+  typedef Vector::const_iterator ConstIterator;
+  typedef std::pair<ConstIterator, ConstIterator> ConstRange;
+
+  typedef std::pair<int, PHG4VtxPoint *> VtxEntry;
+  typedef std::vector<VtxEntry> VtxVector;
+  typedef VtxVector::const_iterator ConstVtxIterator;
+  typedef std::pair<ConstVtxIterator, ConstVtxIterator> ConstVtxRange;
+
+  PHG4TruthInfoContainerFlat();
+
+  virtual ~PHG4TruthInfoContainerFlat();
+
+  void Reset();
+
+  void identify(std::ostream& os = std::cout) const;
+
+  //! replace the content by a copy of truth and compute the indices
+  void CopyFrom(const PHG4TruthInfoContainer &truth);
+
+  //! particle/vertex by id, NULL if not stored
+  PHG4Particle* GetHit(const int trackid) const;
+  PHG4Particle* GetPrimaryHit(const int trackid) const;
+  PHG4VtxPoint* GetVtx(const int vtxid) const;
+  PHG4VtxPoint* GetPrimaryVtx(const int vtxid) const;
+
+  //! array index of a particle (-1 if not stored)
+  int GetIndex(const int trackid) const;
+  //! array index of a vertex (-1 if not stored)
+  int GetVtxIndex(const int vtxid) const;
+
+  //! particle at array index
+  PHG4Particle* GetParticle(const unsigned int index) const {return particles[index].second;}
+  //! array index of the parent (-1 for primaries and removed parents)
+  int GetParentIndex(const unsigned int index) const {return parent_index[index];}
+  //! array index of the production vertex (-1 if not stored)
+  int GetParticleVtxIndex(const unsigned int index) const {return vtx_index[index];}
+  //! index in the primary particle array (-1 if not stored)
+  int GetPrimaryIndex(const unsigned int index) const {return primary_index[index];}
+
+  //! primary particle a particle descends from (NULL if not stored)
+  PHG4Particle* GetPrimaryParticle(const int trackid) const;
+
+  //! true if ancestorid is the track id of the particle trackid or one of its (stored) ancestors
+  bool IsAncestor(const int ancestorid, const int trackid) const;
+
+  //! fills the track ids of the stored ancestors of trackid, parent first
+  void GetAncestors(const int trackid, std::vector<int> &ancestors) const;
+
+  ConstRange GetHitRange() const {return std::make_pair(particles.begin(), particles.end());}
+  ConstRange GetPrimaryHitRange() const {return std::make_pair(primary_particles.begin(), primary_particles.end());}
+  ConstVtxRange GetVtxRange() const {return std::make_pair(vertices.begin(), vertices.end());}
+  ConstVtxRange GetPrimaryVtxRange() const {return std::make_pair(primary_vertices.begin(), primary_vertices.end());}
+
+  unsigned int size( void ) const
+  { return particles.size(); }
+  unsigned int GetNumVertices() const { return vertices.size(); }
+
+  int maxtrkindex() const;
+  int mintrkindex() const;
+
+  int isEmbeded(const int trackid) const;
+
+ protected:
+
+  //! fill the id -> index table of particles/vertices if it is out of date
+  void build_lookup() const;
+
+  Vector particles;
+  VtxVector vertices;
+  Vector primary_particles;
+  VtxVector primary_vertices;
+  // track ids of embedded particles
+  std::set<int> embedded_trkid;
+
+  // parallel to particles
+  std::vector<int> parent_index;
+  std::vector<int> vtx_index;
+  std::vector<int> primary_index;
+
+  //! particle array index for trackid - trk_lookup_offset, -1 for gaps
+  mutable std::vector<int> trk_lookup; //!
+  mutable int trk_lookup_offset; //!
+  mutable std::vector<int> vtx_lookup; //!
+  mutable int vtx_lookup_offset; //!
+  //! number of particles/vertices the tables were made for
+  mutable unsigned int lookup_nparticles; //!
+  mutable unsigned int lookup_nvertices; //!
+
+  ClassDef(PHG4TruthInfoContainerFlat,1)
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "PHG4TruthPruningPolicy.h"
+
+#include <iostream>
+
+using namespace std;
+
+PHG4TruthPruningPolicy::PHG4TruthPruningPolicy():
+  keep_only_entering(false)
+{}
+
+PHG4TruthPruningPolicy::Rule &
+PHG4TruthPruningPolicy::get_rule(const string &volume)
+{
+  for (vector<Rule>::iterator iter = rules.begin(); iter != rules.end(); ++iter)
+    {
+      if (iter->volume == volume)
+	{
+	  return *iter;
+	}
+    }
+  Rule newrule;
+  newrule.volume = volume;
+  newrule.emin = 0;
+  newrule.collapse = false;
+  rules.push_back(newrule);
+  return rules.back();
+}
+
+void
+PHG4TruthPruningPolicy::SetEnergyThreshold(const string &volume, const double emin)
+{
+  get_rule(volume).emin = emin;
+}
+
+void
+PHG4TruthPruningPolicy::AddCollapseVolume(const string &volume)
+{
+  get_rule(volume).collapse = true;
+}
+
+int
+PHG4TruthPruningPolicy::GetVolumeRule(const string &volname) const
+{
+  for (unsigned int i = 0; i < rules.size(); i++)
+    {
+      if (volname.compare(0, rules[i].volume.size(), rules[i].volume) == 0)
+	{
+	  return i;
+	}
+    }
+  return -1;
+}
+
+bool
+PHG4TruthPruningPolicy::Collapse(const int rule, const double ekin) const
+{
+  if (rule < 0)
+    {
+      return false;
+    }
+  return (rules[rule].collapse || ekin < rules[rule].emin);
+}
+
+bool
+PHG4TruthPruningPolicy::IsCollapseVolume(const int rule) const
+{
+  if (rule < 0)
+    {
+      return false;
+    }
+  return rules[rule].collapse;
+}
+
+void
+PHG4TruthPruningPolicy::Print() const
+{
+  cout << "PHG4TruthPruningPolicy:" << endl;
+  for (vector<Rule>::const_iterator iter = rules.begin(); iter != rules.end(); ++iter)
+    {
+      cout << "volume " << iter->volume << "*: ";
+      if (iter->collapse)
+	{
+	  cout << "collapse all secondaries" << endl;
+	}
+      else
+	{
+	  cout << "collapse secondaries below " << iter->emin << " GeV" << endl;
+	}
+    }
+  if (keep_only_entering)
+    {
+      cout << "keep only primaries and tracks entering collapse volumes" << endl;
+    }
+  return;
+}
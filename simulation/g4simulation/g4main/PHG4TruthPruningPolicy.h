@@ -0,0 +1,66 @@
+#ifndef __PHG4TRUTHPRUNINGPOLICY_H__
+#define __PHG4TRUTHPRUNINGPOLICY_H__
+
+#include <string>
+#include <vector>
+
+//! decides which secondaries are stored in the truth record
+/*!
+  Secondaries which are not stored are "collapsed" into their closest
+  stored ancestor: their hits are assigned to this ancestor at the end of
+  the event and stored children get it as parent. Primaries are always
+  stored.
+  - SetEnergyThreshold(volume, emin): secondaries produced in volumes whose
+    name starts with volume with less than emin (GeV, kinetic) are collapsed
+  - AddCollapseVolume(volume): all secondaries produced in these volumes
+    (e.g. the calorimeters) are collapsed into the track which entered
+  - SetKeepOnlyPrimariesAndEntering(): at the end of the event also the
+    secondaries produced outside the collapse volumes are collapsed unless
+    they entered a collapse volume (one of their children was produced in
+    a collapse volume)
+  The rule of a volume is looked up once per physical volume, derived
+  policies can override GetVolumeRule() and Collapse().
+*/
+class PHG4TruthPruningPolicy
+{
+ public:
+
+  PHG4TruthPruningPolicy();
+  virtual ~PHG4TruthPruningPolicy() {}
+
+  //! minimum kinetic energy (GeV) of secondaries produced in volumes whose name starts with volume
+  void SetEnergyThreshold(const std::string &volume, const double emin);
+
+  //! secondaries produced in volumes whose name starts with volume are collapsed
+  void AddCollapseVolume(const std::string &volume);
+
+  void SetKeepOnlyPrimariesAndEntering(const bool b = true) {keep_only_entering = b;}
+  bool KeepOnlyPrimariesAndEntering() const {return keep_only_entering;}
+
+  //! index of the first rule matching the volume name, -1 if none matches
+  virtual int GetVolumeRule(const std::string &volname) const;
+
+  //! true if a secondary with kinetic energy ekin (GeV) produced in a volume with this rule is collapsed
+  virtual bool Collapse(const int rule, const double ekin) const;
+
+  //! true if this rule collapses everything produced in its volumes
+  bool IsCollapseVolume(const int rule) const;
+
+  void Print() const;
+
+ protected:
+
+  struct Rule
+  {
+    std::string volume;
+    double emin;
+    bool collapse;
+  };
+
+  Rule &get_rule(const std::string &volume);
+
+  std::vector<Rule> rules;
+  bool keep_only_entering;
+};
+
+#endif
@@ -5,6 +5,8 @@
 
 
 #include "PHG4TruthInfoContainer.h"
+#include "PHG4TruthInfoContainerFlat.h"
+#include "PHG4TruthPruningPolicy.h"
 
 #include "PHG4VtxPointv1.h"
 #include "PHG4Particlev2.h"
@@ -29,9 +31,27 @@ PHG4TruthSubsystem::PHG4TruthSubsystem( const string &name ):
   eventAction_( 0 ),
   steppingAction_( 0 ),
   trackingAction_( 0 ),
-  saveOnlyEmbeded_(false)
+  saveOnlyEmbeded_(false),
+  flatTruth_(false),
+  pruningPolicy_( NULL )
 {}
 
+//_______________________________________________________________________
+PHG4TruthSubsystem::~PHG4TruthSubsystem( void )
+{
+  delete pruningPolicy_;
+}
+
+//_______________________________________________________________________
+void PHG4TruthSubsystem::SetPruningPolicy(PHG4TruthPruningPolicy *policy)
+{
+  if (pruningPolicy_ != policy)
+    {
+      delete pruningPolicy_;
+    }
+  pruningPolicy_ = policy;
+}
+
 //_______________________________________________________________________
 int PHG4TruthSubsystem::InitRun( PHCompositeNode* topNode )
 {
@@ -44,11 +64,37 @@ int PHG4TruthSubsystem::InitRun( PHCompositeNode* topNode )
   if ( !truthInfoList )
     {
       truthInfoList = new PHG4TruthInfoContainer();
-      dstNode->addNode( new PHIODataNode<PHObject>( truthInfoList, "G4TruthInfo", "PHObject" ));
+      if (flatTruth_)
+	{
+	  // working container only, the flat copy is the one written out,
+	  // the PHObject type makes the node reset clear it every event
+	  dstNode->addNode( new PHDataNode<PHG4TruthInfoContainer>( truthInfoList, "G4TruthInfo", "PHObject" ));
+	}
+      else
+	{
+	  dstNode->addNode( new PHIODataNode<PHObject>( truthInfoList, "G4TruthInfo", "PHObject" ));
+	}
+    }
+  if (flatTruth_)
+    {
+      PHG4TruthInfoContainerFlat* flatTruth =  findNode::getClass<PHG4TruthInfoContainerFlat>( topNode , "G4TruthInfoFlat" );
+      if ( !flatTruth )
+	{
+	  flatTruth = new PHG4TruthInfoContainerFlat();
+	  dstNode->addNode( new PHIODataNode<PHObject>( flatTruth, "G4TruthInfoFlat", "PHObject" ));
+	}
     }
 
   // event action
   eventAction_ = new PHG4TruthEventAction();
+  if (pruningPolicy_)
+    {
+      if (Verbosity() > 0)
+	{
+	  pruningPolicy_->Print();
+	}
+      eventAction_->SetPruningPolicy(pruningPolicy_);
+    }
 
   // create stepping action
   //steppingAction_ = new PHG4TruthSteppingAction( eventAction_ );
@@ -102,6 +148,7 @@ PHG4TruthSubsystem::process_event( PHCompositeNode* topNode )
 //     cout << "truthInfoList maxkey: " << truthInfoList->maxindex() << endl;
 //     cout << "truthInfoList minkey: " << truthInfoList->minindex() << endl;
   trackingAction_->TrackIdOffset(truthInfoList->maxtrkindex());
+  trackingAction_->PrimaryTrackIdOffset(truthInfoList->maxprimarytrkindex());
   eventAction_->TrackIdOffset(truthInfoList->maxtrkindex());
   eventAction_->PrimaryTrackIdOffset(truthInfoList->maxprimarytrkindex());
   map<int, PHG4VtxPoint *>::const_iterator vtxiter;
@@ -192,12 +239,26 @@ int PHG4TruthSubsystem::process_after_geant(PHCompositeNode * topNode)
         }
     }
 
+  // copy the final truth record, the ancestry is resolved here once
+  if (flatTruth_)
+    {
+      PHG4TruthInfoContainer* truthInfoList =  findNode::getClass<PHG4TruthInfoContainer>( topNode , "G4TruthInfo" );
+      PHG4TruthInfoContainerFlat* flatTruth =  findNode::getClass<PHG4TruthInfoContainerFlat>( topNode , "G4TruthInfoFlat" );
+      assert(truthInfoList && flatTruth);
+      flatTruth->CopyFrom(*truthInfoList);
+    }
+
   return 0;
 }
 
 int
 PHG4TruthSubsystem::ResetEvent(PHCompositeNode *topNode)
 {
+  PHG4TruthInfoContainer* truthInfoList =  findNode::getClass<PHG4TruthInfoContainer>( topNode , "G4TruthInfo" );
+  if (truthInfoList)
+    {
+      truthInfoList->Reset();
+    }
   trackingAction_->ResetEvent(topNode);
   eventAction_->ResetEvent(topNode);
   return 0;
@@ -217,3 +278,14 @@ PHG4TruthSubsystem::GetTrackingAction( void ) const
 { 
   return trackingAction_; 
 }
+
+//_______________________________________________________________________
+PHG4TrackingAction*
+PHG4TruthSubsystem::CreateWorkerTrackingAction( void ) const
+{
+  if (!trackingAction_)
+    {
+      return NULL;
+    }
+  return new PHG4TruthTrackingAction(trackingAction_);
+}
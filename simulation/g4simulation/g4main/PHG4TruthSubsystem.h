@@ -7,6 +7,7 @@
 class PHG4TruthSteppingAction;
 class PHG4TruthTrackingAction;
 class PHG4TruthEventAction;
+class PHG4TruthPruningPolicy;
 
 class PHG4TruthSubsystem: public PHG4Subsystem
 {
@@ -17,8 +18,7 @@ class PHG4TruthSubsystem: public PHG4Subsystem
   PHG4TruthSubsystem( const std::string &name = "TRUTH" );
 
   //! destructor
-  virtual ~PHG4TruthSubsystem( void )
-  {}
+  virtual ~PHG4TruthSubsystem( void );
 
   //! init
   int InitRun(PHCompositeNode *);
@@ -36,10 +36,19 @@ class PHG4TruthSubsystem: public PHG4Subsystem
   virtual PHG4EventAction* GetEventAction( void ) const;
   virtual PHG4SteppingAction* GetSteppingAction( void ) const;
   virtual PHG4TrackingAction* GetTrackingAction( void ) const;
+  virtual PHG4TrackingAction* CreateWorkerTrackingAction( void ) const;
 
   //! only save the G4 truth information that is associated with the embedded particle
   void SetSaveOnlyEmbeded(bool b = true){saveOnlyEmbeded_ = b;};
 
+  //! write the truth as PHG4TruthInfoContainerFlat (node G4TruthInfoFlat)
+  //! instead of G4TruthInfo, which is then kept in memory only
+  void SetFlatTruth(bool b = true){flatTruth_ = b;}
+
+  //! secondaries rejected by the policy are not stored, their hits are
+  //! assigned to the closest stored ancestor (takes ownership)
+  void SetPruningPolicy(PHG4TruthPruningPolicy *policy);
+
   private:
 
   PHG4TruthEventAction* eventAction_;
@@ -49,6 +58,11 @@ class PHG4TruthSubsystem: public PHG4Subsystem
   //! only save the G4 truth information that is associated with the embedded particle
   bool saveOnlyEmbeded_;
 
+  //! copy the truth into the flat container at the end of the event
+  bool flatTruth_;
+
+  PHG4TruthPruningPolicy *pruningPolicy_;
+
 };
 
 #endif
@@ -1,15 +1,24 @@
 #include "PHG4TruthTrackingAction.h"
 #include "PHG4TruthEventAction.h"
 #include <PHG4TruthInfoContainer.h>
+#include "PHG4TruthPruningPolicy.h"
 #include "PHG4TrackUserInfoV1.h"
 #include "PHG4Particlev2.h"
+#include "PHG4UserPrimaryParticleInformation.h"
 #include "PHG4VtxPointv1.h"
 
 #include <phool/getClass.h>
 
+#include <Geant4/G4DynamicParticle.hh>
+#include <Geant4/G4Event.hh>
+#include <Geant4/G4EventManager.hh>
+#include <Geant4/G4PrimaryParticle.hh>
 #include <Geant4/G4Step.hh>
 #include <Geant4/G4SystemOfUnits.hh>
 #include <Geant4/G4Track.hh>
+#include <Geant4/G4VPhysicalVolume.hh>
+
+#include <set>
 
 using namespace std;
 
@@ -18,17 +27,85 @@ const int VERBOSE = 0;
 //________________________________________________________
 PHG4TruthTrackingAction::PHG4TruthTrackingAction( PHG4TruthEventAction* eventAction ) :
   trackidoffset(0),
+  primarytrackidoffset(0),
   eventAction_( eventAction ), 
-  truthInfoList_( NULL )
+  truthInfoList_( NULL ),
+  master_( NULL )
 {}
 
+//________________________________________________________
+PHG4TruthTrackingAction::PHG4TruthTrackingAction( PHG4TruthTrackingAction* master ) :
+  trackidoffset(0),
+  primarytrackidoffset(0),
+  eventAction_( new PHG4TruthEventAction() ),
+  truthInfoList_( new PHG4TruthInfoContainer() ),
+  master_( master )
+{
+  eventAction_->SetPruningPolicy(master->eventAction_->GetPruningPolicy());
+}
+
+//________________________________________________________
+PHG4TruthTrackingAction::~PHG4TruthTrackingAction()
+{
+  // a worker owns its truth buffer
+  if (master_)
+    {
+      delete eventAction_;
+      delete truthInfoList_;
+    }
+}
+
 void
 PHG4TruthTrackingAction::PreUserTrackingAction( const G4Track* track)
 {
   G4ThreeVector v = track->GetVertexPosition();
   G4ThreeVector pdir = track->GetVertexMomentumDirection();
-  int trackid = track->GetTrackID() + trackidoffset;
-  PHG4TrackUserInfo::SetTrackIdOffset(const_cast<G4Track *> (track), trackidoffset); // adding info to G4Track -> non const
+  int offset = trackidoffset;
+  int primaryoffset = primarytrackidoffset;
+  if (master_)
+    {
+      // G4 restarts the track ids for every G4Event, the G4Events an input
+      // event is split into get their own track id range
+      offset = master_->trackidoffset;
+      primaryoffset = master_->primarytrackidoffset;
+      const G4Event *g4event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+      if (g4event)
+	{
+	  offset += g4event->GetEventID() * subevent_trackid_range;
+	}
+    }
+  int trackid = track->GetTrackID() + offset;
+  PHG4TrackUserInfo::SetTrackIdOffset(const_cast<G4Track *> (track), offset); // adding info to G4Track -> non const
+  // secondaries rejected by the pruning policy are not stored, their
+  // hits and stored children are assigned to the closest stored ancestor
+  int parentid = 0;
+  if (track->GetParentID())
+    {
+      parentid = track->GetParentID() + offset;
+      PHG4TruthPruningPolicy *policy = eventAction_->GetPruningPolicy();
+      if (policy)
+	{
+	  int survivor = eventAction_->GetSurvivor(parentid);
+	  const G4VPhysicalVolume *volume = track->GetVolume();
+	  map<const G4VPhysicalVolume *, int>::const_iterator ruleiter = volumeRule_.find(volume);
+	  if (ruleiter == volumeRule_.end())
+	    {
+	      int rule = volume ? policy->GetVolumeRule(volume->GetName()) : -1;
+	      ruleiter = volumeRule_.insert(make_pair(volume, rule)).first;
+	    }
+	  if (policy->Collapse(ruleiter->second, track->GetKineticEnergy() / GeV))
+	    {
+	      // the stored ancestor of a track produced in a collapse volume entered it
+	      if (policy->IsCollapseVolume(ruleiter->second))
+		{
+		  eventAction_->AddEnteringTrack(survivor);
+		}
+	      eventAction_->CollapseTrack(trackid, survivor);
+	      return;
+	    }
+	  parentid = survivor;
+	}
+    }
   G4ParticleDefinition* def = track->GetDefinition();
   int pdgid = def->GetPDGEncoding();
   //   double charge = def->GetPDGCharge();
@@ -41,13 +118,28 @@ PHG4TruthTrackingAction::PreUserTrackingAction( const G4Track* track)
   ti->set_py(pdir[1] / GeV);
   ti->set_pz(pdir[2] / GeV);
   ti->set_track_id( trackid );
-  if (track->GetParentID()) // primary particle -> parent ID = 0
+  if (parentid) // primary particle -> parent ID = 0
     {
-      ti->set_parent_id( track->GetParentID() + trackidoffset );
+      ti->set_parent_id( parentid );
     }
   else
     {
       ti->set_parent_id(0);
+      // in multi threaded running the primary particle knows its position in
+      // the input event, this does not depend on how it was split into G4Events
+      const G4PrimaryParticle *primary = track->GetDynamicParticle()->GetPrimaryParticle();
+      if (primary)
+	{
+	  PHG4UserPrimaryParticleInformation *userdata = dynamic_cast<PHG4UserPrimaryParticleInformation *> (primary->GetUserInformation());
+	  if (userdata && userdata->get_user_track_id() > 0)
+	    {
+	      ti->set_primary_id(userdata->get_user_track_id() + primaryoffset);
+	      if (userdata->get_embed())
+		{
+		  truthInfoList_->AddEmbededTrkId(userdata->get_user_track_id() + primaryoffset);
+		}
+	    }
+	}
     }
   ti->set_pid( pdgid );
   ti->set_name(def->GetParticleName());
@@ -106,3 +198,52 @@ PHG4TruthTrackingAction::ResetEvent(PHCompositeNode *)
   VertexMap.clear();
   return 0;
 }
+
+void
+PHG4TruthTrackingAction::FlushWorkerOutput()
+{
+  if (master_)
+    {
+      master_->merge_worker(this);
+    }
+}
+
+void
+PHG4TruthTrackingAction::merge_worker(PHG4TruthTrackingAction *worker)
+{
+  // the G4Events of one input event share their vertices (by position)
+  map<int, int> vtxids;
+  for (map<G4ThreeVector, int>::const_iterator viter = worker->VertexMap.begin(); viter != worker->VertexMap.end(); ++viter)
+    {
+      map<G4ThreeVector, int>::const_iterator masteriter = VertexMap.find(viter->first);
+      if (masteriter == VertexMap.end())
+	{
+	  int vtxindex = truthInfoList_->maxvtxindex() + 1;
+	  masteriter = VertexMap.insert(make_pair(viter->first, vtxindex)).first;
+	  truthInfoList_->AddVertex(vtxindex, new PHG4VtxPointv1(worker->truthInfoList_->GetVtx(viter->second)));
+	}
+      vtxids[viter->second] = masteriter->second;
+    }
+  // the track ids of the workers do not overlap (subevent_trackid_range)
+  PHG4TruthInfoContainer::ConstRange range = worker->truthInfoList_->GetHitRange();
+  for (PHG4TruthInfoContainer::ConstIterator iter = range.first; iter != range.second; ++iter)
+    {
+      PHG4Particle *particle = new PHG4Particlev2(iter->second);
+      particle->set_track_id(iter->second->get_track_id());
+      particle->set_parent_id(iter->second->get_parent_id());
+      particle->set_primary_id(iter->second->get_primary_id());
+      particle->set_e(iter->second->get_e());
+      particle->set_vtx_id(vtxids[iter->second->get_vtx_id()]);
+      truthInfoList_->AddHit(iter->first, particle);
+    }
+  pair<set<int>::const_iterator, set<int>::const_iterator> embedded = worker->truthInfoList_->GetEmbeddedTrkIds();
+  for (set<int>::const_iterator iter = embedded.first; iter != embedded.second; ++iter)
+    {
+      truthInfoList_->AddEmbededTrkId(*iter);
+    }
+  eventAction_->MergeWorker(*(worker->eventAction_));
+
+  worker->truthInfoList_->Reset();
+  worker->eventAction_->ResetEvent(NULL);
+  worker->VertexMap.clear();
+}
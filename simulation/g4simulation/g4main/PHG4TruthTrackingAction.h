@@ -7,6 +7,7 @@
 
 #include <map>
 
+class G4VPhysicalVolume;
 class PHG4TruthInfoContainer;
 class PHG4TruthEventAction;
 
@@ -17,8 +18,15 @@ public:
   //! constructor
   PHG4TruthTrackingAction( PHG4TruthEventAction* );
 
+  //! constructor of the copy used by a G4 worker thread (multi threaded running)
+  /*!
+    the worker keeps the truth of its G4Events in its own container and
+    event action, FlushWorkerOutput moves them to the master once per G4Event
+  */
+  explicit PHG4TruthTrackingAction( PHG4TruthTrackingAction* master );
+
   //! destructor
-  virtual ~PHG4TruthTrackingAction() {}
+  virtual ~PHG4TruthTrackingAction();
 
   //! tracking action
   virtual void PreUserTrackingAction(const G4Track*);
@@ -28,15 +36,30 @@ public:
   //! Set pointers to the i/o nodes
   virtual void SetInterfacePointers( PHCompositeNode* );
 
+  //! reimplemented from base class, moves the truth of a worker to the node tree
+  virtual void FlushWorkerOutput();
+
   void TrackIdOffset(const int i) {trackidoffset = i;}
+  void PrimaryTrackIdOffset(const int i) {primarytrackidoffset = i;}
+
+  //! range of track ids reserved for each G4Event when an input event is
+  //! split into several G4Events (multi threaded running)
+  static const int subevent_trackid_range = 1 << 24;
 
   int ResetEvent(PHCompositeNode *);
 
 private:
 
+  //! add the truth of a worker to the node tree
+  void merge_worker(PHG4TruthTrackingAction *worker);
+
   std::map<G4ThreeVector,int> VertexMap;
 
+  //! pruning rule of each volume secondaries were produced in
+  std::map<const G4VPhysicalVolume *, int> volumeRule_;
+
   int trackidoffset;
+  int primarytrackidoffset;
 
   //! pointer to the "owning" event action
   PHG4TruthEventAction* eventAction_;
@@ -44,6 +67,9 @@ private:
   //! pointer to truth information container
   PHG4TruthInfoContainer* truthInfoList_;
 
+  //! tracking action of the master (NULL if this is not a worker copy)
+  PHG4TruthTrackingAction* master_;
+
 };
 
 
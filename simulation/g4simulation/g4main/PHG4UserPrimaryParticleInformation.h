@@ -7,15 +7,22 @@
 class PHG4UserPrimaryParticleInformation : public G4VUserPrimaryParticleInformation
 {
 public:
-  PHG4UserPrimaryParticleInformation(const int emb) : embed(emb) {}
-  void Print() const 
+  PHG4UserPrimaryParticleInformation(const int emb, const int usertrkid = 0) : embed(emb), user_track_id(usertrkid) {}
+  void Print() const
   {
     std::cout << "Embedding = " << embed << std::endl;
+    std::cout << "User track id = " << user_track_id << std::endl;
   }
   int get_embed() const {return embed;}
 
+  //! position of this particle in the PHG4InEvent (starting at 1), this is the
+  //! G4 track id the particle gets when the whole input event is run as one G4Event.
+  //! Only set in multi threaded running, 0 otherwise
+  int get_user_track_id() const {return user_track_id;}
+
 private:
   int embed;
+  int user_track_id;
 };
 
 #endif
@@ -0,0 +1,153 @@
+// fills PHG4HitContainer the way the stepping actions do and compares
+// keys, per layer ranges and lookups with a std::map of the same hits
+// (make check)
+
+#include <g4main/PHG4HitContainer.h>
+#include <g4main/PHG4HitDefs.h>
+#include <g4main/PHG4Hitv2.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+
+using namespace std;
+
+static int nfail = 0;
+
+static void
+check(const bool ok, const string &what)
+{
+  if (!ok)
+    {
+      if (nfail < 10)
+	{
+	  cout << what << endl;
+	}
+      nfail++;
+    }
+}
+
+static PHG4HitDefs::keytype
+layerkey(const unsigned int detid, const PHG4HitDefs::keytype hitid)
+{
+  PHG4HitDefs::keytype detidlong = detid;
+  return (detidlong << PHG4HitDefs::hit_idbits) | hitid;
+}
+
+// the container holds exactly the hits of the reference, in key order
+static void
+compare(PHG4HitContainer &hits, const map<PHG4HitDefs::keytype, PHG4Hit *> &reference, const string &when)
+{
+  check(hits.size() == reference.size(), "number of hits differs " + when);
+  PHG4HitContainer::ConstRange range = hits.getHits();
+  map<PHG4HitDefs::keytype, PHG4Hit *>::const_iterator refiter = reference.begin();
+  for (PHG4HitContainer::ConstIterator iter = range.first; iter != range.second && refiter != reference.end(); ++iter, ++refiter)
+    {
+      check(iter->first == refiter->first && iter->second == refiter->second, "hit order differs " + when);
+    }
+  for (unsigned int detid = 0; detid < 8; detid++)
+    {
+      PHG4HitContainer::ConstRange layerrange = hits.getHits(detid);
+      map<PHG4HitDefs::keytype, PHG4Hit *>::const_iterator reflow = reference.lower_bound(layerkey(detid, 0));
+      map<PHG4HitDefs::keytype, PHG4Hit *>::const_iterator refup = reference.lower_bound(layerkey(detid + 1, 0));
+      check(distance(layerrange.first, layerrange.second) == distance(reflow, refup), "hits in layer differ " + when);
+      for (PHG4HitContainer::ConstIterator iter = layerrange.first; iter != layerrange.second && reflow != refup; ++iter, ++reflow)
+	{
+	  check(iter->first == reflow->first, "hit keys in layer differ " + when);
+	}
+    }
+}
+
+int
+main()
+{
+  srand(31415);
+  PHG4HitContainer hits;
+  map<PHG4HitDefs::keytype, PHG4Hit *> reference;
+  for (int ievent = 0; ievent < 3; ievent++)
+    {
+      hits.Reset();
+      reference.clear();
+
+      // hits of the layers come interleaved like tracks crossing a detector,
+      // some are looked up while the array has an unsorted tail
+      for (int i = 0; i < 20000; i++)
+	{
+	  const unsigned int detid = (i % 7 == 3) ? 5 : rand() % 4;
+	  PHG4Hit *hit = new PHG4Hitv2();
+	  hit->set_edep((rand() % 5) ? 0.1 : 0);
+	  PHG4HitContainer::ConstIterator iter = hits.AddHit(detid, hit);
+	  check(iter->second == hit && iter->first == hit->get_hit_id(), "AddHit returns the wrong hit");
+	  check(reference.find(hit->get_hit_id()) == reference.end(), "AddHit gives out a used key");
+	  check((hit->get_hit_id() >> PHG4HitDefs::hit_idbits) == detid, "key of hit is not in its layer");
+	  reference[hit->get_hit_id()] = hit;
+
+	  if (i % 13 == 0)
+	    {
+	      map<PHG4HitDefs::keytype, PHG4Hit *>::const_iterator refiter = reference.begin();
+	      advance(refiter, rand() % reference.size());
+	      check(hits.findHit(refiter->first) == refiter->second, "findHit does not find a hit");
+	      check(hits.findHit(layerkey(6, i + 1)) == NULL, "findHit finds a hit which was never added");
+	    }
+	  if (i % 101 == 0)
+	    {
+	      // calorimeters look up their towers in every step
+	      PHG4HitDefs::keytype key = layerkey(7, rand() % 50);
+	      PHG4HitContainer::Iterator fiter = hits.findOrAddHit(key);
+	      check(fiter->first == key, "findOrAddHit returns the wrong hit");
+	      if (reference.find(key) == reference.end())
+		{
+		  fiter->second->set_edep(0.2);
+		  reference[key] = fiter->second;
+		}
+	      else
+		{
+		  check(reference[key] == fiter->second, "findOrAddHit adds an existing hit");
+		}
+	    }
+	}
+      compare(hits, reference, "after filling");
+
+      // remove the hits without energy, new ids have to stay unique
+      for (map<PHG4HitDefs::keytype, PHG4Hit *>::iterator iter = reference.begin(); iter != reference.end();)
+	{
+	  if (iter->second->get_edep() == 0)
+	    {
+	      reference.erase(iter++);
+	    }
+	  else
+	    {
+	      ++iter;
+	    }
+	}
+      hits.RemoveZeroEDep();
+      for (int i = 0; i < 1000; i++)
+	{
+	  PHG4Hit *hit = new PHG4Hitv2();
+	  hit->set_edep(0.3);
+	  hits.AddHit(rand() % 4, hit);
+	  check(reference.find(hit->get_hit_id()) == reference.end(), "AddHit after RemoveZeroEDep gives out a used key");
+	  reference[hit->get_hit_id()] = hit;
+	}
+      compare(hits, reference, "after RemoveZeroEDep");
+
+      // hits which come with their key (copies of hits read back)
+      PHG4Hit *hit = new PHG4Hitv2();
+      hit->set_hit_id(reference.begin()->first);
+      hits.AddHit(hit);
+      check(hits.size() == reference.size(), "AddHit adds a hit with an existing key");
+      delete hit;
+    }
+  const unsigned int nhits = hits.size();
+  hits.Reset();
+
+  if (nfail)
+    {
+      cout << "testPHG4HitContainer: " << nfail << " failures" << endl;
+      return 1;
+    }
+  cout << "testPHG4HitContainer: " << nhits << " hits stored and found as in a std::map" << endl;
+  return 0;
+}
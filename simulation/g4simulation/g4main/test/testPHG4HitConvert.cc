@@ -0,0 +1,196 @@
+// converts PHG4Hitv1 hits with PHG4HitConvert and checks that the
+// PHG4Hitv2 hits report the same values, and that PHG4Hitv2 keeps the
+// ladder z index apart from the ladder phi index (make check)
+
+#include <g4main/PHG4HitContainer.h>
+#include <g4main/PHG4HitConvert.h>
+#include <g4main/PHG4Hitv1.h>
+#include <g4main/PHG4Hitv2.h>
+
+#include <phool/PHCompositeNode.h>
+#include <phool/PHIODataNode.h>
+#include <phool/PHObject.h>
+
+#include <climits>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace std;
+
+static int nfail = 0;
+
+static void
+check(const bool ok, const PHG4HitDefs::keytype key, const string &what)
+{
+  if (!ok)
+    {
+      cout << "hit " << key << ": " << what << " differs" << endl;
+      nfail++;
+    }
+}
+
+// NAN compares unequal to itself
+static bool
+same(const float a, const float b)
+{
+  return (a == b) || (std::isnan(a) && std::isnan(b));
+}
+
+static void
+compare(const PHG4HitDefs::keytype key, const PHG4Hit &v1, const PHG4Hit &v2)
+{
+  for (int i = 0; i < 2; i++)
+    {
+      check(same(v1.get_x(i), v2.get_x(i)), key, "x");
+      check(same(v1.get_y(i), v2.get_y(i)), key, "y");
+      check(same(v1.get_z(i), v2.get_z(i)), key, "z");
+      check(same(v1.get_t(i), v2.get_t(i)), key, "t");
+      check(same(v1.get_px(i), v2.get_px(i)), key, "px");
+      check(same(v1.get_py(i), v2.get_py(i)), key, "py");
+      check(same(v1.get_pz(i), v2.get_pz(i)), key, "pz");
+    }
+  check(v1.get_hit_id() == v2.get_hit_id(), key, "hit id");
+  check(v1.get_trkid() == v2.get_trkid(), key, "track id");
+  check(same(v1.get_edep(), v2.get_edep()), key, "edep");
+  check(same(v1.get_eion(), v2.get_eion()), key, "eion");
+  check(same(v1.get_light_yield(), v2.get_light_yield()), key, "light yield");
+  check(same(v1.get_path_length(), v2.get_path_length()), key, "path length");
+  check(v1.get_layer() == v2.get_layer(), key, "layer");
+  check(v1.get_scint_id() == v2.get_scint_id(), key, "scint id");
+  check(v1.get_strip_z_index() == v2.get_strip_z_index(), key, "strip z index");
+  check(v1.get_strip_y_index() == v2.get_strip_y_index(), key, "strip y index");
+  check(v1.get_ladder_z_index() == v2.get_ladder_z_index(), key, "ladder z index");
+  check(v1.get_ladder_phi_index() == v2.get_ladder_phi_index(), key, "ladder phi index");
+  check(v1.get_index_i() == v2.get_index_i(), key, "index i");
+  check(v1.get_index_j() == v2.get_index_j(), key, "index j");
+  check(v1.get_index_k() == v2.get_index_k(), key, "index k");
+  check(v1.get_index_l() == v2.get_index_l(), key, "index l");
+}
+
+int
+main()
+{
+  PHCompositeNode *topNode = new PHCompositeNode("TOP");
+  PHG4HitContainer *hits = new PHG4HitContainer();
+  topNode->addNode(new PHIODataNode<PHObject>(hits, "G4HIT_TEST", "PHObject"));
+
+  // hits with different sets of properties, as filled by the stepping actions
+  for (int i = 0; i < 100; i++)
+    {
+      PHG4Hit *hit = new PHG4Hitv1();
+      for (int j = 0; j < 2; j++)
+	{
+	  hit->set_x(j, i + 0.1 * j);
+	  hit->set_y(j, -i - 0.2 * j);
+	  hit->set_z(j, 0.5 * i + j);
+	  hit->set_t(j, 1.5 * i + j);
+	}
+      hit->set_trkid(i - 50);
+      hit->set_edep(0.01 * i);
+      hit->set_layer(i % 4);
+      switch (i % 4)
+	{
+	case 0: // calorimeter
+	  hit->set_scint_id(i * 7);
+	  hit->set_light_yield(0.005 * i);
+	  hit->set_eion(0.001 * i);
+	  break;
+	case 1: // silicon tracker
+	  hit->set_strip_z_index(i);
+	  hit->set_strip_y_index(-i);
+	  hit->set_ladder_z_index(i / 3);
+	  hit->set_ladder_phi_index(i / 5);
+	  break;
+	case 2: // momentum and path length
+	  for (int j = 0; j < 2; j++)
+	    {
+	      hit->set_px(j, 0.3 * i);
+	      hit->set_py(j, -0.3 * i);
+	      hit->set_pz(j, 1. + i);
+	    }
+	  hit->set_path_length(0.7 * i);
+	  break;
+	default: // generic indices
+	  hit->set_index_i(i);
+	  hit->set_index_j(i + 1);
+	  hit->set_index_k(i + 2);
+	  hit->set_index_l(i + 3);
+	  break;
+	}
+      hits->AddHit(i % 4, hit);
+    }
+
+  // keep copies of the original hits for the comparison
+  map<PHG4HitDefs::keytype, PHG4Hitv1 *> originals;
+  PHG4HitContainer::ConstRange range = hits->getHits();
+  for (PHG4HitContainer::ConstIterator iter = range.first; iter != range.second; ++iter)
+    {
+      originals[iter->first] = new PHG4Hitv1(*(iter->second));
+    }
+
+  PHG4HitConvert convert;
+  convert.AddNode("G4HIT_TEST");
+  convert.SetBenchmark();
+  convert.Init(topNode);
+  convert.process_event(topNode);
+  convert.End(topNode);
+
+  range = hits->getHits();
+  if (hits->size() != originals.size())
+    {
+      cout << "number of hits changed from " << originals.size() << " to " << hits->size() << endl;
+      nfail++;
+    }
+  for (PHG4HitContainer::ConstIterator iter = range.first; iter != range.second; ++iter)
+    {
+      if (!dynamic_cast<PHG4Hitv2 *>(iter->second))
+	{
+	  cout << "hit " << iter->first << " was not converted" << endl;
+	  nfail++;
+	  continue;
+	}
+      map<PHG4HitDefs::keytype, PHG4Hitv1 *>::const_iterator orig = originals.find(iter->first);
+      if (orig == originals.end())
+	{
+	  cout << "hit " << iter->first << " is new" << endl;
+	  nfail++;
+	  continue;
+	}
+      compare(iter->first, *(orig->second), *(iter->second));
+    }
+
+  for (map<PHG4HitDefs::keytype, PHG4Hitv1 *>::iterator iter = originals.begin(); iter != originals.end(); ++iter)
+    {
+      delete iter->second;
+    }
+  delete topNode;
+
+  // new silicon tracker hits: PHG4Hitv2 stores ladder z and phi separately,
+  // PHG4Hitv1 overwrites one with the other
+  PHG4Hitv2 silicon;
+  silicon.set_ladder_z_index(3);
+  silicon.set_ladder_phi_index(17);
+  check(silicon.get_ladder_z_index() == 3, 0, "PHG4Hitv2 ladder z index");
+  check(silicon.get_ladder_phi_index() == 17, 0, "PHG4Hitv2 ladder phi index");
+  PHG4Hitv2 siliconcopy(silicon);
+  check(siliconcopy.get_ladder_z_index() == 3 && siliconcopy.get_ladder_phi_index() == 17, 0, "copied PHG4Hitv2 ladder index");
+  PHG4Hitv2 siliconv2copy(static_cast<const PHG4Hit &>(silicon));
+  check(siliconv2copy.get_ladder_z_index() == 3 && siliconv2copy.get_ladder_phi_index() == 17, 0, "PHG4Hitv2 from PHG4Hitv2 ladder index");
+  PHG4Hitv1 oldsilicon;
+  oldsilicon.set_ladder_z_index(3);
+  oldsilicon.set_ladder_phi_index(17);
+  check(oldsilicon.get_ladder_z_index() == 17, 0, "PHG4Hitv1 ladder z index (old DSTs)");
+  // hits of old DSTs keep the ladder z index they were reconstructed with
+  PHG4Hitv2 converted(oldsilicon);
+  check(converted.get_ladder_z_index() == 17 && converted.get_ladder_phi_index() == 17, 0, "PHG4Hitv2 from PHG4Hitv1 ladder index");
+
+  if (nfail)
+    {
+      cout << "testPHG4HitConvert: " << nfail << " failures" << endl;
+      return 1;
+    }
+  cout << "testPHG4HitConvert: all hits converted correctly" << endl;
+  return 0;
+}
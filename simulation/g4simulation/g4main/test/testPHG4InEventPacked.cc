@@ -0,0 +1,176 @@
+// packs a generator record with PHG4InEventPacked, checks that Unpack()
+// gives it back within the precisions and that broken buffers are
+// rejected (make check)
+
+#include <g4main/PHG4InEvent.h>
+#include <g4main/PHG4InEventPacked.h>
+#include <g4main/PHG4Particlev1.h>
+#include <g4main/PHG4VtxPoint.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const float pos_prec = 1e-4;
+static const float time_prec = 1e-3;
+static const float mom_prec = 1e-5;
+
+static int nfail = 0;
+
+static void
+check(const bool ok, const string &what)
+{
+  if (!ok)
+    {
+      cout << what << endl;
+      nfail++;
+    }
+}
+
+static bool
+close(const double a, const double b, const double prec)
+{
+  if (std::isnan(a) || std::isnan(b))
+    {
+      return std::isnan(a) && std::isnan(b);
+    }
+  return fabs(a - b) <= 0.5001 * prec;
+}
+
+// gives access to the packed bytes to break them
+class PHG4InEventPackedCorrupt: public PHG4InEventPacked
+{
+ public:
+  void truncate() {nbytes /= 2;}
+  void set_nparticles(const unsigned int n) {nparticles = n;}
+  void flip(const unsigned int ibyte, const unsigned char mask) {buffer[ibyte % nbytes] ^= mask;}
+};
+
+static void
+fill(PHG4InEvent &inEvent, const int nvtx)
+{
+  static const int pids[] = {211, -211, 321, 2212, 22, 11, -11, 130};
+  for (int ivtx = 0; ivtx < nvtx; ivtx++)
+    {
+      // HepMC numbering, not continuous
+      const int vtxid = 3 * ivtx - 10;
+      inEvent.AddVtxHepMC(vtxid, 0.01 * ivtx - 0.3, 0.02 * ivtx, 5. - 0.5 * ivtx, (ivtx % 3) ? 0.1 * ivtx : NAN);
+      for (int ipart = 0; ipart < 1 + ivtx % 7; ipart++)
+	{
+	  PHG4Particle *particle = new PHG4Particlev1();
+	  particle->set_pid(pids[(ivtx * 7 + ipart * 3) % 8]);
+	  particle->set_px((rand() % 20001 - 10000) * 1e-3);
+	  particle->set_py((rand() % 20001 - 10000) * 1e-3);
+	  particle->set_pz((rand() % 200001 - 100000) * 1e-3);
+	  inEvent.AddParticle(vtxid, particle);
+	  if (ipart == 0 && ivtx % 5 == 0)
+	    {
+	      inEvent.AddEmbeddedParticle(particle);
+	    }
+	}
+    }
+}
+
+static void
+compare(const PHG4InEvent &orig, const PHG4InEvent &unpacked)
+{
+  pair<map<int, PHG4VtxPoint *>::const_iterator, map<int, PHG4VtxPoint *>::const_iterator> ovtx = orig.GetVertices();
+  pair<map<int, PHG4VtxPoint *>::const_iterator, map<int, PHG4VtxPoint *>::const_iterator> uvtx = unpacked.GetVertices();
+  check(distance(ovtx.first, ovtx.second) == distance(uvtx.first, uvtx.second), "number of vertices differs");
+  map<int, PHG4VtxPoint *>::const_iterator uiter = uvtx.first;
+  for (map<int, PHG4VtxPoint *>::const_iterator oiter = ovtx.first; oiter != ovtx.second && uiter != uvtx.second; ++oiter, ++uiter)
+    {
+      check(oiter->first == uiter->first, "vertex id differs");
+      check(close(oiter->second->get_x(), uiter->second->get_x(), pos_prec), "vertex x differs");
+      check(close(oiter->second->get_y(), uiter->second->get_y(), pos_prec), "vertex y differs");
+      check(close(oiter->second->get_z(), uiter->second->get_z(), pos_prec), "vertex z differs");
+      check(close(oiter->second->get_t(), uiter->second->get_t(), time_prec), "vertex t differs");
+
+      // particles of a vertex keep their order
+      pair<multimap<int, PHG4Particle *>::const_iterator, multimap<int, PHG4Particle *>::const_iterator> opart = orig.GetParticles(oiter->first);
+      pair<multimap<int, PHG4Particle *>::const_iterator, multimap<int, PHG4Particle *>::const_iterator> upart = unpacked.GetParticles(uiter->first);
+      check(distance(opart.first, opart.second) == distance(upart.first, upart.second), "number of particles differs");
+      multimap<int, PHG4Particle *>::const_iterator upiter = upart.first;
+      for (multimap<int, PHG4Particle *>::const_iterator opiter = opart.first; opiter != opart.second && upiter != upart.second; ++opiter, ++upiter)
+	{
+	  check(opiter->second->get_pid() == upiter->second->get_pid(), "pid differs");
+	  check(close(opiter->second->get_px(), upiter->second->get_px(), mom_prec), "px differs");
+	  check(close(opiter->second->get_py(), upiter->second->get_py(), mom_prec), "py differs");
+	  check(close(opiter->second->get_pz(), upiter->second->get_pz(), mom_prec), "pz differs");
+	  check(orig.isEmbeded(opiter->second) == unpacked.isEmbeded(upiter->second), "embedding flag differs");
+	}
+    }
+}
+
+int
+main()
+{
+  srand(12345);
+
+  // round trip
+  PHG4InEvent orig;
+  fill(orig, 200);
+  PHG4InEventPacked packed;
+  check(packed.Pack(orig, pos_prec, time_prec, mom_prec) == 0, "Pack failed");
+  PHG4InEvent unpacked;
+  check(packed.Unpack(unpacked) == 0, "Unpack failed");
+  compare(orig, unpacked);
+
+  // many identical numbers give the densest buffer, check the limit Unpack
+  // puts on the dictionary size
+  PHG4InEvent dense;
+  dense.AddVtxHepMC(1, 0, 0, 0, 0);
+  for (int ipart = 0; ipart < 100000; ipart++)
+    {
+      PHG4Particle *particle = new PHG4Particlev1();
+      particle->set_pid(22);
+      particle->set_px(0);
+      particle->set_py(0);
+      particle->set_pz(0);
+      dense.AddParticle(1, particle);
+    }
+  check(packed.Pack(dense, pos_prec, time_prec, mom_prec) == 0, "Pack of dense event failed");
+  check(5. * packed.get_nparticles() < 64. * packed.get_nbytes(), "more than 64 numbers per byte");
+  unpacked.Reset();
+  check(packed.Unpack(unpacked) == 0, "Unpack of dense event failed");
+  compare(dense, unpacked);
+
+  // broken buffers must be rejected
+  PHG4InEventPackedCorrupt corrupt;
+  corrupt.Pack(orig, pos_prec, time_prec, mom_prec);
+  corrupt.truncate();
+  unpacked.Reset();
+  check(corrupt.Unpack(unpacked) != 0, "truncated buffer not detected");
+
+  corrupt.Pack(orig, pos_prec, time_prec, mom_prec);
+  corrupt.set_nparticles(0);
+  unpacked.Reset();
+  check(corrupt.Unpack(unpacked) != 0, "dictionary larger than the number of particles not detected");
+
+  // flipped bits can give a valid looking record, they must not crash
+  int nrejected = 0;
+  for (int i = 0; i < 200; i++)
+    {
+      corrupt.Pack(orig, pos_prec, time_prec, mom_prec);
+      corrupt.flip(rand(), 1 << (rand() % 8));
+      unpacked.Reset();
+      if (corrupt.Unpack(unpacked))
+	{
+	  nrejected++;
+	}
+    }
+  cout << "testPHG4InEventPacked: " << nrejected << " of 200 buffers with a flipped bit rejected" << endl;
+
+  if (nfail)
+    {
+      cout << "testPHG4InEventPacked: " << nfail << " failures" << endl;
+      return 1;
+    }
+  cout << "testPHG4InEventPacked: generator record unpacked correctly" << endl;
+  return 0;
+}